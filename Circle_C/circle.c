@@ -2,28 +2,55 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
+#include <inttypes.h>
+#include "../common/app_profile.h"
+#include "helpers/circle_particles.h"
+#include "helpers/circle_raster.h"
+#include "../common/app_backbuffer.h"
+#include "../common/app_snapshot.h"
+#include "../common/app_runtime.h"
+#include "../common/app_arena.h"
+#include "../common/app_crc32.h"
 
 typedef struct {
     uint8_t x;
     uint8_t y;
 } Point;
 
+typedef enum {
+    CircleDirtyPosition = 1 << 0,
+    CircleDirtyRadius = 1 << 1,
+    CircleDirtyMode = 1 << 2,
+    CircleDirtyParticles = 1 << 3,
+} CircleDirty;
+
 typedef struct {
     Point loc;
     uint8_t move_x;
     uint8_t change_r;
+    AppInputCurve move; //held left and right keys move faster, starting with move_x
+    AppInputCurve resize; //held up and down keys resize faster, starting with change_r
     int r; //radius of the circle
+    uint8_t dirty; //CircleDirty flags of the changes since the last frame
+    char status[35]; //menu bar text, only formatted when position or radius change
+    uint8_t mode; //index into circle_modes
+    CircleParticles* particles;
+    AppRuntime* runtime;
 } Circle;
 
-typedef enum {
-    EventTypeTick,
-    EventTypeKey,
-} EventType;
-
+/**
+ * Everything the draw callback needs, handed over from the loop through a snapshot. Each slot has room for all
+ * bouncing circles, but only the ones shown are copied into it.
+ */
 typedef struct {
-    EventType type;
-    InputEvent input;
-} CircleEvent;
+    Point loc;
+    uint8_t r;
+    uint8_t mode;
+    char status[35];
+    uint16_t count; //bouncing circles in particles
+    uint16_t particles[]; //packed with CIRCLE_PARTICLES_PACK
+} CircleFrame;
+#define CIRCLE_FRAME_SIZE (sizeof(CircleFrame) + CIRCLE_PARTICLES_CAPACITY * sizeof(uint16_t))
 
 // Screen is 128x64 px
 const int MAX_X = 128;
@@ -31,31 +58,252 @@ const int MAX_Y = 64;
 const int BORDER = 2;
 const int MENU_BEGIN_Y = MAX_Y - 10;
 
+typedef struct {
+    uint16_t particles; //number of bouncing circles, 0 shows the single circle
+    bool filled; //the single circle is drawn filled
+} CircleMode;
+
+//modes switched with OK, the last one has the most circles
+static const CircleMode circle_modes[] = {
+    {.particles = 0},
+    {.particles = 0, .filled = true},
+    {.particles = 10},
+    {.particles = 100},
+    {.particles = CIRCLE_PARTICLES_CAPACITY},
+};
+#define PARTICLE_FPS 30
+
+//everything the app allocates, used with cdefines=["APP_STATIC"]
+APP_ARENA_DEFINE(APP_ARENA_SIZE(
+    sizeof(Circle) + sizeof(AppRuntime) + APP_SNAPSHOT_BYTES(CIRCLE_FRAME_SIZE) +
+        CIRCLE_PARTICLES_BYTES(CIRCLE_PARTICLES_CAPACITY),
+    2 + APP_SNAPSHOT_ALLOCATIONS + CIRCLE_PARTICLES_ALLOCATIONS));
+
+//recording or replay, used with cdefines=["APP_TRACE"]
+APP_TRACE_DEFINE();
+
+//frame is drawn off screen and copied to the canvas in one go, too large for the stack
+static AppBackBuffer backbuffer;
+
+/**
+ * Draws menu bar and circles into the back buffer
+ *
+ * @param frame state to draw
+ * @param buffer back buffer to draw to
+ */
+static void circle_draw_scene(const CircleFrame* const frame, AppBackBuffer* buffer) {
+    //draw menu bar
+    app_backbuffer_frame(buffer, 0, MENU_BEGIN_Y, MAX_X, MAX_Y, AppBackBufferSet);
+
+    const CircleMode* mode = &circle_modes[frame->mode];
+    if(mode->particles) {
+        circle_particles_draw(frame->particles, frame->count, buffer, MAX_X, MENU_BEGIN_Y);
+    } else if(mode->filled) {
+        circle_raster_fill(buffer, frame->loc.x, frame->loc.y, frame->r, MAX_X, MENU_BEGIN_Y);
+    } else {
+        //draw the circle
+        app_backbuffer_dot(buffer, frame->loc.x, frame->loc.y, AppBackBufferSet);
+        circle_raster_draw(buffer, frame->loc.x, frame->loc.y, frame->r, MAX_X, MENU_BEGIN_Y);
+    }
+}
+
+#ifdef APP_PROFILE
+static AppProfile profile;
+//set when the overlay is switched on, the next frame compares the drawing paths
+static volatile bool raster_benchmark = false;
+
+/**
+ * Draws the outline and the filled circle of every radius with the tables and the midpoint algorithm into the back
+ * buffer and with the canvas, then draws the current frame once through the back buffer and once pixel by pixel,
+ * logging the cycles each took
+ *
+ * @param canvas canvas to draw to
+ * @param frame state to draw
+ */
+static void circle_raster_benchmark(Canvas* const canvas, const CircleFrame* const frame) {
+    uint32_t total_table = 0;
+    uint32_t total_midpoint = 0;
+    uint32_t total_canvas = 0;
+    uint32_t total_fill_table = 0;
+    uint32_t total_fill_midpoint = 0;
+    uint32_t total_fill_canvas = 0;
+    for(uint8_t r = 0; r <= MENU_BEGIN_Y / 2; r++) {
+        uint32_t start = app_profile_cycles();
+        circle_raster_draw(&backbuffer, MAX_X / 2, MENU_BEGIN_Y / 2, r, MAX_X, MENU_BEGIN_Y);
+        const uint32_t table = app_profile_cycles() - start;
+
+        start = app_profile_cycles();
+        circle_raster_draw_midpoint(&backbuffer, MAX_X / 2, MENU_BEGIN_Y / 2, r, MAX_X, MENU_BEGIN_Y);
+        const uint32_t midpoint = app_profile_cycles() - start;
+
+        start = app_profile_cycles();
+        canvas_draw_circle(canvas, MAX_X / 2, MENU_BEGIN_Y / 2, r);
+        const uint32_t generic = app_profile_cycles() - start;
+
+        FURI_LOG_I("Circle", "r=%u: table %" PRIu32 ", midpoint %" PRIu32 ", canvas %" PRIu32 " cycles", r, table, midpoint, generic);
+        total_table += table;
+        total_midpoint += midpoint;
+        total_canvas += generic;
+
+        start = app_profile_cycles();
+        circle_raster_fill(&backbuffer, MAX_X / 2, MENU_BEGIN_Y / 2, r, MAX_X, MENU_BEGIN_Y);
+        const uint32_t fill_table = app_profile_cycles() - start;
+
+        start = app_profile_cycles();
+        circle_raster_fill_midpoint(&backbuffer, MAX_X / 2, MENU_BEGIN_Y / 2, r, MAX_X, MENU_BEGIN_Y);
+        const uint32_t fill_midpoint = app_profile_cycles() - start;
+
+        start = app_profile_cycles();
+        canvas_draw_disc(canvas, MAX_X / 2, MENU_BEGIN_Y / 2, r);
+        const uint32_t fill_canvas = app_profile_cycles() - start;
+
+        FURI_LOG_I(
+            "Circle",
+            "r=%u filled: table %" PRIu32 ", midpoint %" PRIu32 ", canvas %" PRIu32 " cycles",
+            r,
+            fill_table,
+            fill_midpoint,
+            fill_canvas);
+        total_fill_table += fill_table;
+        total_fill_midpoint += fill_midpoint;
+        total_fill_canvas += fill_canvas;
+    }
+    FURI_LOG_I(
+        "Circle",
+        "all radii: table %" PRIu32 ", midpoint %" PRIu32 ", canvas %" PRIu32 " cycles",
+        total_table,
+        total_midpoint,
+        total_canvas);
+    FURI_LOG_I(
+        "Circle",
+        "all radii filled: table %" PRIu32 ", midpoint %" PRIu32 ", canvas %" PRIu32 " cycles",
+        total_fill_table,
+        total_fill_midpoint,
+        total_fill_canvas);
+
+    uint32_t start = app_profile_cycles();
+    app_backbuffer_clear(&backbuffer);
+    circle_draw_scene(frame, &backbuffer);
+    app_backbuffer_blit(&backbuffer, canvas);
+    const uint32_t buffered = app_profile_cycles() - start;
+
+    start = app_profile_cycles();
+    canvas_draw_frame(canvas, 0, MENU_BEGIN_Y, MAX_X, MAX_Y);
+    if(circle_modes[frame->mode].particles) {
+        for(uint16_t i = 0; i < frame->count; i++) {
+            const uint16_t packed = frame->particles[i];
+            canvas_draw_circle(
+                canvas, CIRCLE_PARTICLES_X(packed), CIRCLE_PARTICLES_Y(packed), CIRCLE_PARTICLES_R(packed));
+        }
+    } else if(circle_modes[frame->mode].filled) {
+        canvas_draw_disc(canvas, frame->loc.x, frame->loc.y, frame->r);
+    } else {
+        canvas_draw_dot(canvas, frame->loc.x, frame->loc.y);
+        canvas_draw_circle(canvas, frame->loc.x, frame->loc.y, frame->r);
+    }
+    const uint32_t per_pixel = app_profile_cycles() - start;
+
+    FURI_LOG_I("Circle", "frame: back buffer %" PRIu32 ", per pixel %" PRIu32 " cycles", buffered, per_pixel);
+}
+#endif
+
 //draw a random dot
 //draw stuff to the screen
 void draw_callback(Canvas* const canvas, void* ctx) {
-    const Circle* circle = acquire_mutex((ValueMutex*)ctx, 25);
-    if(circle == NULL) {
-        return;
+    APP_PROFILE_START(draw_start);
+    APP_PROFILE_STACK(profile.stack_draw);
+    APP_PROFILE_FRAME(&profile);
+    //never waits for the loop, if nothing new was published the last frame is drawn again
+    const CircleFrame* frame = app_snapshot_acquire((AppSnapshot*)ctx, furi_ms_to_ticks(1000 / PARTICLE_FPS));
+
+#ifdef APP_PROFILE
+    if(raster_benchmark) {
+        raster_benchmark = false;
+        circle_raster_benchmark(canvas, frame);
+        canvas_clear(canvas);
     }
-    //draw menu bar
-    canvas_draw_frame(canvas, 0, MENU_BEGIN_Y, MAX_X, MAX_Y);
-    char str[35];
-    snprintf(str,sizeof str, "Rad: %d, Pos x: %d, Pos y: %d", circle->r, circle->loc.x, circle->loc.y);
-    canvas_draw_str(canvas, 2,MAX_Y,str);
+#endif
 
-    //draw the circle
-    canvas_draw_dot(canvas, circle->loc.x,circle->loc.y);
-    canvas_draw_circle(canvas, circle->loc.x, circle->loc.y, circle->r);
+    app_backbuffer_clear(&backbuffer);
+    circle_draw_scene(frame, &backbuffer);
+    app_backbuffer_blit(&backbuffer, canvas);
+    canvas_draw_str(canvas, 2,MAX_Y,frame->status);
 
-    release_mutex((ValueMutex*)ctx, circle);
+#ifdef APP_PROFILE
+    if(profile.overlay) app_profile_overlay(canvas, &profile);
+#endif
+    APP_PROFILE_STOP(&profile.draw, draw_start);
 }
 
-void input_callback(InputEvent* input_event, FuriMessageQueue* event_queue) {
-    furi_assert(event_queue);
+#ifdef APP_PROFILE
+/**
+ * Writes the simulation throughput of the current mode to the log and starts a new measurement
+ *
+ * @param count number of circles that were simulated
+ */
+static void circle_log_particles(uint16_t count) {
+    AppProfileHistogram* update = &profile.update;
+    if(count && update->count) {
+        const uint32_t tick_us =
+            update->total / update->count / furi_hal_cortex_instructions_per_microsecond();
+        const uint32_t frame_us = 1000000 / PARTICLE_FPS;
+        FURI_LOG_I(
+            "Circle",
+            "%u circles: %" PRIu32 "us per tick, %" PRIu32 " circles/ms, %" PRIu32 "us of the %" PRIu32 "us frame left",
+            count,
+            tick_us,
+            tick_us ? (uint32_t)(count * 1000UL / tick_us) : 0,
+            tick_us < frame_us ? frame_us - tick_us : 0,
+            frame_us);
+    }
+    memset(update, 0, sizeof(AppProfileHistogram));
+}
+#endif
 
-    CircleEvent event = {.type = EventTypeKey, .input = *input_event};
-    furi_message_queue_put(event_queue, &event, FuriWaitForever);
+/**
+ * Formats the menu bar text again if position, radius or mode changed and clears the changes
+ *
+ * @param circle circle to update
+ *
+ * @return true if the circle changed and a new frame is needed
+ */
+static bool circle_update_status(Circle* const circle) {
+    if(!circle->dirty) return false;
+    //moving circles alone do not change the text
+    if(!(circle->dirty & (CircleDirtyPosition | CircleDirtyRadius | CircleDirtyMode))) {
+        circle->dirty = 0;
+        return true;
+    }
+    if(circle_modes[circle->mode].particles) {
+        snprintf(circle->status, sizeof(circle->status), "Circles: %u", circle->particles->count);
+    } else {
+        snprintf(
+            circle->status,
+            sizeof(circle->status),
+            "Rad: %d, Pos x: %d, Pos y: %d",
+            circle->r,
+            circle->loc.x,
+            circle->loc.y);
+    }
+    APP_PROFILE_COUNT(profile.formats);
+    circle->dirty = 0;
+    return true;
+}
+
+/**
+ * Copies the render state into the back slot of the snapshot and publishes it
+ *
+ * @param circle current state
+ * @param snapshot snapshot of CircleFrame to publish to
+ */
+static void circle_publish(const Circle* const circle, AppSnapshot* snapshot) {
+    CircleFrame* frame = app_snapshot_back(snapshot);
+    frame->loc = circle->loc;
+    frame->r = circle->r;
+    frame->mode = circle->mode;
+    memcpy(frame->status, circle->status, sizeof(frame->status));
+    frame->count = circle_particles_snapshot(circle->particles, frame->particles);
+    app_snapshot_publish(snapshot);
 }
 
 static void circle_init(Circle* const circle) {
@@ -64,76 +312,247 @@ static void circle_init(Circle* const circle) {
     circle->loc.y = MENU_BEGIN_Y/2;
     circle->move_x = 2;
     circle->change_r = 1;
+    //a held key moves 2, 4, 8, 16 and then 32 px per repeat, about 60 px until the third repeat
+    circle->move = (AppInputCurve){.start = circle->move_x, .limit = 32, .doubling = 1};
+    circle->resize = (AppInputCurve){.start = circle->change_r, .limit = 4, .doubling = 2};
+    circle->mode = 0;
+    circle->dirty = CircleDirtyPosition | CircleDirtyRadius;
+    circle_update_status(circle);
+}
+
+/**
+ * Moves the circle horizontally, it stops at the border of the screen
+ *
+ * @param circle current state
+ * @param delta pixels to move, negative to move left
+ */
+static void circle_move(Circle* const circle, int delta) {
+    const int x = MAX(MIN(circle->loc.x + delta, MAX_X - 1 - circle->r), circle->r);
+    //a circle that grew over the border is not pushed back by moving towards it
+    if((delta > 0 && x > circle->loc.x) || (delta < 0 && x < circle->loc.x)) {
+        circle->loc.x = x;
+        circle->dirty |= CircleDirtyPosition;
+    }
+}
+
+/**
+ * Changes the radius of the circle, it stays between 0 and half the height of the play area
+ *
+ * @param circle current state
+ * @param delta pixels to add to the radius, negative to shrink it
+ */
+static void circle_resize(Circle* const circle, int delta) {
+    const int r = MAX(MIN(circle->r + delta, MENU_BEGIN_Y / 2), 0);
+    if(r != circle->r) {
+        circle->r = r;
+        circle->dirty |= CircleDirtyRadius;
+    }
+}
+
+/**
+ * Resizes the circle on a press of up or down and keeps resizing while the key is held
+ *
+ * @param ctx circle
+ * @param input up to shrink, down to grow
+ */
+static void circle_key_resize(void* ctx, const InputEvent* input) {
+    Circle* circle = ctx;
+    const int delta = app_input_take(&circle->runtime->input, &circle->resize, input);
+    circle_resize(circle, input->key == InputKeyUp ? -delta : delta);
+}
+
+/**
+ * Moves the circle on a press of left or right and keeps moving it while the key is held
+ *
+ * @param ctx circle
+ * @param input key that moves the circle
+ */
+static void circle_key_move(void* ctx, const InputEvent* input) {
+    Circle* circle = ctx;
+    const int delta = app_input_take(&circle->runtime->input, &circle->move, input);
+    circle_move(circle, input->key == InputKeyLeft ? -delta : delta);
+}
+
+/**
+ * Switches to the next mode, the timer only runs while bouncing circles are shown
+ *
+ * @param ctx circle
+ * @param input unused
+ */
+static void circle_key_mode(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    Circle* circle = ctx;
+#ifdef APP_PROFILE
+    circle_log_particles(circle->particles->count);
+#endif
+    circle->mode = (circle->mode + 1) % COUNT_OF(circle_modes);
+    circle_particles_spawn(circle->particles, circle_modes[circle->mode].particles);
+    circle->dirty |= CircleDirtyMode;
+    if(circle_modes[circle->mode].particles) {
+        furi_timer_start(circle->runtime->timer, furi_ms_to_ticks(1000 / PARTICLE_FPS));
+    } else {
+        furi_timer_stop(circle->runtime->timer);
+    }
+}
+
+/**
+ * Closes the app
+ *
+ * @param ctx circle
+ * @param input unused
+ */
+static void circle_key_exit(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    Circle* circle = ctx;
+    app_runtime_exit(circle->runtime);
+}
+
+#ifdef APP_PROFILE
+/**
+ * Shows or hides the profiling overlay, showing it also compares the drawing paths on the next frame
+ *
+ * @param ctx circle
+ * @param input unused
+ */
+static void circle_key_overlay(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    Circle* circle = ctx;
+    profile.overlay = !profile.overlay;
+    raster_benchmark = profile.overlay;
+    circle->dirty |= CircleDirtyMode;
+}
+#endif
+
+/**
+ * Moves the bouncing circles one step
+ *
+ * @param ctx circle
+ */
+static void circle_tick(void* ctx) {
+    Circle* circle = ctx;
+    //a tick queued before the timer was stopped is ignored
+    if(!circle_modes[circle->mode].particles) return;
+    APP_PROFILE_START(update_start);
+    circle_particles_step(circle->particles);
+    APP_PROFILE_STOP(&profile.update, update_start);
+    circle->dirty |= CircleDirtyParticles;
+}
+
+//arrow keys act on the press and keep acting while held, faster the longer they are held, OK acts on release
+static const AppHandlers circle_handlers = {
+    .tick = circle_tick,
+    .keys =
+        {
+            [InputKeyUp] =
+                {
+                    [InputTypePress] = circle_key_resize,
+                    [InputTypeLong] = circle_key_resize,
+                    [InputTypeRepeat] = circle_key_resize,
+                },
+            [InputKeyDown] =
+                {
+                    [InputTypePress] = circle_key_resize,
+                    [InputTypeLong] = circle_key_resize,
+                    [InputTypeRepeat] = circle_key_resize,
+                },
+            [InputKeyRight] =
+                {
+                    [InputTypePress] = circle_key_move,
+                    [InputTypeLong] = circle_key_move,
+                    [InputTypeRepeat] = circle_key_move,
+                },
+            [InputKeyLeft] =
+                {
+                    [InputTypePress] = circle_key_move,
+                    [InputTypeLong] = circle_key_move,
+                    [InputTypeRepeat] = circle_key_move,
+                },
+            [InputKeyOk] =
+                {
+                    //on the short press, a long one only shows the overlay
+                    [InputTypeShort] = circle_key_mode,
+#ifdef APP_PROFILE
+                    [InputTypeLong] = circle_key_overlay,
+#endif
+                },
+            [InputKeyBack] =
+                {
+                    [InputTypePress] = circle_key_exit,
+                },
+        },
+};
+
+#ifdef APP_TRACE
+/**
+ * @param circle current state
+ *
+ * @return checksum of the circle and all bouncing circles, equal for a recording and its replay
+ */
+static uint32_t circle_trace_digest(const Circle* const circle) {
+    const CircleParticles* particles = circle->particles;
+    uint32_t crc = app_crc32(0, &circle->loc, sizeof(circle->loc));
+    crc = app_crc32(crc, &circle->r, sizeof(circle->r));
+    crc = app_crc32(crc, &circle->mode, sizeof(circle->mode));
+    crc = app_crc32(crc, particles->x, particles->count * sizeof(uint16_t));
+    return app_crc32(crc, particles->y, particles->count * sizeof(uint16_t));
 }
+#endif
 
 int32_t circle_app(void* p) {
     UNUSED(p);
 
-    Circle* circle = malloc(sizeof(Circle));
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(CircleEvent));
+#ifdef APP_TRACE
+    //seeds rand, so the circles are placed the same way in a replay
+    app_trace_start(&app_trace, "Circle");
+#endif
+
+    Circle* circle = APP_ALLOC(sizeof(Circle));
+    circle->particles = circle_particles_alloc(
+        circle_modes[COUNT_OF(circle_modes) - 1].particles, MAX_X, MENU_BEGIN_Y);
     circle_init(circle);
 
-    ValueMutex state_mutex;
-    if(!init_mutex(&state_mutex, circle, sizeof(Circle))) {
-        FURI_LOG_E("Circle", "cannot create mutex\r\n");
-        free(circle);
-        return 255;
-    }
-    ViewPort* view_port = view_port_alloc();
-    view_port_draw_callback_set(view_port, draw_callback, &state_mutex);
-    view_port_input_callback_set(view_port, input_callback, event_queue);
-
-    // Open GUI and register view_port
-    Gui* gui = furi_record_open(RECORD_GUI);
-    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
-
-    CircleEvent event;
-    for(bool processing = true; processing;) {
-        FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
-
-        Circle* circle = (Circle*)acquire_mutex_block(&state_mutex);
-
-        if(event_status == FuriStatusOk) {
-            // key events
-            if(event.type == EventTypeKey) {
-                if(event.input.type == InputTypePress) {
-                    switch(event.input.key) {
-                        case InputKeyUp:
-                                circle->r -= 1;
-                            break;
-                        case InputKeyDown:
-                            if(circle->r < MENU_BEGIN_Y / 2)
-                                circle->r += 1;
-                            break;
-                        case InputKeyRight:
-                            if(((circle->loc.x + circle->move_x + circle->r) < MAX_X ))
-                                    circle->loc.x += circle->move_x;
-                            break;
-                        case InputKeyLeft:
-                            if((circle->loc.x + circle->move_x - circle->r) > 0)
-                                circle->loc.x -= circle->move_x;
-                            break;
-                        case InputKeyBack:
-                            processing = false;
-                            break;
-                        case InputKeyOk:
-                            break;
-                    }
-                }
-            }
-        }
+    AppSnapshot* snapshot = app_snapshot_alloc(CIRCLE_FRAME_SIZE);
+    circle_publish(circle, snapshot);
+
+    circle->runtime = app_runtime_alloc(draw_callback, snapshot);
+    app_runtime_timer_alloc(circle->runtime, FuriTimerTypePeriodic);
+#ifdef APP_PROFILE
+    app_profile_init(&profile);
+    circle->runtime->profile = &profile;
+#endif
+    app_runtime_show(circle->runtime);
 
-        view_port_update(view_port);
-        release_mutex(&state_mutex, circle);
+    AppEvent event;
+    while(app_runtime_wait(circle->runtime, &event)) {
+        APP_PROFILE_START(event_start);
+        app_runtime_dispatch(&circle_handlers, circle, &event);
+
+        //the gui redraws the whole frame, so frames are only requested if something changed
+        if(circle_update_status(circle)) {
+            APP_PROFILE_START(publish_start);
+            circle_publish(circle, snapshot);
+            APP_PROFILE_STOP(&profile.publish, publish_start);
+            view_port_update(circle->runtime->view_port);
+        }
+        APP_PROFILE_STOP(&profile.event, event_start);
     }
 
-    view_port_enabled_set(view_port, false);
-    gui_remove_view_port(gui, view_port);
-    furi_record_close(RECORD_GUI);
-    view_port_free(view_port);
-    furi_message_queue_free(event_queue);
-    delete_mutex(&state_mutex);
-    free(circle);
+#ifdef APP_PROFILE
+    circle_log_particles(circle->particles->count);
+    app_profile_log("Circle", &profile);
+    app_profile_dump("circle", &profile);
+    FURI_LOG_I("Circle", "frames: %" PRIu32 " dropped, %" PRIu32 " delayed", snapshot->dropped, snapshot->delayed);
+    FURI_LOG_I("Circle", "input: %" PRIu32 " repeats coalesced", circle->runtime->input.coalesced);
+#endif
+
+#ifdef APP_TRACE
+    app_trace_stop(&app_trace, "Circle", circle_trace_digest(circle));
+#endif
+
+    app_runtime_free(circle->runtime);
+    app_snapshot_free(snapshot);
+    circle_particles_free(circle->particles);
+    APP_FREE(circle);
 
     return 0;
 }
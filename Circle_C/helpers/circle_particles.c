@@ -0,0 +1,143 @@
+//------------------------------------------------------------------
+// circle_particles.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "circle_particles.h"
+#include "circle_raster.h"
+#include <stdlib.h>
+
+/**
+ * Allocates all arrays in one block, the arrays are ordered by alignment
+ *
+ * @param capacity maximum number of circles, up to CIRCLE_PARTICLES_CAPACITY
+ * @param width width of the area the circles move in, up to 128
+ * @param height height of the area the circles move in, up to 64
+ *
+ * @return particles without any circle
+ */
+CircleParticles* circle_particles_alloc(uint16_t capacity, uint8_t width, uint8_t height) {
+    furi_assert(capacity <= CIRCLE_PARTICLES_CAPACITY);
+    //the packed circles of the draw callback hold 7 bits of x and 6 bits of y
+    furi_assert(width <= 128 && height <= 64);
+    CircleParticles* particles = APP_ALLOC(sizeof(CircleParticles));
+    uint8_t* block = APP_ALLOC(CIRCLE_PARTICLES_BLOCK(capacity));
+    particles->x = (uint16_t*)block;
+    particles->y = particles->x + capacity;
+    particles->vx = (int16_t*)(particles->y + capacity);
+    particles->vy = particles->vx + capacity;
+    particles->r = (uint8_t*)(particles->vy + capacity);
+    particles->count = 0;
+    particles->capacity = capacity;
+    particles->width = width;
+    particles->height = height;
+    return particles;
+}
+
+/**
+ * Frees the arrays and the particles
+ *
+ * @param particles particles to be freed
+ */
+void circle_particles_free(CircleParticles* particles) {
+    furi_assert(particles);
+    APP_FREE(particles->x);
+    APP_FREE(particles);
+}
+
+/**
+ * Places the circles at random positions inside the area, with a random speed of up to 2 px per tick
+ *
+ * @param particles particles to fill
+ * @param count number of circles, limited to the capacity
+ */
+void circle_particles_spawn(CircleParticles* particles, uint16_t count) {
+    furi_assert(particles);
+    particles->count = MIN(count, particles->capacity);
+    for(uint16_t i = 0; i < particles->count; i++) {
+        const uint8_t r = 1 + rand() % CIRCLE_PARTICLES_MAX_RADIUS;
+        particles->r[i] = r;
+        particles->x[i] = (r + rand() % (particles->width - 2 * r)) << CIRCLE_PARTICLES_SHIFT;
+        particles->y[i] = (r + rand() % (particles->height - 2 * r)) << CIRCLE_PARTICLES_SHIFT;
+        particles->vx[i] = (rand() % (4 << CIRCLE_PARTICLES_SHIFT)) - (2 << CIRCLE_PARTICLES_SHIFT);
+        particles->vy[i] = (rand() % (4 << CIRCLE_PARTICLES_SHIFT)) - (2 << CIRCLE_PARTICLES_SHIFT);
+    }
+}
+
+/**
+ * Moves one axis of all circles, a circle crossing the border is mirrored back and its speed is inverted.
+ * The border checks are written as selects, so the loop compiles without jumps.
+ *
+ * @param position positions of the circles on the axis
+ * @param velocity velocities of the circles on the axis
+ * @param r radius of the circles
+ * @param count number of circles
+ * @param size size of the area on the axis
+ */
+static void circle_particles_step_axis(
+    uint16_t* restrict position,
+    int16_t* restrict velocity,
+    const uint8_t* restrict r,
+    uint16_t count,
+    uint8_t size) {
+    for(uint16_t i = 0; i < count; i++) {
+        const int32_t min = r[i] << CIRCLE_PARTICLES_SHIFT;
+        const int32_t max = (size - 1 - r[i]) << CIRCLE_PARTICLES_SHIFT;
+        const int32_t moved = position[i] + velocity[i];
+        const bool below = moved < min;
+        const bool above = moved > max;
+        position[i] = below ? 2 * min - moved : (above ? 2 * max - moved : moved);
+        velocity[i] = (below || above) ? -velocity[i] : velocity[i];
+    }
+}
+
+/**
+ * Moves all circles by one tick
+ *
+ * @param particles particles to move by one tick
+ */
+void circle_particles_step(CircleParticles* particles) {
+    furi_assert(particles);
+    circle_particles_step_axis(particles->x, particles->vx, particles->r, particles->count, particles->width);
+    circle_particles_step_axis(particles->y, particles->vy, particles->r, particles->count, particles->height);
+}
+
+/**
+ * Converts the fixed point positions to pixels and packs them with the radius into two bytes per circle
+ *
+ * @param particles particles to take the positions from
+ * @param packed filled with one packed circle per circle
+ *
+ * @return number of circles written to packed
+ */
+uint16_t circle_particles_snapshot(const CircleParticles* particles, uint16_t* packed) {
+    furi_assert(particles);
+    for(uint16_t i = 0; i < particles->count; i++) {
+        packed[i] = CIRCLE_PARTICLES_PACK(
+            particles->x[i] >> CIRCLE_PARTICLES_SHIFT, particles->y[i] >> CIRCLE_PARTICLES_SHIFT, particles->r[i]);
+    }
+    return particles->count;
+}
+
+/**
+ * Draws the outline of all circles
+ *
+ * @param packed packed circles to draw
+ * @param count number of circles
+ * @param buffer back buffer to draw to
+ * @param width circles are clipped right of it
+ * @param height circles are clipped below it
+ */
+void circle_particles_draw(const uint16_t* packed, uint16_t count, AppBackBuffer* buffer, uint8_t width, uint8_t height) {
+    for(uint16_t i = 0; i < count; i++) {
+        circle_raster_draw(
+            buffer,
+            CIRCLE_PARTICLES_X(packed[i]),
+            CIRCLE_PARTICLES_Y(packed[i]),
+            CIRCLE_PARTICLES_R(packed[i]),
+            width,
+            height);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+//------------------------------------------------------------------
+// circle_particles.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Fixed point simulation of many bouncing circles, stored as structure of arrays
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "../../common/app_arena.h"
+#include "../../common/app_backbuffer.h"
+
+//positions and velocities are stored with 8 fractional bits
+#define CIRCLE_PARTICLES_SHIFT 8
+#define CIRCLE_PARTICLES_MAX_RADIUS 4
+#define CIRCLE_PARTICLES_CAPACITY 1000
+//arena bytes and allocations of particles with the given capacity
+#define CIRCLE_PARTICLES_BLOCK(capacity) \
+    ((capacity) * (2 * sizeof(uint16_t) + 2 * sizeof(int16_t) + sizeof(uint8_t)))
+#define CIRCLE_PARTICLES_BYTES(capacity) (sizeof(CircleParticles) + CIRCLE_PARTICLES_BLOCK(capacity))
+#define CIRCLE_PARTICLES_ALLOCATIONS 2
+
+typedef struct {
+    uint16_t count;
+    uint16_t capacity;
+    uint8_t width; //circles bounce at 0 and width - 1
+    uint8_t height; //circles bounce at 0 and height - 1
+    uint16_t* x;
+    uint16_t* y;
+    int16_t* vx; //per tick
+    int16_t* vy; //per tick
+    uint8_t* r;
+} CircleParticles;
+
+//pixel position and radius of a circle in the 128x64 area packed for the draw callback, x in bits 0 to 6, y in
+//bits 7 to 12 and the radius minus 1 above
+#define CIRCLE_PARTICLES_PACK(x, y, r) ((uint16_t)((x) | (y) << 7 | ((r) - 1) << 13))
+#define CIRCLE_PARTICLES_X(packed) ((packed) & 0x7F)
+#define CIRCLE_PARTICLES_Y(packed) (((packed) >> 7) & 0x3F)
+#define CIRCLE_PARTICLES_R(packed) (((packed) >> 13) + 1)
+
+/**
+ * @param capacity maximum number of circles, up to CIRCLE_PARTICLES_CAPACITY
+ * @param width width of the area the circles move in, up to 128
+ * @param height height of the area the circles move in, up to 64
+ *
+ * @return particles without any circle
+ */
+ CircleParticles* circle_particles_alloc(uint16_t capacity, uint8_t width, uint8_t height);
+
+/**
+ * @param particles particles to be freed
+ */
+ void circle_particles_free(CircleParticles* particles);
+
+/**
+ * @param particles particles to fill
+ * @param count number of circles, limited to the capacity
+ */
+ void circle_particles_spawn(CircleParticles* particles, uint16_t count);
+
+/**
+ * @param particles particles to move by one tick
+ */
+ void circle_particles_step(CircleParticles* particles);
+
+/**
+ * @param particles particles to take the positions from
+ * @param packed filled with one packed circle per circle
+ *
+ * @return number of circles written to packed
+ */
+ uint16_t circle_particles_snapshot(const CircleParticles* particles, uint16_t* packed);
+
+/**
+ * @param packed packed circles to draw
+ * @param count number of circles
+ * @param buffer back buffer to draw to
+ * @param width circles are clipped right of it
+ * @param height circles are clipped below it
+ */
+ void circle_particles_draw(const uint16_t* packed, uint16_t count, AppBackBuffer* buffer, uint8_t width, uint8_t height);
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------
+// circle_raster.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "circle_raster.h"
+#include "circle_raster_tables.h"
+
+/**
+ * Draws a dot if it lies inside the area
+ *
+ * @param buffer back buffer to draw to
+ * @param x position of the dot
+ * @param y position of the dot
+ * @param width width of the area
+ * @param height height of the area
+ */
+static inline void circle_raster_dot(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t width, uint8_t height) {
+    if(x >= 0 && y >= 0 && x < width && y < height) app_backbuffer_dot(buffer, x, y, AppBackBufferSet);
+}
+
+/**
+ * Draws the eight points that are symmetric to one point of the octant
+ *
+ * @param buffer back buffer to draw to
+ * @param x center of the circle
+ * @param y center of the circle
+ * @param a offset along the octant
+ * @param b offset across the octant
+ * @param width width of the area
+ * @param height height of the area
+ */
+static inline void circle_raster_octants(
+    AppBackBuffer* buffer,
+    int16_t x,
+    int16_t y,
+    int16_t a,
+    int16_t b,
+    uint8_t width,
+    uint8_t height) {
+    circle_raster_dot(buffer, x + a, y - b, width, height);
+    circle_raster_dot(buffer, x - a, y - b, width, height);
+    circle_raster_dot(buffer, x + a, y + b, width, height);
+    circle_raster_dot(buffer, x - a, y + b, width, height);
+    circle_raster_dot(buffer, x + b, y - a, width, height);
+    circle_raster_dot(buffer, x - b, y - a, width, height);
+    circle_raster_dot(buffer, x + b, y + a, width, height);
+    circle_raster_dot(buffer, x - b, y + a, width, height);
+}
+
+/**
+ * Fills one clipped row of a filled circle, 32 pixels at a time
+ *
+ * @param buffer back buffer to draw to
+ * @param x center of the row
+ * @param y row to draw
+ * @param w half width of the row
+ * @param width width of the area
+ * @param height height of the area
+ */
+static inline void
+    circle_raster_row(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t w, uint8_t width, uint8_t height) {
+    if(y < 0 || y >= height) return;
+    app_backbuffer_hspan(buffer, MAX(x - w, 0), MIN(x + w, width - 1), y, AppBackBufferSet);
+}
+
+/**
+ * Draws the outline by mirroring the stored octant of the radius
+ */
+void circle_raster_draw(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height) {
+    r = MIN(r, CIRCLE_RASTER_MAX_RADIUS);
+    const uint8_t* octant = &circle_raster_octant[circle_raster_octant_offset[r]];
+    const uint16_t points = circle_raster_octant_offset[r + 1] - circle_raster_octant_offset[r];
+    for(uint16_t a = 0; a < points; a++) {
+        circle_raster_octants(buffer, x, y, a, octant[a], width, height);
+    }
+}
+
+/**
+ * Draws the filled circle row by row from the stored half widths of the radius
+ */
+void circle_raster_fill(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height) {
+    r = MIN(r, CIRCLE_RASTER_MAX_RADIUS);
+    const uint8_t* span = &circle_raster_span[r * (r + 1) / 2];
+    circle_raster_row(buffer, x, y, span[0], width, height);
+    for(uint8_t dy = 1; dy <= r; dy++) {
+        circle_raster_row(buffer, x, y - dy, span[dy], width, height);
+        circle_raster_row(buffer, x, y + dy, span[dy], width, height);
+    }
+}
+
+/**
+ * Same midpoint algorithm the tables are generated with
+ */
+void circle_raster_draw_midpoint(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height) {
+    int16_t f = 1 - r;
+    int16_t dd_x = 1;
+    int16_t dd_y = -2 * r;
+    int16_t a = 0;
+    int16_t b = r;
+
+    circle_raster_octants(buffer, x, y, a, b, width, height);
+    while(a < b) {
+        if(f >= 0) {
+            b--;
+            dd_y += 2;
+            f += dd_y;
+        }
+        a++;
+        dd_x += 2;
+        f += dd_x;
+        circle_raster_octants(buffer, x, y, a, b, width, height);
+    }
+}
+
+/**
+ * Same midpoint algorithm, each point of the octant fills the four rows it lies on
+ */
+void circle_raster_fill_midpoint(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height) {
+    int16_t f = 1 - r;
+    int16_t dd_x = 1;
+    int16_t dd_y = -2 * r;
+    int16_t a = 0;
+    int16_t b = r;
+
+    while(true) {
+        circle_raster_row(buffer, x, y - b, a, width, height);
+        circle_raster_row(buffer, x, y + b, a, width, height);
+        circle_raster_row(buffer, x, y - a, b, width, height);
+        circle_raster_row(buffer, x, y + a, b, width, height);
+        if(a >= b) break;
+        if(f >= 0) {
+            b--;
+            dd_y += 2;
+            f += dd_y;
+        }
+        a++;
+        dd_x += 2;
+        f += dd_x;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+//------------------------------------------------------------------
+// circle_raster.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Draws circles into the back buffer from precomputed raster tables instead of running the
+//                   midpoint algorithm for every circle of every frame
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "../../common/app_backbuffer.h"
+
+/**
+ * Draws the outline of a circle, clipped to the given area
+ *
+ * @param buffer back buffer to draw to
+ * @param x center of the circle
+ * @param y center of the circle
+ * @param r radius, limited to the largest radius in the tables
+ * @param width pixels right of it are not drawn
+ * @param height pixels below it are not drawn
+ */
+ void circle_raster_draw(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height);
+
+/**
+ * Draws a filled circle, clipped to the given area
+ *
+ * @param buffer back buffer to draw to
+ * @param x center of the circle
+ * @param y center of the circle
+ * @param r radius, limited to the largest radius in the tables
+ * @param width pixels right of it are not drawn
+ * @param height pixels below it are not drawn
+ */
+ void circle_raster_fill(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height);
+
+/**
+ * Draws the outline of a circle with the midpoint algorithm, only used to compare against the tables
+ *
+ * @param buffer back buffer to draw to
+ * @param x center of the circle
+ * @param y center of the circle
+ * @param r radius
+ * @param width pixels right of it are not drawn
+ * @param height pixels below it are not drawn
+ */
+ void circle_raster_draw_midpoint(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height);
+
+/**
+ * Draws a filled circle with the midpoint algorithm, only used to compare against the tables
+ *
+ * @param buffer back buffer to draw to
+ * @param x center of the circle
+ * @param y center of the circle
+ * @param r radius
+ * @param width pixels right of it are not drawn
+ * @param height pixels below it are not drawn
+ */
+ void circle_raster_fill_midpoint(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height);
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Generates circle_raster_tables.h, the raster tables of all circles the Circle app can draw.
+# Uses the same midpoint algorithm as canvas_draw_circle, so the table based circles look identical.
+#
+# Usage: python3 circle_raster_gen.py > circle_raster_tables.h
+
+MAX_RADIUS = 27  # MENU_BEGIN_Y / 2
+
+
+def octant(r):
+    """y of the outline for x = 0, 1, ... up to the diagonal"""
+    points = []
+    f = 1 - r
+    dd_x = 1
+    dd_y = -2 * r
+    x = 0
+    y = r
+    points.append(y)
+    while x < y:
+        if f >= 0:
+            y -= 1
+            dd_y += 2
+            f += dd_y
+        x += 1
+        dd_x += 2
+        f += dd_x
+        if x <= y:
+            points.append(y)
+    return points
+
+
+def spans(r):
+    """half width of the filled circle for each row distance 0 to r"""
+    widths = [0] * (r + 1)
+    for x, y in enumerate(octant(r)):
+        widths[y] = max(widths[y], x)
+        widths[x] = max(widths[x], y)
+    return widths
+
+
+def array(values, per_line=16):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i : i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+octants = [octant(r) for r in range(MAX_RADIUS + 1)]
+offsets = [0]
+for points in octants:
+    offsets.append(offsets[-1] + len(points))
+
+print("#pragma once")
+print("// Generated by circle_raster_gen.py, do not edit")
+print()
+print("#include <stdint.h>")
+print()
+print("#define CIRCLE_RASTER_MAX_RADIUS %d" % MAX_RADIUS)
+print()
+print("// start of the octant of each radius in circle_raster_octant")
+print("static const uint16_t circle_raster_octant_offset[CIRCLE_RASTER_MAX_RADIUS + 2] = {")
+print(array(offsets))
+print("};")
+print()
+print("// y of the outline for x = 0, 1, ... up to the diagonal")
+print("static const uint8_t circle_raster_octant[%d] = {" % offsets[-1])
+print(array([y for points in octants for y in points]))
+print("};")
+print()
+print("// half width of the filled circle for each row distance 0 to r, radius r starts at r * (r + 1) / 2")
+print("static const uint8_t circle_raster_span[%d] = {" % sum(r + 1 for r in range(MAX_RADIUS + 1)))
+print(array([w for r in range(MAX_RADIUS + 1) for w in spans(r)]))
+print("};")
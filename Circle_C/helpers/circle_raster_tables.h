@@ -0,0 +1,64 @@
+#pragma once
+// Generated by circle_raster_gen.py, do not edit
+
+#include <stdint.h>
+
+#define CIRCLE_RASTER_MAX_RADIUS 27
+
+// start of the octant of each radius in circle_raster_octant
+static const uint16_t circle_raster_octant_offset[CIRCLE_RASTER_MAX_RADIUS + 2] = {
+    0, 1, 2, 4, 7, 11, 15, 20, 26, 32, 39, 47, 56, 65, 75, 86,
+    97, 109, 122, 135, 149, 164, 180, 196, 213, 231, 249, 268, 288,
+};
+
+// y of the outline for x = 0, 1, ... up to the diagonal
+static const uint8_t circle_raster_octant[288] = {
+    0, 1, 2, 2, 3, 3, 2, 4, 4, 3, 3, 5, 5, 5, 4, 6,
+    6, 6, 5, 4, 7, 7, 7, 6, 6, 5, 8, 8, 8, 7, 7, 6,
+    9, 9, 9, 8, 8, 7, 7, 10, 10, 10, 10, 9, 9, 8, 7, 11,
+    11, 11, 11, 10, 10, 9, 8, 8, 12, 12, 12, 12, 11, 11, 10, 10,
+    9, 13, 13, 13, 13, 12, 12, 12, 11, 10, 9, 14, 14, 14, 14, 13,
+    13, 13, 12, 11, 11, 10, 15, 15, 15, 15, 14, 14, 14, 13, 13, 12,
+    11, 16, 16, 16, 16, 15, 15, 15, 14, 14, 13, 12, 12, 17, 17, 17,
+    17, 17, 16, 16, 15, 15, 14, 14, 13, 12, 18, 18, 18, 18, 18, 17,
+    17, 17, 16, 16, 15, 14, 13, 19, 19, 19, 19, 19, 18, 18, 18, 17,
+    17, 16, 15, 15, 14, 20, 20, 20, 20, 20, 19, 19, 19, 18, 18, 17,
+    17, 16, 15, 14, 21, 21, 21, 21, 21, 20, 20, 20, 19, 19, 18, 18,
+    17, 16, 16, 15, 22, 22, 22, 22, 22, 21, 21, 21, 20, 20, 20, 19,
+    18, 18, 17, 16, 23, 23, 23, 23, 23, 22, 22, 22, 22, 21, 21, 20,
+    20, 19, 18, 17, 17, 24, 24, 24, 24, 24, 23, 23, 23, 23, 22, 22,
+    21, 21, 20, 19, 19, 18, 17, 25, 25, 25, 25, 25, 24, 24, 24, 24,
+    23, 23, 22, 22, 21, 21, 20, 19, 18, 26, 26, 26, 26, 26, 26, 25,
+    25, 25, 24, 24, 24, 23, 23, 22, 21, 20, 20, 19, 27, 27, 27, 27,
+    27, 27, 26, 26, 26, 25, 25, 25, 24, 24, 23, 22, 22, 21, 20, 19,
+};
+
+// half width of the filled circle for each row distance 0 to r, radius r starts at r * (r + 1) / 2
+static const uint8_t circle_raster_span[406] = {
+    0, 1, 0, 2, 2, 1, 3, 3, 2, 1, 4, 4, 3, 3, 1, 5,
+    5, 5, 4, 3, 2, 6, 6, 6, 5, 4, 3, 2, 7, 7, 7, 6,
+    6, 5, 4, 2, 8, 8, 8, 7, 7, 6, 5, 4, 2, 9, 9, 9,
+    8, 8, 7, 7, 6, 4, 2, 10, 10, 10, 10, 9, 9, 8, 7, 6,
+    5, 3, 11, 11, 11, 11, 10, 10, 9, 8, 8, 6, 5, 3, 12, 12,
+    12, 12, 11, 11, 10, 10, 9, 8, 7, 5, 3, 13, 13, 13, 13, 12,
+    12, 12, 11, 10, 9, 8, 7, 6, 3, 14, 14, 14, 14, 13, 13, 13,
+    12, 11, 11, 10, 9, 7, 6, 3, 15, 15, 15, 15, 14, 14, 14, 13,
+    13, 12, 11, 10, 9, 8, 6, 3, 16, 16, 16, 16, 15, 15, 15, 14,
+    14, 13, 12, 12, 11, 9, 8, 6, 3, 17, 17, 17, 17, 17, 16, 16,
+    15, 15, 14, 14, 13, 12, 11, 10, 8, 6, 4, 18, 18, 18, 18, 18,
+    17, 17, 17, 16, 16, 15, 14, 13, 12, 11, 10, 9, 7, 4, 19, 19,
+    19, 19, 19, 18, 18, 18, 17, 17, 16, 15, 15, 14, 13, 12, 10, 9,
+    7, 4, 20, 20, 20, 20, 20, 19, 19, 19, 18, 18, 17, 17, 16, 15,
+    14, 13, 12, 11, 9, 7, 4, 21, 21, 21, 21, 21, 20, 20, 20, 19,
+    19, 18, 18, 17, 16, 16, 15, 14, 12, 11, 9, 7, 4, 22, 22, 22,
+    22, 22, 21, 21, 21, 20, 20, 20, 19, 18, 18, 17, 16, 15, 14, 13,
+    11, 10, 7, 4, 23, 23, 23, 23, 23, 22, 22, 22, 22, 21, 21, 20,
+    20, 19, 18, 17, 17, 16, 14, 13, 12, 10, 8, 4, 24, 24, 24, 24,
+    24, 23, 23, 23, 23, 22, 22, 21, 21, 20, 19, 19, 18, 17, 16, 15,
+    13, 12, 10, 8, 4, 25, 25, 25, 25, 25, 24, 24, 24, 24, 23, 23,
+    22, 22, 21, 21, 20, 19, 18, 17, 16, 15, 14, 12, 10, 8, 4, 26,
+    26, 26, 26, 26, 26, 25, 25, 25, 24, 24, 24, 23, 23, 22, 21, 20,
+    20, 19, 18, 17, 15, 14, 13, 11, 8, 5, 27, 27, 27, 27, 27, 27,
+    26, 26, 26, 25, 25, 25, 24, 24, 23, 22, 22, 21, 20, 19, 18, 17,
+    16, 14, 13, 11, 8, 5,
+};
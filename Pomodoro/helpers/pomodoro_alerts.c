@@ -0,0 +1,228 @@
+//------------------------------------------------------------------
+// pomodoro_alerts.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_alerts.h"
+#include "../../common/app_arena.h"
+#include <notification/notification.h>
+#include <notification/notification_messages.h>
+
+//value of repeats without an active alert
+#define POMODORO_ALERTS_IDLE UINT32_MAX
+
+typedef enum {
+    PomodoroAlertsWake, //repeats changed
+    PomodoroAlertsStop,
+} PomodoroAlertsRequest;
+
+struct PomodoroAlerts {
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    NotificationApp* notification;
+    //repeats played of the active alert, set to 0 by start, to POMODORO_ALERTS_IDLE by cancel and once the alert
+    //gives up. One word, so a cancel and a start between two repeats always start over with the first one.
+    uint32_t repeats;
+};
+
+APP_INSTANCE_DEFINE(PomodoroAlerts);
+
+/**
+ * First alert, a blink and a short tone
+ */
+static const NotificationSequence pomodoro_alerts_soft = {
+    &message_blue_255,
+    &message_note_c5,
+    &message_delay_100,
+    &message_sound_off,
+    &message_blue_0,
+    NULL,
+};
+
+/**
+ * Second and third alert, vibration and two tones
+ */
+static const NotificationSequence pomodoro_alerts_medium = {
+    &message_display_backlight_on,
+    &message_vibro_on,
+    &message_blue_255,
+    &message_note_e5,
+    &message_delay_100,
+    &message_sound_off,
+    &message_delay_50,
+    &message_note_e5,
+    &message_delay_100,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_blue_0,
+    NULL,
+};
+
+/**
+ * All later alerts, a longer vibration and a rising melody
+ */
+static const NotificationSequence pomodoro_alerts_loud = {
+    &message_display_backlight_on,
+    &message_vibro_on,
+    &message_red_255,
+    &message_note_c5,
+    &message_delay_100,
+    &message_note_e5,
+    &message_delay_100,
+    &message_note_g5,
+    &message_delay_100,
+    &message_note_c6,
+    &message_delay_250,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_red_0,
+    NULL,
+};
+
+/**
+ * Alert played for each repeat, the last one is kept for all further repeats
+ */
+static const NotificationSequence* const pomodoro_alerts_levels[] = {
+    &pomodoro_alerts_soft,
+    &pomodoro_alerts_medium,
+    &pomodoro_alerts_medium,
+    &pomodoro_alerts_loud,
+};
+
+/**
+ * Turns vibration, led and sound off
+ *
+ * @param alerts alerts to silence
+ */
+static void pomodoro_alerts_silence(PomodoroAlerts* alerts) {
+    notification_message(alerts->notification, &sequence_reset_vibro);
+    notification_message(alerts->notification, &sequence_reset_rgb);
+    notification_message(alerts->notification, &sequence_reset_sound);
+}
+
+/**
+ * Plays the repeats of an alert until it is cancelled or gives up, the notification service plays each one on its
+ * own, so this thread only waits for the next repeat or a request
+ *
+ * @param ctx alerts
+ *
+ * @return 0
+ */
+static int32_t pomodoro_alerts_worker(void* ctx) {
+    PomodoroAlerts* alerts = ctx;
+    const uint32_t interval = furi_ms_to_ticks(POMODORO_ALERTS_INTERVAL);
+    bool playing = false;
+    //a new alert is not played before the last one is an interval ago
+    uint32_t next = furi_get_tick();
+
+    for(;;) {
+        const bool active = __atomic_load_n(&alerts->repeats, __ATOMIC_ACQUIRE) != POMODORO_ALERTS_IDLE;
+        if(!active && playing) {
+            //cancelled, the repeat that is still playing is silenced
+            pomodoro_alerts_silence(alerts);
+            playing = false;
+        }
+
+        const int32_t wait = (int32_t)(next - furi_get_tick());
+        const uint32_t timeout = !active ? FuriWaitForever : wait > 0 ? (uint32_t)wait : 0;
+        PomodoroAlertsRequest request;
+        if(furi_message_queue_get(alerts->queue, &request, timeout) == FuriStatusOk) {
+            if(request == PomodoroAlertsStop) break;
+            //the state is in repeats, a request only wakes the thread up to look at it
+            continue;
+        }
+        //read again, a cancel and a start may have come in while waiting
+        uint32_t repeats = __atomic_load_n(&alerts->repeats, __ATOMIC_ACQUIRE);
+        if(repeats == POMODORO_ALERTS_IDLE) continue;
+
+        playing = true;
+        notification_message(
+            alerts->notification, pomodoro_alerts_levels[MIN(repeats, COUNT_OF(pomodoro_alerts_levels) - 1)]);
+        next = furi_get_tick() + interval;
+        //given up after the last repeat, which plays to its end. If the app cancelled or started the alert
+        //meanwhile, its state is kept.
+        const uint32_t played = repeats + 1 >= POMODORO_ALERTS_REPEATS ? POMODORO_ALERTS_IDLE : repeats + 1;
+        if(__atomic_compare_exchange_n(
+               &alerts->repeats, &repeats, played, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+           played == POMODORO_ALERTS_IDLE) {
+            playing = false;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Opens the notification service and starts the thread of the alerts
+ *
+ * @return alerts, the thread is running
+ */
+PomodoroAlerts* pomodoro_alerts_alloc(void) {
+    PomodoroAlerts* alerts = APP_INSTANCE_ALLOC(PomodoroAlerts);
+    alerts->repeats = POMODORO_ALERTS_IDLE;
+    alerts->notification = furi_record_open(RECORD_NOTIFICATION);
+    alerts->queue = furi_message_queue_alloc(4, sizeof(PomodoroAlertsRequest));
+    alerts->thread = furi_thread_alloc();
+    furi_thread_set_name(alerts->thread, "PomodoroAlerts");
+    furi_thread_set_stack_size(alerts->thread, 1024);
+    furi_thread_set_context(alerts->thread, alerts);
+    furi_thread_set_callback(alerts->thread, pomodoro_alerts_worker);
+    furi_thread_start(alerts->thread);
+    return alerts;
+}
+
+/**
+ * Stops the thread, silences a running alert and closes the notification service
+ *
+ * @param alerts alerts to be stopped and freed
+ */
+void pomodoro_alerts_free(PomodoroAlerts* alerts) {
+    furi_assert(alerts);
+    const PomodoroAlertsRequest request = PomodoroAlertsStop;
+    furi_message_queue_put(alerts->queue, &request, FuriWaitForever);
+    furi_thread_join(alerts->thread);
+    furi_thread_free(alerts->thread);
+    furi_message_queue_free(alerts->queue);
+
+    pomodoro_alerts_silence(alerts);
+    furi_record_close(RECORD_NOTIFICATION);
+    APP_INSTANCE_FREE(alerts);
+}
+
+/**
+ * Starts the alert with its first repeat, a running one goes on with its repeats. A full queue already holds a wake
+ * up, so the request is dropped instead of waiting.
+ *
+ * @param alerts alerts to play, never blocks
+ */
+void pomodoro_alerts_start(PomodoroAlerts* alerts) {
+    furi_assert(alerts);
+    uint32_t idle = POMODORO_ALERTS_IDLE;
+    if(!__atomic_compare_exchange_n(&alerts->repeats, &idle, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return;
+    const PomodoroAlertsRequest request = PomodoroAlertsWake;
+    furi_message_queue_put(alerts->queue, &request, 0);
+}
+
+/**
+ * Ends the alert, the thread silences the repeat being played. The next alert waits for the interval since the
+ * last one.
+ *
+ * @param alerts alerts to cancel, never blocks
+ */
+void pomodoro_alerts_cancel(PomodoroAlerts* alerts) {
+    furi_assert(alerts);
+    if(__atomic_exchange_n(&alerts->repeats, POMODORO_ALERTS_IDLE, __ATOMIC_ACQ_REL) == POMODORO_ALERTS_IDLE) return;
+    const PomodoroAlertsRequest request = PomodoroAlertsWake;
+    furi_message_queue_put(alerts->queue, &request, 0);
+}
+
+/**
+ * @param alerts alerts to look at
+ *
+ * @return true while an alert is playing or waiting for its next repeat
+ */
+bool pomodoro_alerts_active(const PomodoroAlerts* alerts) {
+    furi_assert(alerts);
+    return __atomic_load_n(&alerts->repeats, __ATOMIC_ACQUIRE) != POMODORO_ALERTS_IDLE;
+}
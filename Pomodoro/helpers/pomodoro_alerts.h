@@ -0,0 +1,46 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_alerts.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Plays the alert once the time is up on a thread of its own, so the loop never waits for
+//                   the notification service. The alert gets louder with each repeat, repeats are spaced out
+//                   and stop after a while, and a cancel ends it at once.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+
+//ms between two repeats of the alert, also the least time before a new alert is played
+#define POMODORO_ALERTS_INTERVAL (10 * 1000)
+//repeats after which the alert gives up
+#define POMODORO_ALERTS_REPEATS 6
+
+typedef struct PomodoroAlerts PomodoroAlerts;
+
+/**
+ * @return alerts, the thread is running
+ */
+ PomodoroAlerts* pomodoro_alerts_alloc(void);
+
+/**
+ * @param alerts alerts to be stopped and freed
+ */
+ void pomodoro_alerts_free(PomodoroAlerts* alerts);
+
+/**
+ * @param alerts alerts to play, never blocks
+ */
+ void pomodoro_alerts_start(PomodoroAlerts* alerts);
+
+/**
+ * @param alerts alerts to cancel, never blocks
+ */
+ void pomodoro_alerts_cancel(PomodoroAlerts* alerts);
+
+/**
+ * @param alerts alerts to look at
+ *
+ * @return true while an alert is playing or waiting for its next repeat
+ */
+ bool pomodoro_alerts_active(const PomodoroAlerts* alerts);
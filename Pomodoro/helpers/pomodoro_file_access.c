@@ -6,147 +6,619 @@
 //-------------------------------------------------------------------
 
 #include "pomodoro_file_access.h"
+#include "pomodoro_phase.h"
+#include "pomodoro_journal.h"
+#include <storage/storage.h>
+#include <inttypes.h>
+
+typedef enum {
+    PomodoroConfigWorkTime,
+    PomodoroConfigShortBreakTime,
+    PomodoroConfigLongBreakTime,
+    PomodoroConfigCycle,
+    PomodoroConfigCount,
+    PomodoroConfigRepetitions,
+    PomodoroConfigState,
+    PomodoroConfigTotalRuns,
+    PomodoroConfigKeyCount,
+} PomodoroConfigKey;
+
+_Static_assert(PomodoroConfigKeyCount <= 8, "dirty holds one bit per key");
+
+/**
+ * Keys in the order they are written to the file
+ */
+static const char* const pomodoro_config_keys[PomodoroConfigKeyCount] = {
+    POMODORO_CONFIG_KEY_WORK_TIME,
+    POMODORO_CONFIG_KEY_SHORT_BREAK_TIME,
+    POMODORO_CONFIG_KEY_LONG_BREAK_TIME,
+    POMODORO_CONFIG_KEY_CYCLE,
+    POMODORO_CONFIG_KEY_COUNT,
+    POMODORO_CONFIG_KEY_REPETITIONS,
+    POMODORO_CONFIG_KEY_STATE,
+    POMODORO_CONFIG_KEY_TOTAL_RUNS,
+};
+
+/**
+ * Values used for keys that are not in the config file
+ */
+static const uint32_t pomodoro_config_defaults[PomodoroConfigKeyCount] = {
+    [PomodoroConfigWorkTime] = 25,
+    [PomodoroConfigShortBreakTime] = 5,
+    [PomodoroConfigLongBreakTime] = 30,
+    [PomodoroConfigCycle] = 4,
+};
+
+/**
+ * Key of the minutes of each interval
+ */
+static const PomodoroConfigKey pomodoro_config_durations[PomodoroStateCount] = {
+    [workTime] = PomodoroConfigWorkTime,
+    [shortBreakTime] = PomodoroConfigShortBreakTime,
+    [longBreakTime] = PomodoroConfigLongBreakTime,
+};
+
+/**
+ * Journal record waiting for the writer. Only the newest record is read back on the next start, so a newer one
+ * replaces a record that was not written yet.
+ */
+typedef struct {
+    PomodoroJournal* journal; //NULL if no record is waiting
+    Pomodoro run;
+    uint32_t elapsed;
+    uint32_t timestamp;
+} PomodoroJournalEntry;
+
+/**
+ * In memory copy of the config file, only written back if a value has changed
+ */
+typedef struct {
+    uint32_t values[PomodoroConfigKeyCount];
+    uint8_t dirty;
+    bool dirReady;
+    char text[256]; //file content, kept here to save the stack of the app
+    PomodoroJournalEntry entry;
+    bool queued; //a save is waiting for the writer, further ones are folded into it
+    FuriMutex* lock; //guards values, dirty, entry and queued while the writer runs, NULL without it
+} PomodoroConfig;
+
+static PomodoroConfig config;
+
+typedef enum {
+    PomodoroWriterSave,
+    PomodoroWriterJob,
+    PomodoroWriterStop,
+} PomodoroWriterType;
+
+typedef struct {
+    PomodoroWriterType type;
+    PomodoroFileJob job;
+    void* ctx;
+    uint32_t data[POMODORO_FILE_JOB_DATA / sizeof(uint32_t)]; //copy of the data of the job
+} PomodoroWriterRequest;
 
 /**
- * Closes the openend file
+ * Thread writing the config, the journal and the jobs of the helpers behind the back of the app. The queue holds
+ * POMODORO_FILE_QUEUE requests, at most one of them a save, further saves are folded into it as the writer always
+ * takes the latest values.
+ */
+static struct {
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    FuriSemaphore* done; //released once the writer has written the last save
+} writer;
+
+#ifdef APP_PROFILE
+static struct {
+    uint32_t saves;
+    uint32_t skipped;
+    uint32_t collapsed; //saves folded into one that was still queued
+    uint32_t records; //journal records written
+    uint32_t replaced; //journal records replaced by a newer one before they were written
+    uint32_t jobs; //jobs of the helpers
+    uint32_t full; //requests the app had to wait for as the queue was full
+    uint32_t bytes;
+    uint32_t calls;
+    uint32_t write_max; //longest save or job of the writer in cycles, the app does not wait for it
+    uint32_t load; //cycles the load took on the worker of the app
+    AppProfileHistogram* histogram;
+} stats;
+#define POMODORO_FILE_STAT(field, value) stats.field += (value)
+#define POMODORO_FILE_TIME(name) \
+    if(stats.histogram) APP_PROFILE_STOP(stats.histogram, name)
+#else
+#define POMODORO_FILE_STAT(field, value)
+#define POMODORO_FILE_TIME(name)
+#endif
+
+/**
+ * Changes a value of the config and marks it as dirty if it differs
  *
- * @param file file that shall be closed
+ * @param key key to be changed
+ * @param value new value
  */
- static void pomodoro_close_config_file(FlipperFormat* file) {
-    furi_record_close(RECORD_STORAGE);
-    if(file == NULL) return;
-    flipper_format_file_close(file);
-    flipper_format_free(file);
+static void pomodoro_config_set(PomodoroConfigKey key, uint32_t value) {
+    //called with the lock held
+    if(config.values[key] == value) return;
+    config.values[key] = value;
+    config.dirty |= 1 << key;
+}
+
+/**
+ * Takes the lock guarding what the app shares with the writer, the config as well as the data of the helpers that
+ * their jobs read
+ *
+ * @return true if the lock is taken, false if there is no writer and so no lock
+ */
+ bool pomodoro_file_lock(void) {
+    if(!config.lock) return false;
+    furi_mutex_acquire(config.lock, FuriWaitForever);
+    return true;
 }
 
 /**
- * Tryies to open the config file, if it does not exists, looks for the dir, if that does not exists, creates dir, then
- * the file.
+ * @param locked return value of pomodoro_file_lock
+ */
+ void pomodoro_file_unlock(bool locked) {
+    if(locked) furi_mutex_release(config.lock);
+}
+
+/**
+ * Writes the whole config in one go to a temp file and renames it over the config file afterwards, does
+ * nothing if no value has changed since the last write. The values are copied under the lock, the file is written
+ * without it, so the app only waits for the copy.
  *
- * @param storage
+ * @return true if the file is up to date
  */
- static FlipperFormat* pomodoro_open_config_file() {
+static bool pomodoro_config_flush(void) {
+    bool locked = pomodoro_file_lock();
+    const uint8_t dirty = config.dirty;
+    uint32_t values[PomodoroConfigKeyCount];
+    memcpy(values, config.values, sizeof(values));
+    config.dirty = 0;
+    pomodoro_file_unlock(locked);
+    if(!dirty) {
+        POMODORO_FILE_STAT(skipped, 1);
+        return true;
+    }
+
+    char* buffer = config.text;
+    int length = snprintf(
+        buffer, sizeof(config.text), "Filetype: %s\nVersion: %d\n", POMODORO_FILE_HEADER, POMODORO_FILE_ACTUAL_VERSION);
+    for(uint8_t i = 0; i < PomodoroConfigKeyCount; i++) {
+        length += snprintf(
+            buffer + length, sizeof(config.text) - length, "%s: %" PRIu32 "\n", pomodoro_config_keys[i], values[i]);
+    }
+
     Storage* storage = furi_record_open(RECORD_STORAGE);
-    FlipperFormat* file = flipper_format_file_alloc(storage);
+    if(!config.dirReady) {
+        config.dirReady = storage_simply_mkdir(storage, POMODORO_FILE_DIR_PATH);
+        POMODORO_FILE_STAT(calls, 1);
+    }
 
-    if(storage_common_stat(storage, POMODORO_FILE_PATH, NULL) == FSE_OK) {
-        if(!flipper_format_file_open_existing(file, POMODORO_FILE_PATH)) {
-            pomodoro_close_config_file(file);
-            return NULL;
-        }
-    } else {
-        if(storage_common_stat(storage, POMODORO_FILE_DIR_PATH, NULL) == FSE_NOT_EXIST) {
-            if(!storage_simply_mkdir(storage, POMODORO_FILE_DIR_PATH)) {
-                return NULL;
-            }
-        }
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, POMODORO_FILE_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(file, buffer, length) == length;
+    storage_file_close(file);
+    storage_file_free(file);
+    POMODORO_FILE_STAT(calls, 3);
 
-        if(!flipper_format_file_open_new(file, POMODORO_FILE_PATH)) {
-            pomodoro_close_config_file(file);
-            return NULL;
-        }
+    //the storage can not rename onto an existing file, on a crash in between the temp file is picked up on the next start
+    if(success) {
+        storage_common_remove(storage, POMODORO_FILE_PATH);
+        success = storage_common_rename(storage, POMODORO_FILE_TMP_PATH, POMODORO_FILE_PATH) == FSE_OK;
+        POMODORO_FILE_STAT(calls, 2);
+    }
+    furi_record_close(RECORD_STORAGE);
 
-        flipper_format_write_header_cstr(file, POMODORO_FILE_HEADER, POMODORO_FILE_ACTUAL_VERSION);
-        flipper_format_rewind(file);
+    //the values stay dirty for the next save
+    if(!success) {
+        locked = pomodoro_file_lock();
+        config.dirty |= dirty;
+        pomodoro_file_unlock(locked);
     }
-    return file;
+    POMODORO_FILE_STAT(saves, 1);
+    POMODORO_FILE_STAT(bytes, length);
+    return success;
 }
 
 /**
- * Saves the current run to the config file so it can be initializied again
+ * Appends the journal record that is waiting, if there is one
  *
- * @param pomodoro contains the run values to be saved
+ * @return true if the record was written or none was waiting
+ */
+static bool pomodoro_journal_flush(void) {
+    bool locked = pomodoro_file_lock();
+    const PomodoroJournalEntry entry = config.entry;
+    config.entry.journal = NULL;
+    pomodoro_file_unlock(locked);
+    if(!entry.journal) return true;
+
+    POMODORO_FILE_STAT(records, 1);
+    return pomodoro_journal_append(entry.journal, &entry.run, entry.elapsed, entry.timestamp);
+}
+
+/**
+ * Puts a request into the queue of the writer, waiting for a free slot if all are taken
+ *
+ * @param request request to be copied into the queue
  */
- void pomodoro_save_current_run(const Pomodoro *pomodoro) {
-    FlipperFormat* file = pomodoro_open_config_file();
+static void pomodoro_file_put(const PomodoroWriterRequest* request) {
+    if(furi_message_queue_get_space(writer.queue) == 0) {
+        POMODORO_FILE_STAT(full, 1);
+    }
+    furi_message_queue_put(writer.queue, request, FuriWaitForever);
+}
+
+/**
+ * Hands the changed values and the journal record to the writer, without a writer they are written right away
+ *
+ * @return true if the files are up to date or the save is queued
+ */
+static bool pomodoro_config_save(void) {
+    if(!writer.thread) return pomodoro_config_flush() & pomodoro_journal_flush();
+    const bool locked = pomodoro_file_lock();
+    const bool queued = config.queued;
+    config.queued = true;
+    pomodoro_file_unlock(locked);
+    //a save that is still waiting picks up the new values as well
+    if(queued) {
+        POMODORO_FILE_STAT(collapsed, 1);
+        return true;
+    }
+    const PomodoroWriterRequest request = {.type = PomodoroWriterSave};
+    pomodoro_file_put(&request);
+    return true;
+}
+
+/**
+ * Writes each queued save and runs each queued job in order until it is asked to stop
+ *
+ * @param ctx unused
+ *
+ * @return 0
+ */
+static int32_t pomodoro_file_writer(void* ctx) {
+    UNUSED(ctx);
+    PomodoroWriterRequest request = {.type = PomodoroWriterSave};
+    while(request.type != PomodoroWriterStop &&
+          furi_message_queue_get(writer.queue, &request, FuriWaitForever) == FuriStatusOk) {
+        APP_PROFILE_START(start);
+        if(request.type == PomodoroWriterSave) {
+            const bool locked = pomodoro_file_lock();
+            config.queued = false;
+            pomodoro_file_unlock(locked);
+            pomodoro_config_flush();
+            pomodoro_journal_flush();
+        } else if(request.type == PomodoroWriterJob) {
+            request.job(request.ctx, request.data);
+        }
+#ifdef APP_PROFILE
+        stats.write_max = MAX(stats.write_max, app_profile_cycles() - start);
+#endif
+    }
+    furi_semaphore_release(writer.done);
+    return 0;
+}
 
-    uint32_t temp = pomodoro->count;
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_COUNT, &temp, 1);
+/**
+ * Starts the thread that writes the config, the journal and the jobs of the helpers from now on, saves only queue
+ * the values afterwards
+ */
+ void pomodoro_file_start(void) {
+    furi_assert(!writer.thread);
+    config.lock = furi_mutex_alloc(FuriMutexTypeNormal);
+    config.queued = false;
+    writer.queue = furi_message_queue_alloc(POMODORO_FILE_QUEUE, sizeof(PomodoroWriterRequest));
+    writer.done = furi_semaphore_alloc(1, 0);
+    writer.thread = furi_thread_alloc();
+    furi_thread_set_name(writer.thread, "PomodoroWriter");
+    furi_thread_set_stack_size(writer.thread, 2 * 1024);
+    furi_thread_set_callback(writer.thread, pomodoro_file_writer);
+    furi_thread_start(writer.thread);
+}
 
-    temp = pomodoro->repetitions;
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_REPETITIONS, &temp, 1);
+/**
+ * Writes the last save and the jobs still queued and stops the writer. A storage call can not be abandoned while
+ * the code of the app is unloaded after exit, so a write that takes longer than the timeout is logged and still
+ * waited for.
+ *
+ * @param timeout ticks to wait for the last save before it is logged as late
+ *
+ * @return true if the last save was written within the timeout
+ */
+ bool pomodoro_file_stop(uint32_t timeout) {
+    if(!writer.thread) return true;
+    const PomodoroWriterRequest request = {.type = PomodoroWriterStop};
+    furi_message_queue_put(writer.queue, &request, FuriWaitForever);
+    const bool in_time = furi_semaphore_acquire(writer.done, timeout) == FuriStatusOk;
+    if(!in_time) FURI_LOG_W("Pomodoro", "config still being written after %" PRIu32 " ticks", timeout);
+    furi_thread_join(writer.thread);
+    furi_thread_free(writer.thread);
+    furi_semaphore_free(writer.done);
+    furi_message_queue_free(writer.queue);
+    furi_mutex_free(config.lock);
+    writer.thread = NULL;
+    config.lock = NULL;
+    return in_time;
+}
 
-    temp = pomodoro->state;
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_STATE, &temp, 1);
+/**
+ * Hands a job of a helper to the writer, without a writer it is run right away. The app only waits for the copy of
+ * the data, or for a free slot if the queue is full, and that time is added to the histogram of the saves.
+ *
+ * @param job function writing the data
+ * @param ctx helper the data belongs to
+ * @param data data copied into the job, may be NULL
+ * @param size bytes of data, at most POMODORO_FILE_JOB_DATA
+ *
+ * @return true if the data was written or is queued
+ */
+ bool pomodoro_file_queue(PomodoroFileJob job, void* ctx, const void* data, size_t size) {
+    furi_assert(job);
+    furi_assert(size <= POMODORO_FILE_JOB_DATA);
+    APP_PROFILE_START(start);
+    PomodoroWriterRequest request = {.type = PomodoroWriterJob, .job = job, .ctx = ctx};
+    if(size) memcpy(request.data, data, size);
+    bool success = true;
+    if(writer.thread) {
+        pomodoro_file_put(&request);
+    } else {
+        success = job(ctx, request.data);
+    }
+    POMODORO_FILE_STAT(jobs, 1);
+    POMODORO_FILE_TIME(start);
+    return success;
+}
 
-    temp = pomodoro->totalruns;
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_TOTAL_RUNS, &temp, 1);
+/**
+ * Saves the current run to the config file so it can be initializied again
+ *
+ * @param pomodoro contains the run values to be saved
+ *
+ * @return true if the file is up to date or the save is queued
+ */
+ bool pomodoro_save_current_run(const Pomodoro *pomodoro) {
+    APP_PROFILE_START(start);
+    const bool locked = pomodoro_file_lock();
+    pomodoro_config_set(PomodoroConfigCount, pomodoro->count);
+    pomodoro_config_set(PomodoroConfigRepetitions, pomodoro->repetitions);
+    pomodoro_config_set(PomodoroConfigState, pomodoro->state);
+    pomodoro_config_set(PomodoroConfigTotalRuns, pomodoro->totalruns);
+    pomodoro_file_unlock(locked);
 
-    pomodoro_close_config_file(file);
+    const bool success = pomodoro_config_save();
+    POMODORO_FILE_TIME(start);
+    return success;
 }
 
 /**
  * Saves the times for each run
  *
  * @param pomodoro contains the times for the runs to be saved
+ *
+ * @return true if the file is up to date or the save is queued
  */
- void pomodoro_save_settings(const Pomodoro *pomodoro) {
-    FlipperFormat* file = pomodoro_open_config_file();
-
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_WORK_TIME, &pomodoro->workTime, 1);
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_SHORT_BREAK_TIME, &pomodoro->shortBreakTime, 1);
-    flipper_format_insert_or_update_uint32(file, POMODORO_CONFIG_KEY_LONG_BREAK_TIME, &pomodoro->longBreakTime, 1);
+ bool pomodoro_save_settings(const Pomodoro *pomodoro) {
+    APP_PROFILE_START(start);
+    const bool locked = pomodoro_file_lock();
+    for(uint8_t state = 0; state < PomodoroStateCount; state++) {
+        pomodoro_config_set(pomodoro_config_durations[state], pomodoro->durations[state]);
+    }
+    pomodoro_config_set(PomodoroConfigCycle, pomodoro->cycle);
+    pomodoro_file_unlock(locked);
 
-    pomodoro_close_config_file(file);
+    const bool success = pomodoro_config_save();
+    POMODORO_FILE_TIME(start);
+    return success;
 }
 
 /**
- * Loads the values from the config file, on error returns default values
+ * Applies one line of the config file, the first two lines have to be the header of this version
  *
- * @param pomodoro variable where the loaded items are written to
+ * @param line line without its line break, split at the separator while parsing
+ * @param number number of the line, starting at 0
+ *
+ * @return false if the file is not a config file of this version
  */
- void pomodoro_get_initial_values(Pomodoro *pomodoro){
-    FlipperFormat* file = pomodoro_open_config_file();
+static bool pomodoro_config_parse_line(char* line, uint32_t number) {
+    const size_t length = strlen(line);
+    if(length && line[length - 1] == '\r') line[length - 1] = '\0';
 
-    FuriString* file_type = furi_string_alloc();
+    char* separator = strstr(line, ": ");
+    if(number == 0) return separator && strcmp(separator + 2, POMODORO_FILE_HEADER) == 0;
+    if(number == 1) return separator && strtoul(separator + 2, NULL, 10) == POMODORO_FILE_ACTUAL_VERSION;
+    //comments, empty lines and keys of other versions are skipped
+    if(!separator) return true;
 
-    uint32_t version = 1;
-    if(!flipper_format_read_header(file, file_type, &version)) {
-        furi_string_free(file_type);
-        return;
+    *separator = '\0';
+    for(uint8_t i = 0; i < PomodoroConfigKeyCount; i++) {
+        if(strcmp(line, pomodoro_config_keys[i]) == 0) {
+            config.values[i] = strtoul(separator + 2, NULL, 10);
+            break;
+        }
     }
-    furi_string_free(file_type);
-
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_WORK_TIME, &pomodoro->workTime, 1))
-        pomodoro->workTime = 25;
+    return true;
+}
 
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_SHORT_BREAK_TIME, &pomodoro->shortBreakTime, 1))
-        pomodoro->shortBreakTime = 5;
+/**
+ * Reads the config file once from start to end into the values of the config. Storage is only written to if a
+ * temp file of an interrupted save has to be renamed, a missing file leaves the values alone.
+ *
+ * @return true if the file was read
+ */
+static bool pomodoro_config_load(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool valid = storage_file_open(file, POMODORO_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    POMODORO_FILE_STAT(calls, 1);
+    //a save was interrupted between removing the old and renaming the new file
+    if(!valid && storage_common_rename(storage, POMODORO_FILE_TMP_PATH, POMODORO_FILE_PATH) == FSE_OK) {
+        valid = storage_file_open(file, POMODORO_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+        POMODORO_FILE_STAT(calls, 2);
+    }
 
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_LONG_BREAK_TIME, &pomodoro->longBreakTime, 1))
-        pomodoro->longBreakTime = 30;
+    //lines are cut out of the buffer as they are complete, the rest is moved to the front before the next read
+    char* text = config.text;
+    size_t length = 0;
+    uint32_t number = 0;
+    bool skipping = false; //inside a line longer than the buffer, which can not be one of ours
+    while(valid) {
+        const uint16_t read = storage_file_read(file, text + length, sizeof(config.text) - 1 - length);
+        POMODORO_FILE_STAT(calls, 1);
+        length += read;
+        text[length] = '\0';
 
-    flipper_format_rewind(file);
+        char* line = text;
+        char* end;
+        while(valid && (end = strchr(line, '\n'))) {
+            *end = '\0';
+            if(!skipping) valid = pomodoro_config_parse_line(line, number);
+            skipping = false;
+            number++;
+            line = end + 1;
+        }
+        if(read == 0) {
+            //the last line may have no line break
+            if(valid && *line && !skipping) {
+                valid = pomodoro_config_parse_line(line, number);
+                number++;
+            }
+            break;
+        }
 
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_COUNT, &pomodoro->count, 1))
-        pomodoro->count = 0;
+        length -= line - text;
+        if(length == sizeof(config.text) - 1) {
+            //the header fits the buffer, a longer first or second line is no header of ours
+            if(number < 2) valid = false;
+            skipping = true;
+            length = 0;
+        }
+        memmove(text, line, length);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    //a file that ends before the header is not one of ours either
+    return valid && number >= 2;
+}
 
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_REPETITIONS, &pomodoro->repetitions, 1))
-        pomodoro->repetitions = 0;
+/**
+ * Appends a record of the run to the journal, on the writer if it runs
+ *
+ * @param journal journal to append to
+ * @param pomodoro run state to be saved
+ * @param elapsed ticks the run has been running
+ * @param timestamp current unix timestamp
+ *
+ * @return true if the record was written or is queued
+ */
+ bool pomodoro_save_journal(PomodoroJournal* journal, const Pomodoro* pomodoro, uint32_t elapsed, uint32_t timestamp) {
+    furi_assert(journal);
+    APP_PROFILE_START(start);
+    const bool locked = pomodoro_file_lock();
+    if(config.entry.journal) {
+        POMODORO_FILE_STAT(replaced, 1);
+    }
+    config.entry = (PomodoroJournalEntry){
+        .journal = journal,
+        .run = *pomodoro,
+        .elapsed = elapsed,
+        .timestamp = timestamp,
+    };
+    pomodoro_file_unlock(locked);
 
-    pomodoro->running = (pomodoro->count > 0 || pomodoro->repetitions > 0) ? true : false;
+    const bool success = pomodoro_config_save();
+    POMODORO_FILE_TIME(start);
+    return success;
+}
 
-    uint32_t state;
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_STATE, &state, 1)) {
-        pomodoro->state = 0;
-    }else{
-        pomodoro->state = state;
+/**
+ * Fills the run and the settings from the values of a config
+ *
+ * @param pomodoro variable where the values are written to
+ * @param values values by PomodoroConfigKey
+ */
+static void pomodoro_config_fill(Pomodoro *pomodoro, const uint32_t* values){
+    for(uint8_t state = 0; state < PomodoroStateCount; state++) {
+        pomodoro->durations[state] = values[pomodoro_config_durations[state]];
     }
+    pomodoro->count = values[PomodoroConfigCount];
+    pomodoro->repetitions = values[PomodoroConfigRepetitions];
+    pomodoro_phase_set_cycle(pomodoro, values[PomodoroConfigCycle]);
+    pomodoro->totalruns = values[PomodoroConfigTotalRuns];
+    pomodoro->running = pomodoro->count > 0 || pomodoro->repetitions > 0;
+    pomodoro->notification = false;
+    pomodoro_phase_set(pomodoro, values[PomodoroConfigState]);
+}
 
-    switch(pomodoro->state){
-        case workTime:
-            pomodoro->endTime = &pomodoro->workTime;
-            break;
-        case longBreakTime:
-            pomodoro->endTime = &pomodoro->longBreakTime;
-            break;
-        case shortBreakTime:
-            pomodoro->endTime = &pomodoro->shortBreakTime;
-            break;
+/**
+ * Fills in the compiled-in defaults without touching storage
+ *
+ * @param pomodoro variable where the defaults are written to
+ */
+ void pomodoro_get_default_values(Pomodoro *pomodoro){
+    pomodoro_config_fill(pomodoro, pomodoro_config_defaults);
+}
+
+/**
+ * Loads the values from the config file in a single pass, missing values and a missing or foreign file fall back to
+ * the defaults. On a fresh install nothing is written, the directory and the file are created by the first save.
+ * May run on a worker thread as long as nothing is saved meanwhile.
+ *
+ * @param pomodoro variable where the loaded items are written to
+ */
+ void pomodoro_get_initial_values(Pomodoro *pomodoro){
+    APP_PROFILE_START(start);
+    memcpy(config.values, pomodoro_config_defaults, sizeof(config.values));
+    if(!pomodoro_config_load()) {
+        //a foreign file may have filled some values before it was noticed
+        memcpy(config.values, pomodoro_config_defaults, sizeof(config.values));
     }
+    config.dirty = 0;
+    pomodoro_config_fill(pomodoro, config.values);
+#ifdef APP_PROFILE
+    //not part of the histogram, which only holds what the app waits for
+    stats.load = app_profile_cycles() - start;
+#endif
+}
 
-    if(!flipper_format_read_uint32(file, POMODORO_CONFIG_KEY_TOTAL_RUNS, &pomodoro->totalruns, 1))
-        pomodoro->totalruns = 0;
+#ifdef APP_PROFILE
+/**
+ * Adds the time the app waits for each save and job to the histogram from now on
+ *
+ * @param histogram histogram to add to
+ */
+ void pomodoro_file_profile(AppProfileHistogram* histogram) {
+    stats.histogram = histogram;
+}
 
-    pomodoro_close_config_file(file);
+/**
+ * Writes the number of saves and jobs, bytes written and storage calls to the log
+ */
+ void pomodoro_file_log_stats(void) {
+    FURI_LOG_I(
+        "Pomodoro",
+        "config: %" PRIu32 " saves, %" PRIu32 " skipped, %" PRIu32 " collapsed, %" PRIu32 " bytes, %" PRIu32 " storage calls, %" PRIu32 " bytes and %" PRIu32 " calls per save",
+        stats.saves,
+        stats.skipped,
+        stats.collapsed,
+        stats.bytes,
+        stats.calls,
+        stats.saves ? stats.bytes / stats.saves : 0,
+        stats.saves ? stats.calls / stats.saves : 0);
+    FURI_LOG_I("Pomodoro", "journal: %" PRIu32 " records, %" PRIu32 " replaced before written", stats.records, stats.replaced);
+    FURI_LOG_I(
+        "Pomodoro",
+        "writer: %" PRIu32 " jobs of the helpers, %" PRIu32 " requests waited for a full queue",
+        stats.jobs,
+        stats.full);
+    //the wait covers the saves and every job, so it bounds all storage the app writes to
+    FURI_LOG_I(
+        "Pomodoro",
+        "storage: load %" PRIu32 "us, longest write %" PRIu32 "us, the app waited at most %" PRIu32 "us",
+        stats.load / furi_hal_cortex_instructions_per_microsecond(),
+        stats.write_max / furi_hal_cortex_instructions_per_microsecond(),
+        stats.histogram ? stats.histogram->max / furi_hal_cortex_instructions_per_microsecond() : 0);
 }
+#endif
@@ -8,32 +8,117 @@
 //-------------------------------------------------------------------
 
 #include <furi.h>
-#include <flipper_format/flipper_format.h>
 #include "pomodoro_types.h"
+#include "../../common/app_profile.h"
 
 #define POMODORO_FILE_DIR_PATH "/ext/apps/misc"
 #define POMODORO_FILE_PATH POMODORO_FILE_DIR_PATH "/pomodoro.conf"
+#define POMODORO_FILE_TMP_PATH POMODORO_FILE_PATH ".tmp"
 
 #define POMODORO_FILE_HEADER "Flipper Pomodoro plugin config file"
 #define POMODORO_FILE_ACTUAL_VERSION 1
 #define POMODORO_CONFIG_KEY_WORK_TIME "workTime"
 #define POMODORO_CONFIG_KEY_SHORT_BREAK_TIME "shortBreakTime"
 #define POMODORO_CONFIG_KEY_LONG_BREAK_TIME "longBreakTime"
+#define POMODORO_CONFIG_KEY_CYCLE "cycle"
 #define POMODORO_CONFIG_KEY_COUNT "count"
 #define POMODORO_CONFIG_KEY_REPETITIONS "repetitions"
 #define POMODORO_CONFIG_KEY_STATE "state"
 #define POMODORO_CONFIG_KEY_TOTAL_RUNS "totalRuns"
+//ms the app waits on exit for the last save before it is logged as late
+#define POMODORO_FILE_STOP_TIMEOUT 500
+//requests the writer holds, the app only waits for it once they are all taken
+#define POMODORO_FILE_QUEUE 8
+//bytes of data a job carries to the writer
+#define POMODORO_FILE_JOB_DATA 44
+
+/**
+ * Writes what a helper handed to the writer
+ *
+ * @param ctx helper the data belongs to
+ * @param data copy of the data made when the job was queued
+ *
+ * @return true if the data was written
+ */
+typedef bool (*PomodoroFileJob)(void* ctx, const void* data);
+
+/**
+ * Starts the thread that writes the config, the journal and the jobs of the helpers from now on, saves only queue
+ * the values afterwards
+ */
+ void pomodoro_file_start(void);
+
+/**
+ * @param timeout ticks to wait for the last save before it is logged as late
+ *
+ * @return true if the last save was written within the timeout
+ */
+ bool pomodoro_file_stop(uint32_t timeout);
+
+/**
+ * @param job function writing the data
+ * @param ctx helper the data belongs to
+ * @param data data copied into the job, may be NULL
+ * @param size bytes of data, at most POMODORO_FILE_JOB_DATA
+ *
+ * @return true if the data was written or is queued
+ */
+ bool pomodoro_file_queue(PomodoroFileJob job, void* ctx, const void* data, size_t size);
+
+/**
+ * @return true if the lock is taken, false if there is no writer and so no lock
+ */
+ bool pomodoro_file_lock(void);
+
+/**
+ * @param locked return value of pomodoro_file_lock
+ */
+ void pomodoro_file_unlock(bool locked);
+
 /**
  * @param pomodoro Pomodoro object to be saved
+ *
+ * @return true if the file is up to date or the save is queued
  */
- void pomodoro_save_current_run(const Pomodoro *pomodoro);
+ bool pomodoro_save_current_run(const Pomodoro *pomodoro);
 
 /**
  * @param pomodoro Pomodoro object to be saved
+ *
+ * @return true if the file is up to date or the save is queued
+ */
+ bool pomodoro_save_settings(const Pomodoro *pomodoro);
+
+typedef struct PomodoroJournal PomodoroJournal;
+
+/**
+ * @param journal journal to append to
+ * @param pomodoro run state to be saved
+ * @param elapsed ticks the run has been running
+ * @param timestamp current unix timestamp
+ *
+ * @return true if the record was written or is queued
+ */
+ bool pomodoro_save_journal(PomodoroJournal* journal, const Pomodoro* pomodoro, uint32_t elapsed, uint32_t timestamp);
+
+/**
+ * @param pomodoro Pomodoro object that should store the defaults
  */
- void pomodoro_save_settings(const Pomodoro *pomodoro);
+ void pomodoro_get_default_values(Pomodoro *pomodoro);
 
 /**
  * @param pomodoro Pomodoro object that should store the values
  */
  void pomodoro_get_initial_values(Pomodoro *pomodoro);
+
+#ifdef APP_PROFILE
+/**
+ * @param histogram histogram the time the app waits for each save and job is added to
+ */
+ void pomodoro_file_profile(AppProfileHistogram* histogram);
+
+/**
+ * Writes the number of saves and jobs, bytes written and storage calls to the log
+ */
+ void pomodoro_file_log_stats(void);
+#endif
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------
+// pomodoro_history.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_history.h"
+#include "pomodoro_records.h"
+#include "../../common/app_arena.h"
+
+struct PomodoroHistory {
+    PomodoroRecords records;
+    PomodoroHistoryHeader header;
+};
+
+APP_INSTANCE_DEFINE(PomodoroHistory);
+
+/**
+ * @param header header read from the file
+ *
+ * @return true if the header belongs to a history of this capacity and its ring buffer is consistent, a file of
+ * another capacity is created again as its slots would be paged with the wrong modulus
+ */
+static bool pomodoro_history_check(const void* header) {
+    const PomodoroHistoryHeader* history = header;
+    return history->magic == POMODORO_HISTORY_MAGIC && history->version == POMODORO_HISTORY_VERSION &&
+           history->capacity == POMODORO_HISTORY_CAPACITY && history->head < history->capacity &&
+           history->count <= history->capacity;
+}
+
+static const PomodoroHistoryHeader pomodoro_history_fresh = {
+    .magic = POMODORO_HISTORY_MAGIC,
+    .version = POMODORO_HISTORY_VERSION,
+    .capacity = POMODORO_HISTORY_CAPACITY,
+};
+
+static const PomodoroRecordsLayout pomodoro_history_layout = {
+    .path = POMODORO_HISTORY_PATH,
+    .header_size = sizeof(PomodoroHistoryHeader),
+    .record_size = sizeof(PomodoroHistoryEntry),
+    .check = pomodoro_history_check,
+    .fresh = &pomodoro_history_fresh,
+    .count = POMODORO_HISTORY_CAPACITY,
+};
+
+/**
+ * Opens the history without touching storage if the file is missing, it is created with all slots by the first
+ * append
+ *
+ * @return history
+ */
+PomodoroHistory* pomodoro_history_alloc(void) {
+    PomodoroHistory* history = APP_INSTANCE_ALLOC(PomodoroHistory);
+    pomodoro_records_open(&history->records, &pomodoro_history_layout, &history->header);
+    return history;
+}
+
+/**
+ * Closes the history file
+ *
+ * @param history history to be closed
+ */
+void pomodoro_history_free(PomodoroHistory* history) {
+    furi_assert(history);
+    pomodoro_records_close(&history->records);
+    APP_INSTANCE_FREE(history);
+}
+
+/**
+ * Entry handed to the writer together with the header it results in
+ */
+typedef struct {
+    PomodoroHistoryHeader header;
+    PomodoroHistoryEntry entry;
+    uint16_t slot;
+} PomodoroHistoryWrite;
+
+_Static_assert(sizeof(PomodoroHistoryWrite) <= POMODORO_FILE_JOB_DATA, "history write must fit a job");
+
+/**
+ * Writes an entry to its slot and the header after it, run by the writer
+ *
+ * @param ctx history the entry belongs to
+ * @param data PomodoroHistoryWrite
+ *
+ * @return true if the entry was written
+ */
+static bool pomodoro_history_write(void* ctx, const void* data) {
+    PomodoroHistory* history = ctx;
+    const PomodoroHistoryWrite* write = data;
+    //if the header is not written, the entry is simply lost
+    const bool success = pomodoro_records_write(&history->records, write->slot, &write->entry, 1) &&
+                         pomodoro_records_write_header(&history->records, &write->header);
+    pomodoro_records_sync(&history->records);
+    return success;
+}
+
+/**
+ * Overwrites the oldest slot with the entry and moves the head forward. The header in memory is updated right
+ * away, the entry is written by the writer.
+ *
+ * @param history history to add the entry to
+ * @param entry finished interval
+ *
+ * @return true if the entry was written or is queued
+ */
+bool pomodoro_history_append(PomodoroHistory* history, const PomodoroHistoryEntry* entry) {
+    furi_assert(history);
+    PomodoroHistoryHeader* header = &history->header;
+    PomodoroHistoryWrite write = {.entry = *entry, .slot = header->head};
+
+    header->head = (header->head + 1) % header->capacity;
+    if(header->count < header->capacity) header->count++;
+
+    write.header = *header;
+    return pomodoro_file_queue(pomodoro_history_write, history, &write, sizeof(write));
+}
+
+/**
+ * @param history history to look at
+ *
+ * @return number of entries stored
+ */
+uint16_t pomodoro_history_count(const PomodoroHistory* history) {
+    furi_assert(history);
+    return history->header.count;
+}
+
+/**
+ * Reads one page of entries, the page lies in one block of slots unless it wraps around the end of the file
+ *
+ * @param history history to read from
+ * @param offset number of newest entries to skip
+ * @param entries buffer for the entries, newest first
+ * @param max size of the buffer
+ *
+ * @return number of entries read
+ */
+uint16_t pomodoro_history_read(PomodoroHistory* history, uint16_t offset, PomodoroHistoryEntry* entries, uint16_t max) {
+    furi_assert(history);
+    const PomodoroHistoryHeader* header = &history->header;
+    if(offset >= header->count) return 0;
+    const uint16_t length = MIN(max, header->count - offset);
+
+    //slot of the oldest entry of the page
+    const uint16_t first = (header->head + 2 * header->capacity - offset - length) % header->capacity;
+    const uint16_t block = MIN(length, header->capacity - first);
+
+    if(!pomodoro_records_read(&history->records, first, entries, block)) return 0;
+    if(block < length && !pomodoro_records_read(&history->records, 0, entries + block, length - block)) return 0;
+
+    for(uint16_t i = 0; i < length / 2; i++) {
+        PomodoroHistoryEntry temp = entries[i];
+        entries[i] = entries[length - 1 - i];
+        entries[length - 1 - i] = temp;
+    }
+    return length;
+}
@@ -0,0 +1,77 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_history.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Fixed size ring buffer file with the last finished work and break intervals
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "pomodoro_types.h"
+#include "pomodoro_file_access.h"
+
+#define POMODORO_HISTORY_PATH POMODORO_FILE_DIR_PATH "/pomodoro.history"
+#define POMODORO_HISTORY_MAGIC 0x484D4F50
+#define POMODORO_HISTORY_VERSION 1
+//entries kept before the oldest one is overwritten
+#define POMODORO_HISTORY_CAPACITY 256
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t capacity;
+    uint16_t head; //slot the next entry is written to
+    uint16_t count; //slots that hold an entry
+} PomodoroHistoryHeader;
+
+typedef struct {
+    uint32_t start; //unix timestamp the interval was started at
+    uint32_t actual; //seconds the interval was running
+    uint16_t planned; //minutes the interval was set to
+    uint8_t type; //PomodoroState of the interval
+    uint8_t reserved;
+} PomodoroHistoryEntry;
+
+_Static_assert(sizeof(PomodoroHistoryHeader) == 12, "history header must not contain padding");
+_Static_assert(sizeof(PomodoroHistoryEntry) == 12, "history entry must not contain padding");
+
+typedef struct PomodoroHistory PomodoroHistory;
+
+/**
+ * Opens the history without touching storage if the file is missing, it is created with all slots by the first
+ * append
+ *
+ * @return history
+ */
+ PomodoroHistory* pomodoro_history_alloc(void);
+
+/**
+ * @param history history to be closed
+ */
+ void pomodoro_history_free(PomodoroHistory* history);
+
+/**
+ * @param history history to add the entry to
+ * @param entry finished interval
+ *
+ * @return true if the entry was written or is queued
+ */
+ bool pomodoro_history_append(PomodoroHistory* history, const PomodoroHistoryEntry* entry);
+
+/**
+ * @param history history to look at
+ *
+ * @return number of entries stored
+ */
+ uint16_t pomodoro_history_count(const PomodoroHistory* history);
+
+/**
+ * @param history history to read from
+ * @param offset number of newest entries to skip
+ * @param entries buffer for the entries, newest first
+ * @param max size of the buffer
+ *
+ * @return number of entries read
+ */
+ uint16_t pomodoro_history_read(PomodoroHistory* history, uint16_t offset, PomodoroHistoryEntry* entries, uint16_t max);
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------
+// pomodoro_journal.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_journal.h"
+#include "../../common/app_arena.h"
+#include <storage/storage.h>
+#include "../../common/app_crc32.h"
+
+struct PomodoroJournal {
+    Storage* storage;
+    File* file;
+    bool open; //false while the file does not exist, it is created by the first append
+    uint32_t sequence;
+    uint32_t records;
+};
+
+APP_INSTANCE_DEFINE(PomodoroJournal);
+
+/**
+ * Checksum of a record, covering all fields before the crc
+ *
+ * @param record record to calculate the checksum of
+ */
+static uint32_t pomodoro_journal_crc(const PomodoroJournalRecord* record) {
+    return app_crc32(0, record, offsetof(PomodoroJournalRecord, crc));
+}
+
+/**
+ * Opens the journal file for reading and appending
+ *
+ * @param journal journal to open the file for
+ * @param mode FSOM_OPEN_EXISTING to leave a missing file alone, FSOM_OPEN_ALWAYS to create it
+ *
+ * @return true if the file is open
+ */
+static bool pomodoro_journal_open_file(PomodoroJournal* journal, FS_OpenMode mode) {
+    journal->open = storage_file_open(journal->file, POMODORO_JOURNAL_PATH, FSAM_READ | FSAM_WRITE, mode);
+    if(!journal->open) {
+        storage_file_close(journal->file);
+        return false;
+    }
+    //a partly written record at the end is overwritten by the next append
+    journal->records = storage_file_size(journal->file) / sizeof(PomodoroJournalRecord);
+    return true;
+}
+
+/**
+ * Replaces the journal by a new one that only contains the given record
+ *
+ * @param journal journal to compact
+ * @param record newest record
+ *
+ * @return true if the journal was rewritten
+ */
+static bool pomodoro_journal_compact(PomodoroJournal* journal, const PomodoroJournalRecord* record) {
+    storage_file_close(journal->file);
+
+    File* file = storage_file_alloc(journal->storage);
+    bool success = storage_file_open(file, POMODORO_JOURNAL_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(file, record, sizeof(PomodoroJournalRecord)) ==
+                       sizeof(PomodoroJournalRecord);
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if(success) {
+        storage_common_remove(journal->storage, POMODORO_JOURNAL_PATH);
+        success = storage_common_rename(journal->storage, POMODORO_JOURNAL_TMP_PATH, POMODORO_JOURNAL_PATH) ==
+                  FSE_OK;
+    }
+
+    return pomodoro_journal_open_file(journal, FSOM_OPEN_ALWAYS) && success;
+}
+
+/**
+ * Opens the journal if its file exists, a missing file is left alone and created by the first append
+ *
+ * @return journal
+ */
+PomodoroJournal* pomodoro_journal_alloc(void) {
+    PomodoroJournal* journal = APP_INSTANCE_ALLOC(PomodoroJournal);
+    journal->storage = furi_record_open(RECORD_STORAGE);
+    journal->file = storage_file_alloc(journal->storage);
+    journal->sequence = 0;
+    journal->records = 0;
+
+    //the journal was compacted, but the old file was removed before the new one could be renamed
+    if(!pomodoro_journal_open_file(journal, FSOM_OPEN_EXISTING) &&
+       storage_common_rename(journal->storage, POMODORO_JOURNAL_TMP_PATH, POMODORO_JOURNAL_PATH) == FSE_OK) {
+        pomodoro_journal_open_file(journal, FSOM_OPEN_EXISTING);
+    }
+    return journal;
+}
+
+/**
+ * Closes the journal file
+ *
+ * @param journal journal to be closed
+ */
+void pomodoro_journal_free(PomodoroJournal* journal) {
+    furi_assert(journal);
+    storage_file_close(journal->file);
+    storage_file_free(journal->file);
+    furi_record_close(RECORD_STORAGE);
+    APP_INSTANCE_FREE(journal);
+}
+
+/**
+ * Scans the journal backwards from the end, the first record with a valid checksum is the newest one
+ *
+ * @param journal journal to read from
+ * @param record newest valid record
+ *
+ * @return true if a valid record was found
+ */
+bool pomodoro_journal_recover(PomodoroJournal* journal, PomodoroJournalRecord* record) {
+    furi_assert(journal);
+    for(uint32_t i = journal->records; i > 0; i--) {
+        if(!storage_file_seek(journal->file, (i - 1) * sizeof(PomodoroJournalRecord), true)) break;
+        if(storage_file_read(journal->file, record, sizeof(PomodoroJournalRecord)) !=
+           sizeof(PomodoroJournalRecord))
+            continue;
+        if(record->magic == POMODORO_JOURNAL_MAGIC && record->crc == pomodoro_journal_crc(record)) {
+            journal->sequence = record->sequence;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Appends one record with the current run state, the journal is compacted once it grows too large and created by
+ * the first record
+ *
+ * @param journal journal to append to
+ * @param pomodoro run state to be saved
+ * @param elapsed ticks the run has been running
+ * @param timestamp current unix timestamp, a running run continues from it on the next start
+ *
+ * @return true if the record was written
+ */
+bool pomodoro_journal_append(PomodoroJournal* journal, const Pomodoro* pomodoro, uint32_t elapsed, uint32_t timestamp) {
+    furi_assert(journal);
+    PomodoroJournalRecord record = {
+        .magic = POMODORO_JOURNAL_MAGIC,
+        .sequence = ++journal->sequence,
+        .elapsed = elapsed,
+        .repetitions = pomodoro->repetitions,
+        .totalRuns = pomodoro->totalruns,
+        .state = pomodoro->state,
+        .running = pomodoro->running,
+        .timestamp = timestamp,
+    };
+    record.crc = pomodoro_journal_crc(&record);
+
+    if(journal->records >= POMODORO_JOURNAL_MAX_RECORDS) {
+        return pomodoro_journal_compact(journal, &record);
+    }
+    if(!journal->open) {
+        storage_simply_mkdir(journal->storage, POMODORO_FILE_DIR_PATH);
+        if(!pomodoro_journal_open_file(journal, FSOM_OPEN_ALWAYS)) return false;
+    }
+
+    if(!storage_file_seek(journal->file, journal->records * sizeof(PomodoroJournalRecord), true) ||
+       storage_file_write(journal->file, &record, sizeof(PomodoroJournalRecord)) !=
+           sizeof(PomodoroJournalRecord)) {
+        return false;
+    }
+    storage_file_sync(journal->file);
+    journal->records++;
+    return true;
+}
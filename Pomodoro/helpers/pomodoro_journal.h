@@ -0,0 +1,67 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_journal.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Append-only binary journal of the run state, so a crash or an empty battery only loses
+//                   the time since the last record
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "pomodoro_types.h"
+#include "pomodoro_file_access.h"
+
+#define POMODORO_JOURNAL_PATH POMODORO_FILE_DIR_PATH "/pomodoro.journal"
+#define POMODORO_JOURNAL_TMP_PATH POMODORO_JOURNAL_PATH ".tmp"
+//changed with the layout of the record, records of an older layout are ignored
+#define POMODORO_JOURNAL_MAGIC 0x4A4D4F51
+//journal is compacted to the newest record once it holds this many records
+#define POMODORO_JOURNAL_MAX_RECORDS 128
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t elapsed; //ticks the run has been running
+    uint32_t repetitions;
+    uint32_t totalRuns;
+    uint8_t state;
+    uint8_t running;
+    uint8_t reserved[2];
+    uint32_t timestamp; //unix timestamp the record was written at
+    uint32_t crc; //CRC-32 of all fields before
+} PomodoroJournalRecord;
+
+_Static_assert(sizeof(PomodoroJournalRecord) == 32, "journal record must not contain padding");
+
+typedef struct PomodoroJournal PomodoroJournal;
+
+/**
+ * Opens the journal if its file exists, a missing file is left alone and created by the first append
+ *
+ * @return journal
+ */
+ PomodoroJournal* pomodoro_journal_alloc(void);
+
+/**
+ * @param journal journal to be closed
+ */
+ void pomodoro_journal_free(PomodoroJournal* journal);
+
+/**
+ * @param journal journal to read from
+ * @param record newest valid record
+ *
+ * @return true if a valid record was found
+ */
+ bool pomodoro_journal_recover(PomodoroJournal* journal, PomodoroJournalRecord* record);
+
+/**
+ * @param journal journal to append to
+ * @param pomodoro run state to be saved
+ * @param elapsed ticks the run has been running
+ * @param timestamp current unix timestamp
+ *
+ * @return true if the record was written
+ */
+ bool pomodoro_journal_append(PomodoroJournal* journal, const Pomodoro* pomodoro, uint32_t elapsed, uint32_t timestamp);
@@ -0,0 +1,199 @@
+//------------------------------------------------------------------
+// pomodoro_phase.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_phase.h"
+#include "../../common/app_profile.h"
+#include <inttypes.h>
+
+typedef struct {
+    PomodoroState next;
+    PomodoroState cycle_end; //taken instead of next once the work interval completes the cycle
+    bool work; //finishes a work interval, which counts as a repetition
+    bool restart; //starts the cycle over
+} PomodoroTransition;
+
+//the config file and the journal store the state as a number, an unset or zero filled one is the work interval
+_Static_assert(workTime == 0 && shortBreakTime == 1 && longBreakTime == 2, "stored states must keep their numbers");
+//each row below has to list every event, adding one has to go through all of them
+_Static_assert(PomodoroStateCount == 3, "the transition table needs a row per state");
+_Static_assert(PomodoroEventCount == 4, "the transition table needs an entry per event");
+
+/**
+ * Interval that follows each interval on each event, events of the settings start from the chosen interval and
+ * all others from the interval of the run
+ */
+static const PomodoroTransition pomodoro_transitions[PomodoroStateCount][PomodoroEventCount] = {
+    [workTime] =
+        {
+            [PomodoroEventFinish] = {.next = shortBreakTime, .cycle_end = longBreakTime, .work = true},
+            [PomodoroEventReset] = {.next = workTime, .restart = true},
+            [PomodoroEventNext] = {.next = shortBreakTime},
+            [PomodoroEventPrevious] = {.next = longBreakTime},
+        },
+    [shortBreakTime] =
+        {
+            [PomodoroEventFinish] = {.next = workTime},
+            [PomodoroEventReset] = {.next = workTime, .restart = true},
+            [PomodoroEventNext] = {.next = longBreakTime},
+            [PomodoroEventPrevious] = {.next = workTime},
+        },
+    [longBreakTime] =
+        {
+            [PomodoroEventFinish] = {.next = workTime},
+            [PomodoroEventReset] = {.next = workTime, .restart = true},
+            [PomodoroEventNext] = {.next = workTime},
+            [PomodoroEventPrevious] = {.next = shortBreakTime},
+        },
+};
+
+/**
+ * Events that only change the interval chosen in the settings
+ */
+static const bool pomodoro_phase_chooses[PomodoroEventCount] = {
+    [PomodoroEventNext] = true,
+    [PomodoroEventPrevious] = true,
+};
+
+static const char* const pomodoro_phase_names[PomodoroStateCount] = {
+    [workTime] = "Work",
+    [shortBreakTime] = "Short break",
+    [longBreakTime] = "Long break",
+};
+
+#ifdef APP_PROFILE
+static struct {
+    uint32_t transitions;
+    uint32_t longest; //longest transition in cycles
+} stats;
+#endif
+
+/**
+ * @param state interval, also one read from a file
+ *
+ * @return name of the interval, the one of the work interval for an unknown state
+ */
+const char* pomodoro_phase_name(uint32_t state) {
+    return pomodoro_phase_names[state < PomodoroStateCount ? state : workTime];
+}
+
+/**
+ * Sets the interval of the run, the settings show the same interval
+ *
+ * @param pomodoro object that stores the current status
+ * @param state interval of the run, an unknown state read from a file starts with the work interval
+ */
+void pomodoro_phase_set(Pomodoro* pomodoro, uint32_t state) {
+    furi_assert(pomodoro);
+    pomodoro->state = state < PomodoroStateCount ? (PomodoroState)state : workTime;
+    pomodoro->selected = pomodoro->state;
+}
+
+/**
+ * Sets the length of the cycle, a run that already has as many repetitions ends the cycle with its next work
+ * interval
+ *
+ * @param pomodoro object that stores the current status
+ * @param cycle work intervals before the long break, 0 is taken as 1
+ */
+void pomodoro_phase_set_cycle(Pomodoro* pomodoro, uint32_t cycle) {
+    furi_assert(pomodoro);
+    //a cycle without a work interval would never get to the long break
+    pomodoro->cycle = cycle ? cycle : 1;
+    if(pomodoro->repetitions >= pomodoro->cycle) pomodoro->repetitions = pomodoro->cycle - 1;
+}
+
+/**
+ * Moves the run or the settings to the interval the table gives for the event. Finishing a work interval counts a
+ * repetition, and the one that completes the cycle is followed by the long break.
+ *
+ * @param pomodoro object that stores the current status
+ * @param event event that happened
+ */
+void pomodoro_phase_apply(Pomodoro* pomodoro, PomodoroEvent event) {
+    furi_assert(pomodoro);
+    furi_assert(event < PomodoroEventCount);
+    //kept by pomodoro_phase_set_cycle
+    furi_assert(pomodoro->repetitions < pomodoro->cycle);
+    APP_PROFILE_START(start);
+
+    if(pomodoro_phase_chooses[event]) {
+        pomodoro->selected = pomodoro_transitions[pomodoro->selected][event].next;
+    } else {
+        const PomodoroTransition* transition = &pomodoro_transitions[pomodoro->state][event];
+        PomodoroState next = transition->next;
+        if(transition->restart) pomodoro->repetitions = 0;
+        if(transition->work) {
+            pomodoro->repetitions++;
+            pomodoro->totalruns++;
+            if(pomodoro->repetitions == pomodoro->cycle) {
+                pomodoro->repetitions = 0;
+                next = transition->cycle_end;
+            }
+        }
+        pomodoro->state = next;
+        pomodoro->selected = next;
+    }
+
+#ifdef APP_PROFILE
+    const uint32_t cycles = app_profile_cycles() - start;
+    stats.transitions++;
+    if(cycles > stats.longest) stats.longest = cycles;
+#endif
+}
+
+/**
+ * Lets the run go on for the time the app was closed. Each interval that ran out is finished the way an arrow key
+ * would finish it. From the start of a work interval whole cycles bring the run back to where it was with one work
+ * interval more per repetition of the cycle, so they are skipped in one step and at most one cycle is walked through.
+ *
+ * @param pomodoro object that stores the current status, restored from a run that was running
+ * @param seconds seconds the app was closed
+ */
+void pomodoro_phase_continue(Pomodoro* pomodoro, uint32_t seconds) {
+    furi_assert(pomodoro);
+    const uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    uint32_t remaining = pomodoro->runElapsed / tick_frequency + seconds;
+
+    const uint32_t work = pomodoro->durations[workTime] * 60;
+    const uint32_t short_break = pomodoro->durations[shortBreakTime] * 60;
+    const uint32_t long_break = pomodoro->durations[longBreakTime] * 60;
+    if(work && short_break && long_break) {
+        //a break chosen in the settings may not sit where it would in the cycle, so it is finished first
+        if(pomodoro->state != workTime && remaining >= pomodoro->durations[pomodoro->state] * 60) {
+            remaining -= pomodoro->durations[pomodoro->state] * 60;
+            pomodoro_phase_apply(pomodoro, PomodoroEventFinish);
+        }
+        if(pomodoro->state == workTime) {
+            const uint32_t cycle = pomodoro->cycle * work + (pomodoro->cycle - 1) * short_break + long_break;
+            pomodoro->totalruns += pomodoro->cycle * (remaining / cycle);
+            remaining %= cycle;
+        }
+        while(remaining >= pomodoro->durations[pomodoro->state] * 60) {
+            remaining -= pomodoro->durations[pomodoro->state] * 60;
+            pomodoro_phase_apply(pomodoro, PomodoroEventFinish);
+        }
+    }
+
+    pomodoro->selected = pomodoro->state;
+    pomodoro->runElapsed = remaining * tick_frequency;
+    pomodoro->count = remaining / 60;
+    pomodoro->notification = false;
+    pomodoro->running = true;
+}
+
+#ifdef APP_PROFILE
+/**
+ * Writes the number of transitions and the longest one to the log
+ */
+void pomodoro_phase_log_stats(void) {
+    FURI_LOG_I(
+        "Pomodoro",
+        "phase: %" PRIu32 " transitions, longest %" PRIu32 " cycles",
+        stats.transitions,
+        stats.longest);
+}
+#endif
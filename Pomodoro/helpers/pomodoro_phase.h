@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_phase.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Moves the run and the settings from one interval to the next with a single transition table,
+//                   so which interval follows which and when the long break is due is written down in one place.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "pomodoro_types.h"
+
+typedef enum {
+    PomodoroEventFinish, //the interval of the run is over, by its time or by an arrow key
+    PomodoroEventReset, //the run starts over with the first work interval
+    PomodoroEventNext, //the next interval is chosen in the settings
+    PomodoroEventPrevious, //the previous interval is chosen in the settings
+    PomodoroEventCount,
+} PomodoroEvent;
+
+/**
+ * @param state interval, also one read from a file
+ *
+ * @return name of the interval, the one of the work interval for an unknown state
+ */
+ const char* pomodoro_phase_name(uint32_t state);
+
+/**
+ * @param pomodoro object that stores the current status
+ * @param state interval of the run, an unknown state read from a file starts with the work interval
+ */
+ void pomodoro_phase_set(Pomodoro* pomodoro, uint32_t state);
+
+/**
+ * @param pomodoro object that stores the current status
+ * @param cycle work intervals before the long break, 0 is taken as 1
+ */
+ void pomodoro_phase_set_cycle(Pomodoro* pomodoro, uint32_t cycle);
+
+/**
+ * @param pomodoro object that stores the current status
+ * @param event event that happened
+ */
+ void pomodoro_phase_apply(Pomodoro* pomodoro, PomodoroEvent event);
+
+/**
+ * @param pomodoro object that stores the current status, restored from a run that was running
+ * @param seconds seconds the app was closed
+ */
+ void pomodoro_phase_continue(Pomodoro* pomodoro, uint32_t seconds);
+
+#ifdef APP_PROFILE
+/**
+ * Writes the number of transitions and the longest one to the log
+ */
+ void pomodoro_phase_log_stats(void);
+#endif
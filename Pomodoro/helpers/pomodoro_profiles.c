@@ -0,0 +1,275 @@
+//------------------------------------------------------------------
+// pomodoro_profiles.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_profiles.h"
+#include "pomodoro_records.h"
+#include "../../common/app_arena.h"
+
+struct PomodoroProfiles {
+    PomodoroRecords records;
+    PomodoroProfilesHeader header;
+    PomodoroProfile profiles[POMODORO_PROFILES_CAPACITY]; //records of the file, read once on open
+};
+
+/**
+ * Change handed to the writer, a record and the header it results in
+ */
+typedef struct {
+    PomodoroProfilesHeader header;
+    PomodoroProfile profile;
+    uint8_t index; //index of the record, POMODORO_PROFILES_NONE to only write the header
+    bool write_header;
+} PomodoroProfilesWrite;
+
+_Static_assert(sizeof(PomodoroProfilesWrite) <= POMODORO_FILE_JOB_DATA, "profiles write must fit a job");
+
+APP_INSTANCE_DEFINE(PomodoroProfiles);
+
+/**
+ * Profiles written to a new file, the first one has the default times of the config
+ */
+static const PomodoroProfile pomodoro_profiles_builtin[] = {
+    {.name = "Classic", .durations = {[workTime] = 25, [shortBreakTime] = 5, [longBreakTime] = 30}, .cycle = 4},
+    {.name = "Deep work", .durations = {[workTime] = 90, [shortBreakTime] = 15, [longBreakTime] = 30}, .cycle = 2},
+    {.name = "Study", .durations = {[workTime] = 50, [shortBreakTime] = 10, [longBreakTime] = 30}, .cycle = 3},
+    {.name = "Sprint", .durations = {[workTime] = 15, [shortBreakTime] = 3, [longBreakTime] = 15}, .cycle = 4},
+};
+
+_Static_assert(COUNT_OF(pomodoro_profiles_builtin) <= POMODORO_PROFILES_CAPACITY, "too many built-in profiles");
+
+/**
+ * @param header header read from the file
+ *
+ * @return true if the header belongs to the profiles
+ */
+static bool pomodoro_profiles_check(const void* header) {
+    const PomodoroProfilesHeader* profiles = header;
+    return profiles->magic == POMODORO_PROFILES_MAGIC && profiles->version == POMODORO_PROFILES_VERSION &&
+           profiles->count > 0 && profiles->count <= POMODORO_PROFILES_CAPACITY;
+}
+
+static const PomodoroProfilesHeader pomodoro_profiles_fresh = {
+    .magic = POMODORO_PROFILES_MAGIC,
+    .version = POMODORO_PROFILES_VERSION,
+    .count = COUNT_OF(pomodoro_profiles_builtin),
+    .current = 0,
+};
+
+static const PomodoroRecordsLayout pomodoro_profiles_layout = {
+    .path = POMODORO_PROFILES_PATH,
+    .header_size = sizeof(PomodoroProfilesHeader),
+    .record_size = sizeof(PomodoroProfile),
+    .check = pomodoro_profiles_check,
+    .fresh = &pomodoro_profiles_fresh,
+    .initial = pomodoro_profiles_builtin,
+    .initial_count = COUNT_OF(pomodoro_profiles_builtin),
+    .count = POMODORO_PROFILES_CAPACITY,
+};
+
+/**
+ * @param profile profile to compare
+ * @param pomodoro settings to compare
+ *
+ * @return true if the profile has the times of the settings
+ */
+static bool pomodoro_profiles_equal(const PomodoroProfile* profile, const Pomodoro* pomodoro) {
+    return memcmp(profile->durations, pomodoro->durations, sizeof(profile->durations)) == 0 &&
+           profile->cycle == pomodoro->cycle;
+}
+
+/**
+ * Starts a new file on the built-in profile with the times of the settings, settings that match none of them, like
+ * the ones of a config from before the profiles, are kept in a profile of their own
+ *
+ * @param profiles profiles of a new file
+ * @param settings settings of the config
+ */
+static void pomodoro_profiles_adopt(PomodoroProfiles* profiles, const Pomodoro* settings) {
+    for(uint8_t i = 0; i < COUNT_OF(pomodoro_profiles_builtin); i++) {
+        if(pomodoro_profiles_equal(&pomodoro_profiles_builtin[i], settings)) {
+            pomodoro_profiles_select(profiles, i);
+            return;
+        }
+    }
+    pomodoro_profiles_create(profiles, POMODORO_PROFILES_SAVED, settings);
+}
+
+/**
+ * Writes a record and the header after it, run by the writer. The header is only written once the record is, so a
+ * new profile only counts in the file if it was written.
+ *
+ * @param ctx profiles the change belongs to
+ * @param data PomodoroProfilesWrite
+ *
+ * @return true if the change was written
+ */
+static bool pomodoro_profiles_write(void* ctx, const void* data) {
+    PomodoroProfiles* profiles = ctx;
+    const PomodoroProfilesWrite* write = data;
+    bool success = write->index == POMODORO_PROFILES_NONE ||
+                   pomodoro_records_write(&profiles->records, write->index, &write->profile, 1);
+    if(success && write->write_header) success = pomodoro_records_write_header(&profiles->records, &write->header);
+    pomodoro_records_sync(&profiles->records);
+    return success;
+}
+
+/**
+ * Hands a changed record and the header to the writer
+ *
+ * @param profiles profiles that changed
+ * @param index index of the changed record, POMODORO_PROFILES_NONE for none
+ * @param write_header true if the header changed
+ *
+ * @return true if the change was written or is queued
+ */
+static bool pomodoro_profiles_queue(PomodoroProfiles* profiles, uint8_t index, bool write_header) {
+    PomodoroProfilesWrite write = {.header = profiles->header, .index = index, .write_header = write_header};
+    if(index != POMODORO_PROFILES_NONE) write.profile = profiles->profiles[index];
+    return pomodoro_file_queue(pomodoro_profiles_write, profiles, &write, sizeof(write));
+}
+
+/**
+ * Opens the profiles and reads all of their records in one go. A missing file is not touched, the built-in profiles
+ * are taken from memory and the file is created with them by the first change.
+ *
+ * @param settings settings of the config, a new file starts on the profile with their times, may be NULL
+ *
+ * @return profiles, NULL if the file can not be read
+ */
+PomodoroProfiles* pomodoro_profiles_alloc(const Pomodoro* settings) {
+    PomodoroProfiles* profiles = APP_INSTANCE_ALLOC(PomodoroProfiles);
+    pomodoro_records_open(&profiles->records, &pomodoro_profiles_layout, &profiles->header);
+    if(profiles->header.current >= profiles->header.count) profiles->header.current = 0;
+    if(!pomodoro_records_read(&profiles->records, 0, profiles->profiles, profiles->header.count)) {
+        pomodoro_profiles_free(profiles);
+        return NULL;
+    }
+    for(uint8_t i = 0; i < profiles->header.count; i++) {
+        profiles->profiles[i].name[POMODORO_PROFILES_NAME - 1] = '\0';
+    }
+    if(profiles->records.fresh && settings) pomodoro_profiles_adopt(profiles, settings);
+    return profiles;
+}
+
+/**
+ * Closes the profiles file
+ *
+ * @param profiles profiles to be closed
+ */
+void pomodoro_profiles_free(PomodoroProfiles* profiles) {
+    furi_assert(profiles);
+    pomodoro_records_close(&profiles->records);
+    APP_INSTANCE_FREE(profiles);
+}
+
+/**
+ * @param profiles profiles to look at
+ *
+ * @return number of profiles
+ */
+uint8_t pomodoro_profiles_count(const PomodoroProfiles* profiles) {
+    furi_assert(profiles);
+    return profiles->header.count;
+}
+
+/**
+ * @param profiles profiles to look at
+ *
+ * @return index of the profile chosen last
+ */
+uint8_t pomodoro_profiles_index(const PomodoroProfiles* profiles) {
+    furi_assert(profiles);
+    return profiles->header.current;
+}
+
+/**
+ * @param profiles profiles to look at
+ *
+ * @return profile chosen last
+ */
+const PomodoroProfile* pomodoro_profiles_current(const PomodoroProfiles* profiles) {
+    furi_assert(profiles);
+    return &profiles->profiles[profiles->header.current];
+}
+
+/**
+ * Makes a profile the current one. It is taken from memory, the writer writes the header with the current index.
+ *
+ * @param profiles profiles to choose from
+ * @param index index of the profile
+ *
+ * @return true if the profile is the current one, the current one is kept otherwise
+ */
+bool pomodoro_profiles_select(PomodoroProfiles* profiles, uint8_t index) {
+    furi_assert(profiles);
+    if(index >= profiles->header.count) return false;
+    if(index == profiles->header.current) return true;
+
+    profiles->header.current = index;
+    //if the header is not written, the next start shows the profile chosen before
+    pomodoro_profiles_queue(profiles, POMODORO_PROFILES_NONE, true);
+    return true;
+}
+
+/**
+ * Stores the times of the settings in the current profile, only if they differ from it
+ *
+ * @param profiles profiles to store to
+ * @param pomodoro settings to store in the current profile
+ *
+ * @return true if the profile is up to date or queued
+ */
+bool pomodoro_profiles_store(PomodoroProfiles* profiles, const Pomodoro* pomodoro) {
+    furi_assert(profiles);
+    PomodoroProfile* current = &profiles->profiles[profiles->header.current];
+    if(pomodoro_profiles_equal(current, pomodoro)) return true;
+
+    memcpy(current->durations, pomodoro->durations, sizeof(current->durations));
+    current->cycle = pomodoro->cycle;
+    return pomodoro_profiles_queue(profiles, profiles->header.current, false);
+}
+
+/**
+ * Adds a new profile as the next record and makes it the current one
+ *
+ * @param profiles profiles to add to
+ * @param name name of the profile, cut to POMODORO_PROFILES_NAME - 1 characters
+ * @param pomodoro settings of the profile
+ *
+ * @return index of the profile, which is the current one, POMODORO_PROFILES_NONE if it was not added
+ */
+uint8_t pomodoro_profiles_create(PomodoroProfiles* profiles, const char* name, const Pomodoro* pomodoro) {
+    furi_assert(profiles);
+    PomodoroProfilesHeader* header = &profiles->header;
+    if(header->count >= POMODORO_PROFILES_CAPACITY) return POMODORO_PROFILES_NONE;
+
+    const uint8_t index = header->count;
+    PomodoroProfile* profile = &profiles->profiles[index];
+    memset(profile, 0, sizeof(PomodoroProfile));
+    strlcpy(profile->name, name, sizeof(profile->name));
+    memcpy(profile->durations, pomodoro->durations, sizeof(profile->durations));
+    profile->cycle = pomodoro->cycle;
+    header->count++;
+    header->current = index;
+    pomodoro_profiles_queue(profiles, index, true);
+    return index;
+}
+
+/**
+ * Renames the current profile, the writer writes its record
+ *
+ * @param profiles profiles to change
+ * @param name new name of the current profile, cut to POMODORO_PROFILES_NAME - 1 characters
+ *
+ * @return true if the profile was written or is queued
+ */
+bool pomodoro_profiles_rename(PomodoroProfiles* profiles, const char* name) {
+    furi_assert(profiles);
+    PomodoroProfile* current = &profiles->profiles[profiles->header.current];
+    strlcpy(current->name, name, sizeof(current->name));
+    return pomodoro_profiles_queue(profiles, profiles->header.current, false);
+}
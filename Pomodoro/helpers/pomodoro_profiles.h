@@ -0,0 +1,112 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_profiles.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Named sets of interval times, such as deep work or study, kept as records of a fixed size
+//                   behind a small header. The records are read in one go when the profiles are opened, so
+//                   switching only changes memory, and each change is written by the writer with one seek. New
+//                   profiles take the next record, the file is created with all of them.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "pomodoro_types.h"
+#include "pomodoro_file_access.h"
+
+#define POMODORO_PROFILES_PATH POMODORO_FILE_DIR_PATH "/pomodoro.profiles"
+#define POMODORO_PROFILES_MAGIC 0x52504D50
+#define POMODORO_PROFILES_VERSION 1
+#define POMODORO_PROFILES_CAPACITY 128
+#define POMODORO_PROFILES_NAME 16
+//index of no profile
+#define POMODORO_PROFILES_NONE UINT8_MAX
+//name of the profile a new file gets for settings that match no built-in profile
+#define POMODORO_PROFILES_SAVED "Saved"
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t count; //profiles in the file
+    uint8_t current; //profile chosen last
+} PomodoroProfilesHeader;
+
+typedef struct {
+    char name[POMODORO_PROFILES_NAME];
+    uint32_t durations[PomodoroStateCount]; //minutes of each interval
+    uint32_t cycle; //work intervals before the long break
+} PomodoroProfile;
+
+_Static_assert(sizeof(PomodoroProfilesHeader) == 8, "profiles header must not contain padding");
+_Static_assert(sizeof(PomodoroProfile) == 32, "profile must not contain padding");
+
+typedef struct PomodoroProfiles PomodoroProfiles;
+
+/**
+ * Opens the profiles and reads all of their records in one go. A missing file is not touched, the built-in profiles
+ * are taken from memory and the file is created with them by the first change.
+ *
+ * @param settings settings of the config, a new file starts on the profile with their times, may be NULL
+ *
+ * @return profiles, NULL if the file can not be read
+ */
+ PomodoroProfiles* pomodoro_profiles_alloc(const Pomodoro* settings);
+
+/**
+ * @param profiles profiles to be closed
+ */
+ void pomodoro_profiles_free(PomodoroProfiles* profiles);
+
+/**
+ * @param profiles profiles to look at
+ *
+ * @return number of profiles
+ */
+ uint8_t pomodoro_profiles_count(const PomodoroProfiles* profiles);
+
+/**
+ * @param profiles profiles to look at
+ *
+ * @return index of the profile chosen last
+ */
+ uint8_t pomodoro_profiles_index(const PomodoroProfiles* profiles);
+
+/**
+ * @param profiles profiles to look at
+ *
+ * @return profile chosen last
+ */
+ const PomodoroProfile* pomodoro_profiles_current(const PomodoroProfiles* profiles);
+
+/**
+ * @param profiles profiles to choose from
+ * @param index index of the profile
+ *
+ * @return true if the profile is the current one, the current one is kept otherwise
+ */
+ bool pomodoro_profiles_select(PomodoroProfiles* profiles, uint8_t index);
+
+/**
+ * @param profiles profiles to store to
+ * @param pomodoro settings to store in the current profile
+ *
+ * @return true if the profile is up to date or queued
+ */
+ bool pomodoro_profiles_store(PomodoroProfiles* profiles, const Pomodoro* pomodoro);
+
+/**
+ * @param profiles profiles to add to
+ * @param name name of the profile, cut to POMODORO_PROFILES_NAME - 1 characters
+ * @param pomodoro settings of the profile
+ *
+ * @return index of the profile, which is the current one, POMODORO_PROFILES_NONE if it was not added
+ */
+ uint8_t pomodoro_profiles_create(PomodoroProfiles* profiles, const char* name, const Pomodoro* pomodoro);
+
+/**
+ * @param profiles profiles to change
+ * @param name new name of the current profile, cut to POMODORO_PROFILES_NAME - 1 characters
+ *
+ * @return true if the profile was written or is queued
+ */
+ bool pomodoro_profiles_rename(PomodoroProfiles* profiles, const char* name);
@@ -0,0 +1,190 @@
+//------------------------------------------------------------------
+// pomodoro_records.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_records.h"
+#include "pomodoro_file_access.h"
+
+/**
+ * @param records records to look at
+ * @param index index of the record
+ *
+ * @return offset of the record in the file
+ */
+static uint32_t pomodoro_records_offset(const PomodoroRecords* records, uint16_t index) {
+    return records->layout->header_size + (uint32_t)index * records->layout->record_size;
+}
+
+/**
+ * Creates the file with the fresh header and all records of a new file, called with the lock held by the first
+ * write
+ *
+ * @param records records to create the file for
+ *
+ * @return true if the file was created
+ */
+static bool pomodoro_records_create(PomodoroRecords* records) {
+    const PomodoroRecordsLayout* layout = records->layout;
+    storage_simply_mkdir(records->storage, POMODORO_FILE_DIR_PATH);
+    if(!storage_file_open(records->file, layout->path, FSAM_READ | FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+       storage_file_write(records->file, layout->fresh, layout->header_size) != layout->header_size) {
+        storage_file_close(records->file);
+        return false;
+    }
+
+    const uint32_t initial = (uint32_t)layout->initial_count * layout->record_size;
+    bool success = !initial || storage_file_write(records->file, layout->initial, initial) == initial;
+
+    const uint32_t size = (uint32_t)(layout->count - layout->initial_count) * layout->record_size;
+    const uint8_t empty[64] = {0};
+    for(uint32_t written = 0; success && written < size; written += sizeof(empty)) {
+        const uint16_t chunk = MIN(sizeof(empty), size - written);
+        success = storage_file_write(records->file, empty, chunk) == chunk;
+    }
+    success = success && storage_file_sync(records->file);
+    //a file cut short is created again by the next write
+    if(!success) storage_file_close(records->file);
+    records->fresh = !success;
+    return success;
+}
+
+/**
+ * Fills records of a file that was not created yet with the ones of a new file
+ *
+ * @param records records to read from
+ * @param index index of the first record
+ * @param data buffer for the records
+ * @param count number of consecutive records
+ */
+static void pomodoro_records_read_fresh(PomodoroRecords* records, uint16_t index, void* data, uint16_t count) {
+    const PomodoroRecordsLayout* layout = records->layout;
+    const uint16_t size = layout->record_size;
+    uint8_t* record = data;
+    for(uint16_t i = index; i < index + count; i++, record += size) {
+        if(i < layout->initial_count) {
+            memcpy(record, (const uint8_t*)layout->initial + (uint32_t)i * size, size);
+        } else {
+            memset(record, 0, size);
+        }
+    }
+}
+
+/**
+ * Opens the file and reads its header, the file is created by the first write if it is missing or rejected
+ *
+ * @param records records to open
+ * @param layout layout of the file
+ * @param header filled with the header of the file, or the fresh one
+ */
+void pomodoro_records_open(PomodoroRecords* records, const PomodoroRecordsLayout* layout, void* header) {
+    furi_assert(records);
+    records->layout = layout;
+    records->storage = furi_record_open(RECORD_STORAGE);
+    records->file = storage_file_alloc(records->storage);
+    records->lock = furi_mutex_alloc(FuriMutexTypeNormal);
+
+    const bool opened = storage_file_open(records->file, layout->path, FSAM_READ | FSAM_WRITE, FSOM_OPEN_EXISTING) &&
+                        storage_file_read(records->file, header, layout->header_size) == layout->header_size &&
+                        layout->check(header);
+    records->fresh = !opened;
+    if(!opened) {
+        storage_file_close(records->file);
+        memcpy(header, layout->fresh, layout->header_size);
+    }
+}
+
+/**
+ * Closes the file and the storage
+ *
+ * @param records records to be closed
+ */
+void pomodoro_records_close(PomodoroRecords* records) {
+    furi_assert(records);
+    storage_file_close(records->file);
+    storage_file_free(records->file);
+    furi_mutex_free(records->lock);
+    furi_record_close(RECORD_STORAGE);
+}
+
+/**
+ * Writes a header to the start of the file, creating the file first if it is fresh
+ *
+ * @param records records to write the header of
+ * @param header header to write, a copy the owner made when it queued the write
+ *
+ * @return true if the header was written
+ */
+bool pomodoro_records_write_header(PomodoroRecords* records, const void* header) {
+    furi_assert(records);
+    const uint16_t size = records->layout->header_size;
+    furi_mutex_acquire(records->lock, FuriWaitForever);
+    const bool success = (!records->fresh || pomodoro_records_create(records)) &&
+                         storage_file_seek(records->file, 0, true) &&
+                         storage_file_write(records->file, header, size) == size;
+    furi_mutex_release(records->lock);
+    return success;
+}
+
+/**
+ * Reads consecutive records with a single seek and read, the ones of a new file while it is fresh
+ *
+ * @param records records to read from
+ * @param index index of the first record
+ * @param data buffer for the records
+ * @param count number of consecutive records
+ *
+ * @return true if all records were read
+ */
+bool pomodoro_records_read(PomodoroRecords* records, uint16_t index, void* data, uint16_t count) {
+    furi_assert(records);
+    const uint32_t size = (uint32_t)count * records->layout->record_size;
+    furi_mutex_acquire(records->lock, FuriWaitForever);
+    bool success = true;
+    if(records->fresh) {
+        pomodoro_records_read_fresh(records, index, data, count);
+    } else {
+        success = storage_file_seek(records->file, pomodoro_records_offset(records, index), true) &&
+                  storage_file_read(records->file, data, size) == size;
+    }
+    furi_mutex_release(records->lock);
+    return success;
+}
+
+/**
+ * Writes consecutive records with a single seek and write, creating the file first if it is fresh
+ *
+ * @param records records to write to
+ * @param index index of the first record
+ * @param data records to write
+ * @param count number of consecutive records
+ *
+ * @return true if all records were written
+ */
+bool pomodoro_records_write(PomodoroRecords* records, uint16_t index, const void* data, uint16_t count) {
+    furi_assert(records);
+    const uint32_t size = (uint32_t)count * records->layout->record_size;
+    furi_mutex_acquire(records->lock, FuriWaitForever);
+    const bool success = (!records->fresh || pomodoro_records_create(records)) &&
+                         storage_file_seek(records->file, pomodoro_records_offset(records, index), true) &&
+                         storage_file_write(records->file, data, size) == size;
+    furi_mutex_release(records->lock);
+    return success;
+}
+
+/**
+ * Syncs the file to the sd card
+ *
+ * @param records records to sync
+ *
+ * @return true if the file was synced
+ */
+bool pomodoro_records_sync(PomodoroRecords* records) {
+    furi_assert(records);
+    furi_mutex_acquire(records->lock, FuriWaitForever);
+    const bool success = !records->fresh && storage_file_sync(records->file);
+    furi_mutex_release(records->lock);
+    return success;
+}
@@ -0,0 +1,89 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_records.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      File of records of a fixed size behind a small header, shared by the history, the stats and
+//                   the profiles. The header is kept in memory by its owner, a record is read or written with one
+//                   seek, so each access takes the same time no matter where the record sits. A file is only created
+//                   by its first write.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <storage/storage.h>
+
+typedef bool (*PomodoroRecordsCheck)(const void* header);
+
+/**
+ * Layout of a records file, declared static const by its owner
+ */
+typedef struct {
+    const char* path;
+    uint16_t header_size;
+    uint16_t record_size;
+    PomodoroRecordsCheck check; //true if a header read from the file can be used
+    const void* fresh; //header of a new file
+    const void* initial; //first records of a new file, NULL for none
+    uint16_t initial_count; //records in initial
+    uint16_t count; //records of a new file, the ones after initial are zeroed
+} PomodoroRecordsLayout;
+
+typedef struct {
+    const PomodoroRecordsLayout* layout;
+    Storage* storage;
+    File* file;
+    FuriMutex* lock; //keeps a seek and the access after it together, the app reads while the writer writes
+    bool fresh; //the file is missing or was rejected, it is created with the first write, guarded by lock
+} PomodoroRecords;
+
+/**
+ * Opens the file and reads its header. A missing file or one the check rejects gets the fresh header without
+ * touching storage, the records read as the ones of a new file, and it is created again with all records by the
+ * first write, so it never grows afterwards.
+ *
+ * @param records records to open
+ * @param layout layout of the file
+ * @param header filled with the header of the file, or the fresh one
+ */
+ void pomodoro_records_open(PomodoroRecords* records, const PomodoroRecordsLayout* layout, void* header);
+
+/**
+ * @param records records to be closed
+ */
+ void pomodoro_records_close(PomodoroRecords* records);
+
+/**
+ * @param records records to write the header of
+ * @param header header to write, a copy the owner made when it queued the write
+ *
+ * @return true if the header was written
+ */
+ bool pomodoro_records_write_header(PomodoroRecords* records, const void* header);
+
+/**
+ * @param records records to read from
+ * @param index index of the first record
+ * @param data buffer for the records
+ * @param count number of consecutive records
+ *
+ * @return true if all records were read
+ */
+ bool pomodoro_records_read(PomodoroRecords* records, uint16_t index, void* data, uint16_t count);
+
+/**
+ * @param records records to write to
+ * @param index index of the first record
+ * @param data records to write
+ * @param count number of consecutive records
+ *
+ * @return true if all records were written
+ */
+ bool pomodoro_records_write(PomodoroRecords* records, uint16_t index, const void* data, uint16_t count);
+
+/**
+ * @param records records to sync
+ *
+ * @return true if the file was synced
+ */
+ bool pomodoro_records_sync(PomodoroRecords* records);
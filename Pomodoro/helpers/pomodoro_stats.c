@@ -0,0 +1,217 @@
+//------------------------------------------------------------------
+// pomodoro_stats.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_stats.h"
+#include "pomodoro_records.h"
+#include "../../common/app_arena.h"
+
+struct PomodoroStats {
+    PomodoroRecords records;
+    PomodoroStatsHeader header;
+};
+
+APP_INSTANCE_DEFINE(PomodoroStats);
+
+/**
+ * @param stats stats to look at
+ * @param week false for the bucket of a day, true for the bucket of a week
+ * @param index day or week
+ *
+ * @return slot of the bucket in the file, the days come first
+ */
+static uint16_t pomodoro_stats_slot(const PomodoroStats* stats, bool week, uint32_t index) {
+    return week ? stats->header.days + index % stats->header.weeks : index % stats->header.days;
+}
+
+/**
+ * @param header header read from the file
+ *
+ * @return true if the header belongs to stats with the days and weeks of this build, the buckets of a file with
+ * others would sit at the wrong slots
+ */
+static bool pomodoro_stats_check(const void* header) {
+    const PomodoroStatsHeader* stats = header;
+    return stats->magic == POMODORO_STATS_MAGIC && stats->version == POMODORO_STATS_VERSION &&
+           stats->days == POMODORO_STATS_DAYS && stats->weeks == POMODORO_STATS_WEEKS;
+}
+
+static const PomodoroStatsHeader pomodoro_stats_fresh = {
+    .magic = POMODORO_STATS_MAGIC,
+    .version = POMODORO_STATS_VERSION,
+    .days = POMODORO_STATS_DAYS,
+    .weeks = POMODORO_STATS_WEEKS,
+};
+
+//an index of 0 never matches a day of use, so the zeroed buckets of a new file read as reused
+static const PomodoroRecordsLayout pomodoro_stats_layout = {
+    .path = POMODORO_STATS_PATH,
+    .header_size = sizeof(PomodoroStatsHeader),
+    .record_size = sizeof(PomodoroStatsBucket),
+    .check = pomodoro_stats_check,
+    .fresh = &pomodoro_stats_fresh,
+    .count = POMODORO_STATS_DAYS + POMODORO_STATS_WEEKS,
+};
+
+/**
+ * Reads the bucket of a day or week, a bucket that holds another day or week is returned empty
+ *
+ * @param stats stats to read from
+ * @param week false for a day, true for a week
+ * @param index day or week
+ * @param bucket bucket to be filled
+ *
+ * @return true if the bucket was read
+ */
+static bool pomodoro_stats_read(PomodoroStats* stats, bool week, uint32_t index, PomodoroStatsBucket* bucket) {
+    if(!pomodoro_records_read(&stats->records, pomodoro_stats_slot(stats, week, index), bucket, 1)) return false;
+    if(bucket->index != index) *bucket = (PomodoroStatsBucket){.index = index};
+    return true;
+}
+
+/**
+ * Adds an interval to the bucket of a day or week, one read and one write
+ *
+ * @param stats stats to add to
+ * @param week false for a day, true for a week
+ * @param index day or week
+ * @param seconds seconds the interval was running
+ *
+ * @return true if the bucket was written
+ */
+static bool pomodoro_stats_add_bucket(PomodoroStats* stats, bool week, uint32_t index, uint32_t seconds) {
+    PomodoroStatsBucket bucket;
+    if(!pomodoro_stats_read(stats, week, index, &bucket)) return false;
+    bucket.seconds += seconds;
+    if(bucket.sessions < UINT16_MAX) bucket.sessions++;
+    return pomodoro_records_write(&stats->records, pomodoro_stats_slot(stats, week, index), &bucket, 1);
+}
+
+/**
+ * Opens the stats without touching storage if the file is missing, it is created with all buckets by the first
+ * interval
+ *
+ * @return stats
+ */
+PomodoroStats* pomodoro_stats_alloc(void) {
+    PomodoroStats* stats = APP_INSTANCE_ALLOC(PomodoroStats);
+    pomodoro_records_open(&stats->records, &pomodoro_stats_layout, &stats->header);
+    return stats;
+}
+
+/**
+ * Closes the stats file
+ *
+ * @param stats stats to be closed
+ */
+void pomodoro_stats_free(PomodoroStats* stats) {
+    furi_assert(stats);
+    pomodoro_records_close(&stats->records);
+    APP_INSTANCE_FREE(stats);
+}
+
+/**
+ * Interval handed to the writer together with the header it results in
+ */
+typedef struct {
+    PomodoroStatsHeader header;
+    uint32_t day;
+    uint32_t seconds;
+} PomodoroStatsWrite;
+
+_Static_assert(sizeof(PomodoroStatsWrite) <= POMODORO_FILE_JOB_DATA, "stats write must fit a job");
+
+/**
+ * Adds an interval to the buckets of its day and week and writes the header after them, run by the writer
+ *
+ * @param ctx stats the interval belongs to
+ * @param data PomodoroStatsWrite
+ *
+ * @return true if the buckets and the header were written
+ */
+static bool pomodoro_stats_write(void* ctx, const void* data) {
+    PomodoroStats* stats = ctx;
+    const PomodoroStatsWrite* write = data;
+    bool success = pomodoro_stats_add_bucket(stats, false, write->day, write->seconds) &&
+                   pomodoro_stats_add_bucket(stats, true, pomodoro_stats_week(write->day), write->seconds);
+    //if the header is not written, the totals are behind the buckets until the next interval
+    success = pomodoro_records_write_header(&stats->records, &write->header) && success;
+    pomodoro_records_sync(&stats->records);
+    return success;
+}
+
+/**
+ * Adds a finished work interval to the totals and the streak in memory, its day and its week are updated by the
+ * writer
+ *
+ * @param stats stats to add the interval to
+ * @param timestamp unix timestamp the interval was finished at
+ * @param seconds seconds the interval was running
+ *
+ * @return true if the buckets were written or are queued
+ */
+bool pomodoro_stats_add(PomodoroStats* stats, uint32_t timestamp, uint32_t seconds) {
+    furi_assert(stats);
+    const uint32_t day = pomodoro_stats_day(timestamp);
+    PomodoroStatsHeader* header = &stats->header;
+    header->sessions++;
+    header->seconds += seconds;
+    if(day != header->last_day) {
+        header->streak = day == header->last_day + 1 ? header->streak + 1 : 1;
+        header->last_day = day;
+    }
+    if(header->streak > header->best_streak) header->best_streak = header->streak;
+
+    const PomodoroStatsWrite write = {.header = *header, .day = day, .seconds = seconds};
+    return pomodoro_file_queue(pomodoro_stats_write, stats, &write, sizeof(write));
+}
+
+/**
+ * @param stats stats to look at
+ *
+ * @return totals and streak as of the last finished work interval
+ */
+const PomodoroStatsHeader* pomodoro_stats_totals(const PomodoroStats* stats) {
+    furi_assert(stats);
+    return &stats->header;
+}
+
+/**
+ * @param stats stats to look at
+ * @param today current day
+ *
+ * @return days in a row with a finished work interval, 0 if neither today nor yesterday had one
+ */
+uint16_t pomodoro_stats_streak(const PomodoroStats* stats, uint32_t today) {
+    furi_assert(stats);
+    //the streak of yesterday still holds until today is over
+    if(stats->header.last_day + 1 < today) return 0;
+    return stats->header.streak;
+}
+
+/**
+ * @param stats stats to read from
+ * @param day day to read
+ * @param bucket bucket of the day, empty if it was reused or never written
+ *
+ * @return true if the bucket was read
+ */
+bool pomodoro_stats_read_day(PomodoroStats* stats, uint32_t day, PomodoroStatsBucket* bucket) {
+    furi_assert(stats);
+    return pomodoro_stats_read(stats, false, day, bucket);
+}
+
+/**
+ * @param stats stats to read from
+ * @param week week to read
+ * @param bucket bucket of the week, empty if it was reused or never written
+ *
+ * @return true if the bucket was read
+ */
+bool pomodoro_stats_read_week(PomodoroStats* stats, uint32_t week, PomodoroStatsBucket* bucket) {
+    furi_assert(stats);
+    return pomodoro_stats_read(stats, true, week, bucket);
+}
@@ -0,0 +1,119 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_stats.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Daily and weekly rollups of the finished work intervals, together with the totals and the
+//                   streak. Each bucket sits at a fixed slot of the file given by its day or week, so updating
+//                   and reading one takes the same time no matter how long the app has been used.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "pomodoro_types.h"
+#include "pomodoro_file_access.h"
+
+#define POMODORO_STATS_PATH POMODORO_FILE_DIR_PATH "/pomodoro.stats"
+#define POMODORO_STATS_MAGIC 0x534D4F50
+#define POMODORO_STATS_VERSION 1
+//days and weeks kept before a bucket is reused
+#define POMODORO_STATS_DAYS 64
+#define POMODORO_STATS_WEEKS 64
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t days;
+    uint8_t weeks;
+    uint32_t sessions; //work intervals finished in total
+    uint32_t seconds; //seconds of all finished work intervals
+    uint32_t last_day; //day of the last finished work interval
+    uint16_t streak; //days in a row up to last_day with a finished work interval
+    uint16_t best_streak;
+} PomodoroStatsHeader;
+
+typedef struct {
+    uint32_t index; //day or week the bucket holds, counted from the unix epoch
+    uint32_t seconds; //seconds of the finished work intervals
+    uint16_t sessions; //finished work intervals
+    uint16_t reserved;
+} PomodoroStatsBucket;
+
+_Static_assert(sizeof(PomodoroStatsHeader) == 24, "stats header must not contain padding");
+_Static_assert(sizeof(PomodoroStatsBucket) == 12, "stats bucket must not contain padding");
+
+typedef struct PomodoroStats PomodoroStats;
+
+/**
+ * @param timestamp unix timestamp
+ *
+ * @return day of the timestamp
+ */
+static inline uint32_t pomodoro_stats_day(uint32_t timestamp) {
+    return timestamp / (24 * 60 * 60);
+}
+
+/**
+ * @param day day counted from the unix epoch
+ *
+ * @return week of the day, weeks start on monday
+ */
+static inline uint32_t pomodoro_stats_week(uint32_t day) {
+    //the epoch was a thursday
+    return (day + 3) / 7;
+}
+
+/**
+ * Opens the stats without touching storage if the file is missing, it is created with all buckets by the first
+ * interval
+ *
+ * @return stats
+ */
+ PomodoroStats* pomodoro_stats_alloc(void);
+
+/**
+ * @param stats stats to be closed
+ */
+ void pomodoro_stats_free(PomodoroStats* stats);
+
+/**
+ * @param stats stats to add the interval to
+ * @param timestamp unix timestamp the interval was finished at
+ * @param seconds seconds the interval was running
+ *
+ * @return true if the buckets were written or are queued
+ */
+ bool pomodoro_stats_add(PomodoroStats* stats, uint32_t timestamp, uint32_t seconds);
+
+/**
+ * @param stats stats to look at
+ *
+ * @return totals and streak as of the last finished work interval
+ */
+ const PomodoroStatsHeader* pomodoro_stats_totals(const PomodoroStats* stats);
+
+/**
+ * @param stats stats to look at
+ * @param today current day
+ *
+ * @return days in a row with a finished work interval, 0 if neither today nor yesterday had one
+ */
+ uint16_t pomodoro_stats_streak(const PomodoroStats* stats, uint32_t today);
+
+/**
+ * @param stats stats to read from
+ * @param day day to read
+ * @param bucket bucket of the day, empty if it was reused or never written
+ *
+ * @return true if the bucket was read
+ */
+ bool pomodoro_stats_read_day(PomodoroStats* stats, uint32_t day, PomodoroStatsBucket* bucket);
+
+/**
+ * @param stats stats to read from
+ * @param week week to read
+ * @param bucket bucket of the week, empty if it was reused or never written
+ *
+ * @return true if the bucket was read
+ */
+ bool pomodoro_stats_read_week(PomodoroStats* stats, uint32_t week, PomodoroStatsBucket* bucket);
@@ -0,0 +1,325 @@
+//------------------------------------------------------------------
+// pomodoro_timers.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "pomodoro_timers.h"
+#include "pomodoro_records.h"
+#include "../../common/app_arena.h"
+
+struct PomodoroTimers {
+    bool persistent;
+    bool queued; //a flush is waiting for the writer, guarded by the file lock like dirty
+    PomodoroRecords records; //open while persistent
+    PomodoroTimersHeader header;
+    uint32_t dirty[POMODORO_TIMERS_CAPACITY / 32]; //ids whose record differs from the file
+    uint16_t count; //timers in the heap
+    uint16_t free_count; //ids on the free stack
+    PomodoroTimer slots[POMODORO_TIMERS_CAPACITY]; //timers by id, an unused id is zeroed as its record
+    uint16_t heap[POMODORO_TIMERS_CAPACITY]; //ids of the running timers, earliest deadline first
+    uint16_t position[POMODORO_TIMERS_CAPACITY]; //index in the heap of each id, POMODORO_TIMERS_NONE if unused
+    uint16_t free[POMODORO_TIMERS_CAPACITY]; //ids that are not used
+};
+
+APP_INSTANCE_DEFINE(PomodoroTimers);
+
+/**
+ * Swaps two entries of the heap and updates their positions
+ *
+ * @param timers timers to change
+ * @param a index in the heap
+ * @param b index in the heap
+ */
+static void pomodoro_timers_swap(PomodoroTimers* timers, uint16_t a, uint16_t b) {
+    const uint16_t id = timers->heap[a];
+    timers->heap[a] = timers->heap[b];
+    timers->heap[b] = id;
+    timers->position[timers->heap[a]] = a;
+    timers->position[timers->heap[b]] = b;
+}
+
+/**
+ * @param timers timers to look at
+ * @param a index in the heap
+ * @param b index in the heap
+ *
+ * @return true if the timer at a is up before the one at b
+ */
+static bool pomodoro_timers_before(const PomodoroTimers* timers, uint16_t a, uint16_t b) {
+    return timers->slots[timers->heap[a]].deadline < timers->slots[timers->heap[b]].deadline;
+}
+
+/**
+ * Moves an entry up until its parent is not later than it
+ *
+ * @param timers timers to change
+ * @param index index in the heap
+ */
+static void pomodoro_timers_sift_up(PomodoroTimers* timers, uint16_t index) {
+    while(index > 0) {
+        const uint16_t parent = (index - 1) / 2;
+        if(!pomodoro_timers_before(timers, index, parent)) break;
+        pomodoro_timers_swap(timers, index, parent);
+        index = parent;
+    }
+}
+
+/**
+ * Moves an entry down until no child is earlier than it
+ *
+ * @param timers timers to change
+ * @param index index in the heap
+ */
+static void pomodoro_timers_sift_down(PomodoroTimers* timers, uint16_t index) {
+    for(;;) {
+        const uint16_t left = 2 * index + 1;
+        const uint16_t right = left + 1;
+        uint16_t earliest = index;
+        if(left < timers->count && pomodoro_timers_before(timers, left, earliest)) earliest = left;
+        if(right < timers->count && pomodoro_timers_before(timers, right, earliest)) earliest = right;
+        if(earliest == index) break;
+        pomodoro_timers_swap(timers, index, earliest);
+        index = earliest;
+    }
+}
+
+/**
+ * @param header header read from the file
+ *
+ * @return true if the header belongs to timers with one record per id
+ */
+static bool pomodoro_timers_check(const void* header) {
+    const PomodoroTimersHeader* timers = header;
+    return timers->magic == POMODORO_TIMERS_MAGIC && timers->version == POMODORO_TIMERS_VERSION &&
+           timers->capacity == POMODORO_TIMERS_CAPACITY;
+}
+
+static const PomodoroTimersHeader pomodoro_timers_fresh = {
+    .magic = POMODORO_TIMERS_MAGIC,
+    .version = POMODORO_TIMERS_VERSION,
+    .capacity = POMODORO_TIMERS_CAPACITY,
+};
+
+static const PomodoroRecordsLayout pomodoro_timers_layout = {
+    .path = POMODORO_TIMERS_PATH,
+    .header_size = sizeof(PomodoroTimersHeader),
+    .record_size = sizeof(PomodoroTimer),
+    .check = pomodoro_timers_check,
+    .fresh = &pomodoro_timers_fresh,
+    .count = POMODORO_TIMERS_CAPACITY,
+};
+
+/**
+ * Writes the records of the ids that changed since the last flush and syncs once, run by the writer. Each record is
+ * copied under the lock, so the app only waits for the copy.
+ *
+ * @param ctx timers to save
+ * @param data unused
+ *
+ * @return true if the records are up to date
+ */
+static bool pomodoro_timers_flush(void* ctx, const void* data) {
+    UNUSED(data);
+    PomodoroTimers* timers = ctx;
+    uint32_t dirty[COUNT_OF(timers->dirty)];
+    bool locked = pomodoro_file_lock();
+    timers->queued = false;
+    memcpy(dirty, timers->dirty, sizeof(dirty));
+    memset(timers->dirty, 0, sizeof(timers->dirty));
+    pomodoro_file_unlock(locked);
+
+    bool success = true;
+    bool written = false;
+    for(uint16_t id = 0; id < POMODORO_TIMERS_CAPACITY; id++) {
+        if(!(dirty[id / 32] & (1u << (id % 32)))) continue;
+        locked = pomodoro_file_lock();
+        const PomodoroTimer timer = timers->slots[id];
+        pomodoro_file_unlock(locked);
+        if(pomodoro_records_write(&timers->records, id, &timer, 1)) {
+            written = true;
+            continue;
+        }
+        //written with the next flush
+        locked = pomodoro_file_lock();
+        timers->dirty[id / 32] |= 1u << (id % 32);
+        pomodoro_file_unlock(locked);
+        success = false;
+    }
+    if(written) pomodoro_records_sync(&timers->records);
+    return success;
+}
+
+/**
+ * Changes the record of one id and marks it as dirty, the flush is handed to the writer unless one is still waiting
+ * to pick it up
+ *
+ * @param timers timers to change
+ * @param id id that changed
+ * @param timer new record of the id, zeroed for an unused id
+ */
+static void pomodoro_timers_set(PomodoroTimers* timers, uint16_t id, const PomodoroTimer* timer) {
+    const bool locked = pomodoro_file_lock();
+    timers->slots[id] = *timer;
+    bool queue = false;
+    if(timers->persistent) {
+        timers->dirty[id / 32] |= 1u << (id % 32);
+        queue = !timers->queued;
+        timers->queued = true;
+    }
+    pomodoro_file_unlock(locked);
+    if(queue) pomodoro_file_queue(pomodoro_timers_flush, timers, NULL, 0);
+}
+
+/**
+ * Creates the timers, loading the saved ones if they are persistent. Each saved timer keeps its id, the heap is
+ * built from the records in one pass.
+ *
+ * @param persistent true to load the timers from the file and save every change to it
+ *
+ * @return timers
+ */
+PomodoroTimers* pomodoro_timers_alloc(bool persistent) {
+    PomodoroTimers* timers = APP_INSTANCE_ALLOC(PomodoroTimers);
+    memset(timers->slots, 0, sizeof(timers->slots));
+    memset(timers->dirty, 0, sizeof(timers->dirty));
+    timers->queued = false;
+    timers->persistent = persistent;
+    if(persistent) {
+        //a missing file reads as one without timers and is created by the first change
+        pomodoro_records_open(&timers->records, &pomodoro_timers_layout, &timers->header);
+        if(!pomodoro_records_read(&timers->records, 0, timers->slots, POMODORO_TIMERS_CAPACITY)) {
+            memset(timers->slots, 0, sizeof(timers->slots));
+        }
+    }
+
+    timers->count = 0;
+    timers->free_count = 0;
+    //handed out from the top of the free stack, so the lowest unused id is used first
+    for(uint16_t id = POMODORO_TIMERS_CAPACITY; id-- > 0;) {
+        timers->position[id] = POMODORO_TIMERS_NONE;
+        PomodoroTimer* timer = &timers->slots[id];
+        if(timer->deadline == 0) {
+            timers->free[timers->free_count++] = id;
+        } else {
+            timer->name[POMODORO_TIMERS_NAME - 1] = '\0';
+            timers->heap[timers->count] = id;
+            timers->position[id] = timers->count;
+            pomodoro_timers_sift_up(timers, timers->count++);
+        }
+    }
+    return timers;
+}
+
+/**
+ * @param timers timers to be freed
+ */
+void pomodoro_timers_free(PomodoroTimers* timers) {
+    furi_assert(timers);
+    if(timers->persistent) pomodoro_records_close(&timers->records);
+    APP_INSTANCE_FREE(timers);
+}
+
+/**
+ * Adds a timer in O(log n)
+ *
+ * @param timers timers to add to
+ * @param name name of the timer, cut to POMODORO_TIMERS_NAME - 1 characters
+ * @param deadline unix timestamp the timer is up at
+ *
+ * @return id of the timer, POMODORO_TIMERS_NONE if all timers are used
+ */
+uint16_t pomodoro_timers_add(PomodoroTimers* timers, const char* name, uint32_t deadline) {
+    furi_assert(timers);
+    if(timers->free_count == 0) return POMODORO_TIMERS_NONE;
+
+    const uint16_t id = timers->free[--timers->free_count];
+    //0 marks an unused id in the file
+    PomodoroTimer timer = {.deadline = MAX(deadline, 1u)};
+    strlcpy(timer.name, name, sizeof(timer.name));
+    pomodoro_timers_set(timers, id, &timer);
+
+    timers->heap[timers->count] = id;
+    timers->position[id] = timers->count;
+    pomodoro_timers_sift_up(timers, timers->count++);
+    return id;
+}
+
+/**
+ * Removes a timer in O(log n), the last entry of the heap takes its place
+ *
+ * @param timers timers to remove from
+ * @param id id of the timer
+ *
+ * @return true if the timer was running
+ */
+bool pomodoro_timers_cancel(PomodoroTimers* timers, uint16_t id) {
+    furi_assert(timers);
+    if(id >= POMODORO_TIMERS_CAPACITY || timers->position[id] == POMODORO_TIMERS_NONE) return false;
+
+    const uint16_t index = timers->position[id];
+    const uint16_t last = --timers->count;
+    if(index != last) {
+        pomodoro_timers_swap(timers, index, last);
+        //the moved timer may belong above or below the removed one
+        const uint16_t moved = timers->heap[index];
+        pomodoro_timers_sift_up(timers, index);
+        if(timers->position[moved] == index) pomodoro_timers_sift_down(timers, index);
+    }
+    timers->position[id] = POMODORO_TIMERS_NONE;
+    timers->free[timers->free_count++] = id;
+
+    const PomodoroTimer unused = {0};
+    pomodoro_timers_set(timers, id, &unused);
+    return true;
+}
+
+/**
+ * @param timers timers to look at
+ *
+ * @return id of the timer that is up next, POMODORO_TIMERS_NONE if there is none
+ */
+uint16_t pomodoro_timers_next(const PomodoroTimers* timers) {
+    furi_assert(timers);
+    return timers->count ? timers->heap[0] : POMODORO_TIMERS_NONE;
+}
+
+/**
+ * @param timers timers to look at
+ * @param id id of a running timer
+ *
+ * @return the timer
+ */
+const PomodoroTimer* pomodoro_timers_get(const PomodoroTimers* timers, uint16_t id) {
+    furi_assert(timers);
+    furi_assert(id < POMODORO_TIMERS_CAPACITY);
+    return &timers->slots[id];
+}
+
+/**
+ * @param timers timers to look at
+ *
+ * @return number of running timers
+ */
+uint16_t pomodoro_timers_count(const PomodoroTimers* timers) {
+    furi_assert(timers);
+    return timers->count;
+}
+
+/**
+ * Removes the earliest timer if it is up, to be called until it returns false
+ *
+ * @param timers timers to take the expired ones from
+ * @param now current unix timestamp
+ * @param expired timer that is up, may be NULL
+ *
+ * @return true if a timer was up, it is removed
+ */
+bool pomodoro_timers_expire(PomodoroTimers* timers, uint32_t now, PomodoroTimer* expired) {
+    furi_assert(timers);
+    const uint16_t id = pomodoro_timers_next(timers);
+    if(id == POMODORO_TIMERS_NONE || timers->slots[id].deadline > now) return false;
+    if(expired) *expired = timers->slots[id];
+    return pomodoro_timers_cancel(timers, id);
+}
@@ -0,0 +1,98 @@
+#pragma once
+//------------------------------------------------------------------
+// pomodoro_timers.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Named timers next to the run, like a tea timer or a meeting reminder, kept in a min heap by
+//                   deadline and saved to a file, so they keep running while the app is closed. The file holds one
+//                   record per id, a change marks the record of its timer and the writer writes the marked ones
+//                   with one sync.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "pomodoro_file_access.h"
+
+#define POMODORO_TIMERS_PATH POMODORO_FILE_DIR_PATH "/pomodoro.timers"
+#define POMODORO_TIMERS_MAGIC 0x524D5450
+#define POMODORO_TIMERS_VERSION 2
+#define POMODORO_TIMERS_CAPACITY 256
+#define POMODORO_TIMERS_NAME 16
+//id of no timer
+#define POMODORO_TIMERS_NONE UINT16_MAX
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t capacity; //records following the header, one per id
+} PomodoroTimersHeader;
+
+typedef struct {
+    uint32_t deadline; //unix timestamp the timer is up at, 0 for an unused id
+    char name[POMODORO_TIMERS_NAME];
+} PomodoroTimer;
+
+_Static_assert(sizeof(PomodoroTimersHeader) == 8, "timers header must not contain padding");
+_Static_assert(sizeof(PomodoroTimer) == 20, "timer must not contain padding");
+
+typedef struct PomodoroTimers PomodoroTimers;
+
+/**
+ * @param persistent true to load the timers from the file and save every change to it
+ *
+ * @return timers
+ */
+ PomodoroTimers* pomodoro_timers_alloc(bool persistent);
+
+/**
+ * @param timers timers to be freed
+ */
+ void pomodoro_timers_free(PomodoroTimers* timers);
+
+/**
+ * @param timers timers to add to
+ * @param name name of the timer, cut to POMODORO_TIMERS_NAME - 1 characters
+ * @param deadline unix timestamp the timer is up at
+ *
+ * @return id of the timer, POMODORO_TIMERS_NONE if all timers are used
+ */
+ uint16_t pomodoro_timers_add(PomodoroTimers* timers, const char* name, uint32_t deadline);
+
+/**
+ * @param timers timers to remove from
+ * @param id id of the timer
+ *
+ * @return true if the timer was running
+ */
+ bool pomodoro_timers_cancel(PomodoroTimers* timers, uint16_t id);
+
+/**
+ * @param timers timers to look at
+ *
+ * @return id of the timer that is up next, POMODORO_TIMERS_NONE if there is none
+ */
+ uint16_t pomodoro_timers_next(const PomodoroTimers* timers);
+
+/**
+ * @param timers timers to look at
+ * @param id id of a running timer
+ *
+ * @return the timer
+ */
+ const PomodoroTimer* pomodoro_timers_get(const PomodoroTimers* timers, uint16_t id);
+
+/**
+ * @param timers timers to look at
+ *
+ * @return number of running timers
+ */
+ uint16_t pomodoro_timers_count(const PomodoroTimers* timers);
+
+/**
+ * @param timers timers to take the expired ones from
+ * @param now current unix timestamp
+ * @param expired timer that is up, may be NULL
+ *
+ * @return true if a timer was up, it is removed
+ */
+ bool pomodoro_timers_expire(PomodoroTimers* timers, uint32_t now, PomodoroTimer* expired);
@@ -11,19 +11,22 @@ typedef enum {
     workTime = 0,
     shortBreakTime = 1,
     longBreakTime = 2,
+    PomodoroStateCount,
 } PomodoroState;
 
 //TODO use other int?
 typedef struct {
     uint32_t count;
-    uint32_t *endTime;
-    uint32_t workTime;
-    uint32_t shortBreakTime;
-    uint32_t longBreakTime;
+    uint32_t durations[PomodoroStateCount]; //minutes of each interval
+    uint32_t cycle; //work intervals before the long break
     uint32_t repetitions;
     uint32_t totalruns;
+    uint32_t runStart; //tick the run was started or resumed at
+    uint32_t runElapsed; //ticks the run was running before it was resumed the last time
+    uint32_t pauseStart; //tick the run was paused at
+    uint32_t pausedTime; //ticks the run was paused in total
     PomodoroState state;
+    PomodoroState selected; //interval shown and changed in the settings, the one of the run while running
     bool running;
     bool notification;
-    FuriMutex* mutex;
 } Pomodoro;
@@ -8,139 +8,1244 @@
 //-------------------------------------------------------------------
 
 #include <furi.h>
+#include <furi_hal.h>
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
-#include <notification/notification.h>
-#include <notification/notification_messages.h>
+#include <inttypes.h>
 #include "helpers/pomodoro_types.h"
 #include "helpers/pomodoro_file_access.h"
+#include "helpers/pomodoro_journal.h"
+#include "helpers/pomodoro_history.h"
+#include "helpers/pomodoro_timers.h"
+#include "helpers/pomodoro_stats.h"
+#include "helpers/pomodoro_alerts.h"
+#include "helpers/pomodoro_phase.h"
+#include "helpers/pomodoro_profiles.h"
+#include "../common/app_profile.h"
+#include "../common/app_backbuffer.h"
+#include "../common/app_snapshot.h"
+#include "../common/app_runtime.h"
+#include "../common/app_arena.h"
+#include "../common/app_crc32.h"
 
-typedef enum {
-    EventTypeTick,
-    EventTypeKey,
-} EventType;
+//keys pressed while the config loads that are handled once it is in
+#define POMODORO_DEFERRED 8
 
+/**
+ * Everything the worker loads from storage, handed to the loop with an AppEventTypeWorker
+ */
 typedef struct {
-    EventType type;
-    InputEvent input;
-} PomodoroEvent;
+    FuriThread* thread;
+    AppRuntime* runtime; //runtime to post to when done, NULL if the loop joins the worker itself
+    bool replaying; //a replay leaves the files of the app alone
+    Pomodoro values; //run and settings of the config file
+    PomodoroHistory* history;
+    PomodoroJournal* journal;
+    PomodoroTimers* timers;
+    PomodoroStats* stats;
+    PomodoroProfiles* profiles;
+    bool recovered; //record holds the run of the journal
+    PomodoroJournalRecord record;
+} PomodoroLoad;
 
 /**
- * Notification to be played once the timer is up
+ * Statistics shown on the stats screen, read from the buckets when it is opened or paged
  */
-const NotificationSequence time_up = {
-    &message_vibro_on,
-    &message_blue_255,
+typedef struct {
+    uint32_t today_seconds;
+    uint16_t today_sessions;
+    uint8_t weeks_back; //week shown, 0 for this week
+    uint32_t week_seconds;
+    uint16_t week_sessions;
+    uint16_t streak;
+    uint16_t best_streak;
+    uint32_t average; //seconds per work interval
+    uint32_t sessions;
+} PomodoroStatsFrame;
 
-    &message_note_ds4,
-    &message_delay_100,
-    &message_sound_off,
+/**
+ * Screens of the app, each with its own key handlers
+ */
+typedef enum {
+    PomodoroScreenRun, //the run, or the settings while it is not running
+    PomodoroScreenStats,
+    PomodoroScreenProfiles,
+    PomodoroScreenRename, //name of the current profile being edited
+    PomodoroScreenCount,
+} PomodoroScreen;
 
-    &message_blue_0,
-    &message_vibro_off,
-    NULL,
-};
+/**
+ * Profile shown on the profiles screen
+ */
+typedef struct {
+    char name[POMODORO_PROFILES_NAME]; //name of the current profile, the edited one while renaming
+    uint8_t index;
+    uint8_t count;
+    uint8_t cursor; //character edited while renaming
+    uint32_t durations[PomodoroStateCount];
+    uint32_t cycle;
+} PomodoroProfilesFrame;
 
 /**
- * Handles the drawing of imtes to the screen
- *
- * @param Canvas
- * @param ctx
+ * Everything the key handlers work on
  */
-static void draw_callback(Canvas* const canvas, void* ctx) {
-    furi_assert(ctx);
-    const Pomodoro* pomodoro = ctx;
+typedef struct {
+    Pomodoro* pomodoro;
+    AppRuntime* runtime;
+    PomodoroLoad* load; //set while the worker is loading
+    AppEvent deferred[POMODORO_DEFERRED];
+    uint8_t deferred_count;
+    PomodoroHistory* history; //may be NULL
+    PomodoroJournal* journal; //may be NULL
+    PomodoroTimers* timers; //NULL while loading
+    PomodoroStats* stats; //may be NULL
+    PomodoroProfiles* profiles; //may be NULL
+    PomodoroAlerts* alerts; //NULL during a replay
+    PomodoroScreen screen;
+    PomodoroStatsFrame stats_frame;
+    char rename[POMODORO_PROFILES_NAME]; //name being edited
+    uint8_t cursor; //character of the name being edited
+    char alert[POMODORO_TIMERS_NAME]; //name of the timer that is up, empty if none
+    bool update; //a handler changed what is shown
+} PomodoroApp;
+
+/**
+ * Everything the draw callback needs, handed over from the loop through a snapshot
+ */
+typedef struct {
+    bool loading;
+    PomodoroScreen screen;
+    PomodoroStatsFrame stats;
+    PomodoroProfilesFrame profiles;
+    PomodoroState shown; //run whose time is shown
+    uint32_t minutes; //time of the shown run
+    uint32_t count;
+    uint32_t repetitions;
+    uint32_t totalruns;
+    bool running;
+    bool notification;
+    char alert[POMODORO_TIMERS_NAME];
+    uint16_t timers; //running named timers
+    char next[POMODORO_TIMERS_NAME]; //name of the timer that is up next
+    uint32_t next_minutes; //minutes until it is up, rounded up
+    char profile[POMODORO_PROFILES_NAME]; //name of the current profile, empty without profiles
+} PomodoroFrame;
+
+#ifdef APP_PROFILE
+static AppProfile profile;
+#endif
 
-    furi_mutex_acquire(pomodoro->mutex, FuriWaitForever);
+//a held up or down key changes the minutes by 1, 2, 4, 8 and then 16 per repeat
+static const AppInputCurve minute_curve = {.start = 1, .limit = 16, .doubling = 1};
 
-    canvas_set_color(canvas, ColorWhite);
-    canvas_draw_box(canvas, 14, 20, 100, 24);
+//characters a profile name is edited with, up and down step through them
+static const char pomodoro_name_characters[] = " ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-";
 
+//everything the app allocates, used with cdefines=["APP_STATIC"]
+APP_ARENA_DEFINE(APP_ARENA_SIZE(
+    sizeof(Pomodoro) + sizeof(AppRuntime) + sizeof(PomodoroLoad) + APP_SNAPSHOT_BYTES(sizeof(PomodoroFrame)),
+    3 + APP_SNAPSHOT_ALLOCATIONS));
+
+//recording or replay, used with cdefines=["APP_TRACE"]
+APP_TRACE_DEFINE();
+
+//shapes are drawn off screen and copied to the canvas in one go, too large for the stack
+static AppBackBuffer backbuffer;
+
+/**
+ * Draws the run, or the settings while it is not running
+ *
+ * @param canvas canvas to draw to
+ * @param frame frame to draw
+ */
+static void pomodoro_draw_run(Canvas* const canvas, const PomodoroFrame* frame) {
+    app_backbuffer_clear(&backbuffer);
+    app_backbuffer_frame(&backbuffer, 14, 20, 100, 24, AppBackBufferSet);
     canvas_set_color(canvas, ColorBlack);
-    canvas_draw_frame(canvas, 14, 20, 100, 24);
+    app_backbuffer_blit(&backbuffer, canvas);
 
-    char buffer[30];
+    //only the gui thread draws, so the text buffer does not need to be on its stack
+    static char buffer[48];
     canvas_set_font(canvas, FontPrimary);
-    //TODO shorten, use enum?
-    if(pomodoro->endTime == &pomodoro->shortBreakTime)
-        snprintf(buffer, sizeof(buffer), " %s(%ld min) ", "Short break", *pomodoro->endTime);
-    else if(pomodoro->endTime == &pomodoro->longBreakTime)
-        snprintf(buffer, sizeof(buffer), " %s(%ld min) ", "Long break", *pomodoro->endTime);
-    else
-        snprintf(buffer, sizeof(buffer), " %s(%ld min) ", "Work", *pomodoro->endTime);
+    snprintf(buffer, sizeof(buffer), " %s(%" PRId32 " min) ", pomodoro_phase_name(frame->shown), frame->minutes);
 
     canvas_draw_str_aligned(canvas, 64, 31, AlignCenter, AlignBottom, buffer);
 
     canvas_set_font(canvas, FontSecondary);
-    if(pomodoro->running){
-        if(pomodoro->notification) {
-            canvas_draw_str_aligned(canvas, 64, 11, AlignCenter, AlignBottom, "Time is up, press arrow key");
-        }
-        snprintf(buffer,sizeof buffer, "Reps %ld, Timer %ld min", pomodoro->repetitions, pomodoro->count);
+    if(frame->loading) {
+        canvas_draw_str_aligned(canvas, 64, 11, AlignCenter, AlignBottom, "Loading...");
+    } else if(frame->running && frame->notification) {
+        canvas_draw_str_aligned(canvas, 64, 11, AlignCenter, AlignBottom, "Time is up, press arrow key");
+    } else if(frame->alert[0]) {
+        snprintf(buffer, sizeof(buffer), "%s is up", frame->alert);
+        canvas_draw_str_aligned(canvas, 64, 11, AlignCenter, AlignBottom, buffer);
+    } else if(frame->timers) {
+        snprintf(buffer, sizeof(buffer), "%s in %" PRId32 " min (%u)", frame->next, frame->next_minutes, frame->timers);
+        canvas_draw_str_aligned(canvas, 64, 11, AlignCenter, AlignBottom, buffer);
+    } else if(!frame->running && frame->profile[0]) {
+        snprintf(buffer, sizeof(buffer), "Profile: %s", frame->profile);
+        canvas_draw_str_aligned(canvas, 64, 11, AlignCenter, AlignBottom, buffer);
+    }
+    if(frame->running){
+        snprintf(buffer,sizeof buffer, "Reps %" PRId32 ", Timer %" PRId32 " min", frame->repetitions, frame->count);
         canvas_draw_str_aligned(canvas, 64, 41, AlignCenter, AlignBottom, buffer);
         canvas_draw_str_aligned(canvas, 2, 60, AlignLeft, AlignBottom, "OK to Pause, Down to Restart");
     }else{
-        snprintf(buffer,sizeof buffer, "Total reps %ld", pomodoro->totalruns);
+        snprintf(buffer,sizeof buffer, "Total reps %" PRId32, frame->totalruns);
         canvas_draw_str_aligned(canvas, 120, 60, AlignRight, AlignBottom, buffer);
         canvas_draw_str_aligned(canvas, 64, 41, AlignCenter, AlignBottom, "< Change value > ");
         canvas_draw_str_aligned(canvas, 2, 60, AlignLeft, AlignBottom, "OK to start");
     }
+}
 
-    furi_mutex_release(pomodoro->mutex);
+/**
+ * Draws the statistics, only the buckets read when the screen was opened or paged are shown
+ *
+ * @param canvas canvas to draw to
+ * @param stats statistics to draw
+ */
+static void pomodoro_draw_stats(Canvas* const canvas, const PomodoroStatsFrame* stats) {
+    //only the gui thread draws, so the text buffer does not need to be on its stack
+    static char buffer[40];
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 10, AlignCenter, AlignBottom, "Statistics");
+
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(buffer, sizeof(buffer), "Today: %" PRId32 " min in %u", stats->today_seconds / 60, stats->today_sessions);
+    canvas_draw_str_aligned(canvas, 2, 22, AlignLeft, AlignBottom, buffer);
+    if(stats->weeks_back == 0) {
+        snprintf(buffer, sizeof(buffer), "< This week: %" PRId32 " min in %u", stats->week_seconds / 60, stats->week_sessions);
+    } else {
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "< Week -%u: %" PRId32 " min in %u >",
+            stats->weeks_back,
+            stats->week_seconds / 60,
+            stats->week_sessions);
+    }
+    canvas_draw_str_aligned(canvas, 2, 33, AlignLeft, AlignBottom, buffer);
+    snprintf(buffer, sizeof(buffer), "Streak %u days, best %u", stats->streak, stats->best_streak);
+    canvas_draw_str_aligned(canvas, 2, 44, AlignLeft, AlignBottom, buffer);
+    snprintf(buffer, sizeof(buffer), "Avg %" PRId32 " min, %" PRId32 " in total", stats->average / 60, stats->sessions);
+    canvas_draw_str_aligned(canvas, 2, 55, AlignLeft, AlignBottom, buffer);
+}
+
+/**
+ * Draws the current profile, while renaming the edited character is shown in brackets
+ *
+ * @param canvas canvas to draw to
+ * @param profiles profile to draw
+ * @param renaming true while the name is edited
+ */
+static void pomodoro_draw_profiles(Canvas* const canvas, const PomodoroProfilesFrame* profiles, bool renaming) {
+    //only the gui thread draws, so the text buffer does not need to be on its stack
+    static char buffer[40];
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontPrimary);
+    snprintf(buffer, sizeof(buffer), "Profile %u/%u", profiles->index + 1, profiles->count);
+    canvas_draw_str_aligned(canvas, 64, 10, AlignCenter, AlignBottom, buffer);
+
+    if(renaming) {
+        const int cursor = profiles->cursor;
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "%.*s[%c]%s",
+            cursor,
+            profiles->name,
+            profiles->name[cursor],
+            profiles->name + cursor + 1);
+    } else {
+        strlcpy(buffer, profiles->name, sizeof(buffer));
+    }
+    canvas_draw_str_aligned(canvas, 64, 26, AlignCenter, AlignBottom, buffer);
+
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(
+        buffer,
+        sizeof(buffer),
+        "%" PRId32 " / %" PRId32 " / %" PRId32 " min, cycle %" PRId32,
+        profiles->durations[workTime],
+        profiles->durations[shortBreakTime],
+        profiles->durations[longBreakTime],
+        profiles->cycle);
+    canvas_draw_str_aligned(canvas, 64, 40, AlignCenter, AlignBottom, buffer);
+    canvas_draw_str_aligned(
+        canvas,
+        2,
+        60,
+        AlignLeft,
+        AlignBottom,
+        renaming ? "^v letter, <> move, OK save" : "^v switch, < new, rename >");
+}
+
+/**
+ * Handles the drawing of imtes to the screen, never waits for the loop. If nothing new was published the last
+ * frame is drawn again.
+ *
+ * @param Canvas
+ * @param ctx snapshot of PomodoroFrame
+ */
+static void draw_callback(Canvas* const canvas, void* ctx) {
+    furi_assert(ctx);
+    APP_PROFILE_START(draw_start);
+    APP_PROFILE_STACK(profile.stack_draw);
+    APP_PROFILE_FRAME(&profile);
+    const PomodoroFrame* frame = app_snapshot_acquire(ctx, furi_ms_to_ticks(100));
+
+    switch(frame->screen) {
+    case PomodoroScreenStats:
+        pomodoro_draw_stats(canvas, &frame->stats);
+        break;
+    case PomodoroScreenProfiles:
+    case PomodoroScreenRename:
+        pomodoro_draw_profiles(canvas, &frame->profiles, frame->screen == PomodoroScreenRename);
+        break;
+    default:
+        pomodoro_draw_run(canvas, frame);
+        break;
+    }
+
+#ifdef APP_PROFILE
+    if(profile.overlay) app_profile_overlay(canvas, &profile);
+#endif
+    APP_PROFILE_STOP(&profile.draw, draw_start);
+}
+
+/**
+ * @return current unix timestamp, the deadlines of the named timers are kept in it
+ */
+static uint32_t pomodoro_now(void) {
+    FuriHalRtcDateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    return furi_hal_rtc_datetime_to_timestamp(&datetime);
+}
+
+/**
+ * Copies the render state into the back slot of the snapshot and publishes it
+ *
+ * @param app app with the current status
+ * @param snapshot snapshot of PomodoroFrame to publish to
+ */
+static void pomodoro_publish(const PomodoroApp* app, AppSnapshot* snapshot) {
+    const Pomodoro* const pomodoro = app->pomodoro;
+    PomodoroFrame* frame = app_snapshot_back(snapshot);
+    frame->loading = app->load != NULL;
+    frame->screen = app->screen;
+    frame->stats = app->stats_frame;
+    frame->shown = pomodoro->selected;
+    frame->minutes = pomodoro->durations[pomodoro->selected];
+    frame->count = pomodoro->count;
+    frame->repetitions = pomodoro->repetitions;
+    frame->totalruns = pomodoro->totalruns;
+    frame->running = pomodoro->running;
+    frame->notification = pomodoro->notification;
+    strlcpy(frame->alert, app->alert, sizeof(frame->alert));
+    frame->timers = app->timers ? pomodoro_timers_count(app->timers) : 0;
+    if(frame->timers) {
+        const PomodoroTimer* next = pomodoro_timers_get(app->timers, pomodoro_timers_next(app->timers));
+        const uint32_t now = pomodoro_now();
+        strlcpy(frame->next, next->name, sizeof(frame->next));
+        frame->next_minutes = next->deadline > now ? (next->deadline - now + 59) / 60 : 0;
+    }
+    if(app->profiles) {
+        strlcpy(frame->profile, pomodoro_profiles_current(app->profiles)->name, sizeof(frame->profile));
+        PomodoroProfilesFrame* profiles = &frame->profiles;
+        strlcpy(
+            profiles->name,
+            app->screen == PomodoroScreenRename ? app->rename : frame->profile,
+            sizeof(profiles->name));
+        profiles->index = pomodoro_profiles_index(app->profiles);
+        profiles->count = pomodoro_profiles_count(app->profiles);
+        profiles->cursor = app->cursor;
+        memcpy(profiles->durations, pomodoro->durations, sizeof(profiles->durations));
+        profiles->cycle = pomodoro->cycle;
+    } else {
+        frame->profile[0] = '\0';
+    }
+    app_snapshot_publish(snapshot);
+}
+
+/**
+ * Returns the time the run was running, without the time it was paused
+ *
+ * @param pomodoro object that stores the current status
+ *
+ * @return elapsed time of the run in ticks
+ */
+static uint32_t pomodoro_run_elapsed(const Pomodoro* const pomodoro) {
+    if(!pomodoro->running) return pomodoro->runElapsed;
+    return pomodoro->runElapsed + (app_clock() - pomodoro->runStart);
+}
+
+/**
+ * Starts the run from zero
+ *
+ * @param pomodoro object that stores the current status
+ */
+static void pomodoro_run_reset(Pomodoro* const pomodoro) {
+    pomodoro->count = 0;
+    pomodoro->runElapsed = 0;
+    pomodoro->pausedTime = 0;
+    pomodoro->runStart = app_clock();
+    pomodoro->pauseStart = pomodoro->runStart;
 }
 
 /**
- * Handles input events and adds them to a queue
+ * Starts or resumes the run, adding the time since the pause to the paused time
  *
- * @param input_event input event to add
- * @param event_queue queue to add the input to
+ * @param pomodoro object that stores the current status
  */
-static void input_callback(InputEvent* input_event, FuriMessageQueue* event_queue) {
-    furi_assert(event_queue);
+static void pomodoro_run_resume(Pomodoro* const pomodoro) {
+    pomodoro->runStart = app_clock();
+    pomodoro->pausedTime += pomodoro->runStart - pomodoro->pauseStart;
+    pomodoro->running = true;
+}
 
-    PomodoroEvent event = {.type = EventTypeKey, .input = *input_event};
-    furi_message_queue_put(event_queue, &event, FuriWaitForever);
+/**
+ * Pauses the run, keeping the time it has been running
+ *
+ * @param pomodoro object that stores the current status
+ */
+static void pomodoro_run_pause(Pomodoro* const pomodoro) {
+    pomodoro->runElapsed = pomodoro_run_elapsed(pomodoro);
+    pomodoro->pauseStart = app_clock();
+    pomodoro->running = false;
 }
 
 /**
- * Handles the timer
+ * Adds the run that is about to be finished to the history
  *
- * @param event_queue queue to add the timer tick to
+ * @param pomodoro object that stores the current status
+ * @param history history to add the run to, may be NULL
  */
-static void pomodoro_update_timer_callback(FuriMessageQueue* event_queue) {
-    furi_assert(event_queue);
+static void pomodoro_record_history(const Pomodoro* const pomodoro, PomodoroHistory* history) {
+    if(!history) return;
 
-    PomodoroEvent event = {.type = EventTypeTick};
-    furi_message_queue_put(event_queue, &event, 0);
+    const uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    const uint32_t elapsed = pomodoro_run_elapsed(pomodoro);
+    uint32_t paused = pomodoro->pausedTime;
+    if(!pomodoro->running) paused += app_clock() - pomodoro->pauseStart;
+
+    PomodoroHistoryEntry entry = {
+        .start = pomodoro_now() - (elapsed + paused) / tick_frequency,
+        .actual = elapsed / tick_frequency,
+        .planned = pomodoro->durations[pomodoro->state],
+        .type = pomodoro->state,
+    };
+    pomodoro_history_append(history, &entry);
 }
 
 /**
  * Stops the notification
  *
  * @param pomodoro object that stores the current status
+ * @param history history to add the finished run to, may be NULL
+ * @param stats stats to add a finished work interval to, may be NULL
  */
-static void pomodoro_stop_notification(Pomodoro* const pomodoro){
-//TODO always sets both...
+static void pomodoro_stop_notification(Pomodoro* const pomodoro, PomodoroHistory* history, PomodoroStats* stats){
+    //only a work interval that ran out counts, skipping it early does not
+    if(stats && pomodoro->notification && pomodoro->state == workTime) {
+        //the run goes on while the alert plays, only the minutes of the interval count
+        const uint32_t seconds = pomodoro_run_elapsed(pomodoro) / furi_kernel_get_tick_frequency();
+        pomodoro_stats_add(stats, pomodoro_now(), MIN(seconds, pomodoro->durations[workTime] * 60));
+    }
     pomodoro->notification = false;
-    pomodoro->count = 0;
-    if(pomodoro->endTime == &pomodoro->workTime){
-        pomodoro->repetitions++;
-        pomodoro->totalruns = pomodoro->totalruns + 1;
-        if(pomodoro->repetitions == 4){
-            pomodoro->repetitions = 0;
-            pomodoro->state = longBreakTime;
-            pomodoro->endTime = &pomodoro->longBreakTime;
-        }else{
-            pomodoro->state = shortBreakTime;
-            pomodoro->endTime = &pomodoro->shortBreakTime;
+    pomodoro_record_history(pomodoro, history);
+    pomodoro_run_reset(pomodoro);
+    pomodoro_phase_apply(pomodoro, PomodoroEventFinish);
+}
+
+/**
+ * Restores the run from the newest journal record, which is at least as new as the run in the config file
+ *
+ * @param pomodoro object that stores the current status
+ * @param record record to restore from
+ */
+static void pomodoro_restore_run(Pomodoro* const pomodoro, const PomodoroJournalRecord* record) {
+    pomodoro->runElapsed = record->elapsed;
+    pomodoro->count = record->elapsed / furi_ms_to_ticks(60 * 1000);
+    pomodoro->repetitions = record->repetitions;
+    pomodoro_phase_set_cycle(pomodoro, pomodoro->cycle);
+    pomodoro->totalruns = record->totalRuns;
+    pomodoro->running = record->running || pomodoro->count > 0 || pomodoro->repetitions > 0;
+    pomodoro_phase_set(pomodoro, record->state);
+}
+
+/**
+ * Changes the minutes of the chosen interval, an interval is at least one minute long
+ *
+ * @param pomodoro object that stores the current status
+ * @param key up to add the minutes, down to remove them
+ * @param minutes minutes to add or remove
+ */
+static void pomodoro_adjust(Pomodoro* const pomodoro, InputKey key, uint32_t minutes) {
+    uint32_t* duration = &pomodoro->durations[pomodoro->selected];
+    if(key == InputKeyUp) {
+        *duration += minutes;
+    } else if(*duration > minutes) {
+        *duration -= minutes;
+    } else {
+        *duration = 1;
+    }
+}
+
+/**
+ * Derives the minutes of the run from the time that has passed and arms the timer for the next visible change, which is
+ * the next minute of the run, the end of it or the next minute of the earliest named timer. Later named timers never
+ * wake the loop, and without a running run or named timer the timer stays off, so the loop only wakes up for key
+ * presses.
+ *
+ * @param pomodoro object that stores the current status
+ * @param timers named timers, only the earliest one is looked at, may be NULL
+ * @param now current unix timestamp
+ * @param timer one shot timer to arm
+ *
+ * @return true if the shown values changed
+ */
+static bool
+    pomodoro_schedule(Pomodoro* const pomodoro, const PomodoroTimers* timers, uint32_t now, FuriTimer* timer) {
+    const uint32_t minute = furi_ms_to_ticks(60 * 1000);
+    uint32_t delay = UINT32_MAX;
+    bool changed = false;
+
+    if(pomodoro->running) {
+        const uint32_t elapsed = pomodoro_run_elapsed(pomodoro);
+        if(pomodoro->count != elapsed / minute) {
+            pomodoro->count = elapsed / minute;
+            changed = true;
+        }
+        if(!pomodoro->notification && pomodoro->count >= pomodoro->durations[pomodoro->state]) {
+            pomodoro->notification = true;
+            changed = true;
         }
+        delay = minute - elapsed % minute;
+    }
+
+    //the deadline is in seconds of the rtc, waking up a second late is fine for a named timer
+    const uint16_t next = timers ? pomodoro_timers_next(timers) : POMODORO_TIMERS_NONE;
+    if(next != POMODORO_TIMERS_NONE) {
+        const uint32_t left = pomodoro_timers_get(timers, next)->deadline - now;
+        const uint32_t seconds = left % 60 ? left % 60 : 60;
+        delay = MIN(delay, MAX(furi_ms_to_ticks(seconds * 1000), 1U));
+    }
+
+    if(delay == UINT32_MAX) {
+        if(furi_timer_is_running(timer)) furi_timer_stop(timer);
+    } else {
+        furi_timer_start(timer, delay);
+    }
+    return changed;
+}
+
+/**
+ * Changes the minutes in the settings, while running a press stops the notification
+ *
+ * @param ctx app
+ * @param input up or down key
+ */
+static void pomodoro_key_adjust(void* ctx, const InputEvent* input) {
+    PomodoroApp* app = ctx;
+    Pomodoro* pomodoro = app->pomodoro;
+    if(!pomodoro->running) {
+        pomodoro_adjust(pomodoro, input->key, app_input_take(&app->runtime->input, &minute_curve, input));
+    }else if(input->type == InputTypePress && pomodoro->notification){
+        pomodoro_stop_notification(pomodoro, app->history, app->stats);
+    }
+    app->update = true;
+}
+
+/**
+ * Resets the timers while running, in the settings a held down key keeps changing the minutes
+ *
+ * @param ctx app
+ * @param input long press of down
+ */
+static void pomodoro_key_reset(void* ctx, const InputEvent* input) {
+    PomodoroApp* app = ctx;
+    Pomodoro* pomodoro = app->pomodoro;
+    if(!pomodoro->running) {
+        pomodoro_key_adjust(ctx, input);
+        return;
+    }
+    pomodoro_phase_apply(pomodoro, PomodoroEventReset);
+    pomodoro_run_reset(pomodoro);
+    app->update = true;
+}
+
+/**
+ * Selects the next interval in the settings, while running it stops the notification
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_next(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    Pomodoro* pomodoro = app->pomodoro;
+    if(!pomodoro->running){
+        pomodoro_phase_apply(pomodoro, PomodoroEventNext);
     }else{
-        pomodoro->state = workTime;
-        pomodoro->endTime = &pomodoro->workTime;
+        pomodoro_stop_notification(pomodoro, app->history, app->stats);
+    }
+    app->update = true;
+}
+
+/**
+ * Selects the previous interval in the settings, while running it stops the notification
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_previous(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    Pomodoro* pomodoro = app->pomodoro;
+    if(!pomodoro->running){
+        pomodoro_phase_apply(pomodoro, PomodoroEventPrevious);
+    }else if(pomodoro->notification){
+        pomodoro_stop_notification(pomodoro, app->history, app->stats);
     }
+    app->update = true;
 }
 
+/**
+ * Starts the run in the settings, saving the defaults each time, while running it pauses the run. Acts on the short
+ * press, so a long one only opens the profiles.
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_start(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    Pomodoro* pomodoro = app->pomodoro;
+    if(!pomodoro->running){
+        if(!app_trace_replaying()) pomodoro_save_settings(pomodoro);
+        //the times the run is started with are kept in the profile they were changed in
+        if(app->profiles) pomodoro_profiles_store(app->profiles, pomodoro);
+        //the run goes on with its own interval, not the one last chosen in the settings
+        pomodoro->selected = pomodoro->state;
+        pomodoro_run_resume(pomodoro);
+    }else{
+        pomodoro->notification = false;
+        pomodoro_run_pause(pomodoro);
+    }
+    app->update = true;
+}
+
+/**
+ * Saves the run and closes the app
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_exit(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    if(!app_trace_replaying()) pomodoro_save_current_run(app->pomodoro);
+    if(app->journal) {
+        pomodoro_save_journal(app->journal, app->pomodoro, pomodoro_run_elapsed(app->pomodoro), pomodoro_now());
+    }
+    app_runtime_exit(app->runtime);
+}
+
+/**
+ * Adds a named timer with the minutes of the shown interval in the settings
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_timer_add(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    Pomodoro* pomodoro = app->pomodoro;
+    if(pomodoro->running) return;
+
+    const uint32_t minutes = pomodoro->durations[pomodoro->selected];
+    char timer_name[POMODORO_TIMERS_NAME];
+    snprintf(timer_name, sizeof(timer_name), "%s %" PRId32, pomodoro_phase_name(pomodoro->selected), minutes);
+    if(pomodoro_timers_add(app->timers, timer_name, pomodoro_now() + minutes * 60) ==
+       POMODORO_TIMERS_NONE) {
+        FURI_LOG_W("Pomodoro", "all %d timers are used", POMODORO_TIMERS_CAPACITY);
+    }
+    app->update = true;
+}
+
+/**
+ * Cancels the named timer that is up next in the settings
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_timer_cancel(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    if(app->pomodoro->running) return;
+    pomodoro_timers_cancel(app->timers, pomodoro_timers_next(app->timers));
+    app->update = true;
+}
+
+/**
+ * Takes the times of a profile over into the settings
+ *
+ * @param pomodoro object that stores the current status
+ * @param current profile to take the times of
+ */
+static void pomodoro_profile_apply(Pomodoro* const pomodoro, const PomodoroProfile* current) {
+    memcpy(pomodoro->durations, current->durations, sizeof(pomodoro->durations));
+    //a shorter cycle ends with the next work interval
+    pomodoro_phase_set_cycle(pomodoro, current->cycle);
+}
+
+/**
+ * Opens the profiles in the settings
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_profiles(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    if(app->pomodoro->running || !app->profiles) return;
+    app->screen = PomodoroScreenProfiles;
+    app->update = true;
+}
+
+/**
+ * Closes the profiles, the settings keep the times of the current one
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_profiles_close(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    app->screen = PomodoroScreenRun;
+    app->update = true;
+}
+
+/**
+ * Switches the settings to the previous or next profile, the run keeps its interval and repetitions
+ *
+ * @param ctx app
+ * @param input up for the previous profile, down for the next one
+ */
+static void pomodoro_key_profile_switch(void* ctx, const InputEvent* input) {
+    PomodoroApp* app = ctx;
+    APP_PROFILE_START(start);
+    const uint8_t count = pomodoro_profiles_count(app->profiles);
+    const uint8_t index = pomodoro_profiles_index(app->profiles);
+    const uint8_t next = input->key == InputKeyUp ? (index + count - 1) % count : (index + 1) % count;
+    if(pomodoro_profiles_select(app->profiles, next)) {
+        pomodoro_profile_apply(app->pomodoro, pomodoro_profiles_current(app->profiles));
+        app->update = true;
+    }
+    APP_PROFILE_STOP(&profile.preset, start);
+}
+
+/**
+ * Adds a profile with the times of the settings and switches to it
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_profile_create(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    char name[POMODORO_PROFILES_NAME];
+    snprintf(name, sizeof(name), "Profile %u", pomodoro_profiles_count(app->profiles) + 1);
+    if(pomodoro_profiles_create(app->profiles, name, app->pomodoro) == POMODORO_PROFILES_NONE) {
+        FURI_LOG_W("Pomodoro", "all %d profiles are used", POMODORO_PROFILES_CAPACITY);
+    }
+    app->update = true;
+}
+
+/**
+ * Starts editing the name of the current profile at its first character
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_profile_rename(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    strlcpy(app->rename, pomodoro_profiles_current(app->profiles)->name, sizeof(app->rename));
+    if(!app->rename[0]) strlcpy(app->rename, " ", sizeof(app->rename));
+    app->cursor = 0;
+    app->screen = PomodoroScreenRename;
+    app->update = true;
+}
+
+/**
+ * Steps the edited character through the characters of a name
+ *
+ * @param ctx app
+ * @param input up for the next character, down for the previous one
+ */
+static void pomodoro_key_rename_character(void* ctx, const InputEvent* input) {
+    PomodoroApp* app = ctx;
+    const uint8_t count = sizeof(pomodoro_name_characters) - 1;
+    const char* found = strchr(pomodoro_name_characters, app->rename[app->cursor]);
+    const uint8_t index = found ? found - pomodoro_name_characters : 0;
+    app->rename[app->cursor] =
+        pomodoro_name_characters[input->key == InputKeyUp ? (index + 1) % count : (index + count - 1) % count];
+    app->update = true;
+}
+
+/**
+ * Moves to the previous or next character of the name, moving past its end adds a space
+ *
+ * @param ctx app
+ * @param input left or right
+ */
+static void pomodoro_key_rename_move(void* ctx, const InputEvent* input) {
+    PomodoroApp* app = ctx;
+    if(input->key == InputKeyLeft) {
+        if(app->cursor > 0) app->cursor--;
+    } else if(app->cursor < POMODORO_PROFILES_NAME - 2) {
+        app->cursor++;
+        if(!app->rename[app->cursor]) {
+            app->rename[app->cursor] = ' ';
+            app->rename[app->cursor + 1] = '\0';
+        }
+    }
+    app->update = true;
+}
+
+/**
+ * Saves the edited name without its trailing spaces, an empty name keeps the old one
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_rename_save(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    size_t length = strlen(app->rename);
+    while(length && app->rename[length - 1] == ' ') app->rename[--length] = '\0';
+    if(length) pomodoro_profiles_rename(app->profiles, app->rename);
+    app->screen = PomodoroScreenProfiles;
+    app->update = true;
+}
+
+/**
+ * Leaves the name as it was
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_rename_cancel(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    app->screen = PomodoroScreenProfiles;
+    app->update = true;
+}
+
+/**
+ * Loads the config, the journal, the history and the named timers, so the first frame does not wait for storage. On a
+ * fresh install it only looks for the files, each one is created by its first write.
+ *
+ * @param ctx PomodoroLoad to fill
+ *
+ * @return 0
+ */
+static int32_t pomodoro_load_worker(void* ctx) {
+    PomodoroLoad* load = ctx;
+    pomodoro_get_initial_values(&load->values);
+    if(!load->replaying) {
+        load->history = pomodoro_history_alloc();
+        load->journal = pomodoro_journal_alloc();
+        load->recovered = pomodoro_journal_recover(load->journal, &load->record);
+        load->stats = pomodoro_stats_alloc();
+        //a new profiles file starts on the profile with the times of the config
+        load->profiles = pomodoro_profiles_alloc(&load->values);
+    }
+    load->timers = pomodoro_timers_alloc(!load->replaying);
+    if(load->runtime) app_runtime_post(load->runtime, AppEventTypeWorker);
+    return 0;
+}
+
+/**
+ * Starts loading on a worker thread
+ *
+ * @param app app to load for
+ * @param post true to post an AppEventTypeWorker when done, otherwise pomodoro_loaded has to be called
+ */
+static void pomodoro_load_start(PomodoroApp* app, bool post) {
+    PomodoroLoad* load = APP_ALLOC(sizeof(PomodoroLoad));
+    memset(load, 0, sizeof(PomodoroLoad));
+    load->runtime = post ? app->runtime : NULL;
+    load->replaying = app_trace_replaying();
+    load->thread = furi_thread_alloc();
+    furi_thread_set_name(load->thread, "PomodoroLoad");
+    furi_thread_set_stack_size(load->thread, 2 * 1024);
+    furi_thread_set_context(load->thread, load);
+    furi_thread_set_callback(load->thread, pomodoro_load_worker);
+    app->load = load;
+    furi_thread_start(load->thread);
+}
+
+/**
+ * Waits for the worker and takes over what it loaded in one go, the run of the journal is at least as new as the
+ * one in the config file
+ *
+ * @param ctx app
+ */
+static void pomodoro_loaded(void* ctx) {
+    PomodoroApp* app = ctx;
+    PomodoroLoad* load = app->load;
+    if(!load) return;
+    furi_thread_join(load->thread);
+    furi_thread_free(load->thread);
+
+    Pomodoro* pomodoro = app->pomodoro;
+    const Pomodoro* values = &load->values;
+    memcpy(pomodoro->durations, values->durations, sizeof(pomodoro->durations));
+    pomodoro->cycle = values->cycle;
+    pomodoro->count = values->count;
+    pomodoro->repetitions = values->repetitions;
+    //the times are kept in the current profile, a switch without a start after it never reached the config
+    if(load->profiles) pomodoro_profile_apply(pomodoro, pomodoro_profiles_current(load->profiles));
+    pomodoro->totalruns = values->totalruns;
+    pomodoro->running = values->running;
+    pomodoro->notification = values->notification;
+    pomodoro_phase_set(pomodoro, values->state);
+    //the config file only stores full minutes of the run
+    pomodoro->runElapsed = pomodoro->count * furi_ms_to_ticks(60 * 1000);
+    if(load->recovered) {
+        pomodoro_restore_run(pomodoro, &load->record);
+        //a run that was running when the app was closed went on without waking the device up
+        const uint32_t now = pomodoro_now();
+        if(load->record.running && load->record.timestamp && now > load->record.timestamp) {
+            pomodoro_phase_continue(pomodoro, now - load->record.timestamp);
+        }
+    }
+    pomodoro->pausedTime = 0;
+    pomodoro->runStart = app_clock();
+    pomodoro->pauseStart = pomodoro->runStart;
+
+    app->history = load->history;
+    app->journal = load->journal;
+    app->timers = load->timers;
+    app->stats = load->stats;
+    app->profiles = load->profiles;
+    APP_FREE(load);
+    app->load = NULL;
+    app->update = true;
+}
+
+/**
+ * Reads the buckets of today and of the shown week and the totals into the stats screen
+ *
+ * @param app app to fill the stats screen of
+ */
+static void pomodoro_stats_refresh(PomodoroApp* app) {
+    PomodoroStatsFrame* frame = &app->stats_frame;
+    const uint8_t weeks_back = frame->weeks_back;
+    memset(frame, 0, sizeof(PomodoroStatsFrame));
+    frame->weeks_back = weeks_back;
+    if(!app->stats) return;
+
+    const uint32_t today = pomodoro_stats_day(pomodoro_now());
+    PomodoroStatsBucket bucket;
+    if(pomodoro_stats_read_day(app->stats, today, &bucket)) {
+        frame->today_seconds = bucket.seconds;
+        frame->today_sessions = bucket.sessions;
+    }
+    if(pomodoro_stats_read_week(app->stats, pomodoro_stats_week(today) - weeks_back, &bucket)) {
+        frame->week_seconds = bucket.seconds;
+        frame->week_sessions = bucket.sessions;
+    }
+    const PomodoroStatsHeader* totals = pomodoro_stats_totals(app->stats);
+    frame->streak = pomodoro_stats_streak(app->stats, today);
+    frame->best_streak = totals->best_streak;
+    frame->sessions = totals->sessions;
+    frame->average = totals->sessions ? totals->seconds / totals->sessions : 0;
+}
+
+/**
+ * Opens or closes the stats screen, it opens on this week
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_stats(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    app->screen = app->screen == PomodoroScreenStats ? PomodoroScreenRun : PomodoroScreenStats;
+    if(app->screen == PomodoroScreenStats) {
+        app->stats_frame.weeks_back = 0;
+        pomodoro_stats_refresh(app);
+    }
+    app->update = true;
+}
+
+/**
+ * Shows an older or newer week on the stats screen, as far back as weeks are kept
+ *
+ * @param ctx app
+ * @param input left for older, right for newer
+ */
+static void pomodoro_key_stats_week(void* ctx, const InputEvent* input) {
+    PomodoroApp* app = ctx;
+    uint8_t* weeks_back = &app->stats_frame.weeks_back;
+    if(input->key == InputKeyLeft && *weeks_back < POMODORO_STATS_WEEKS - 1) {
+        (*weeks_back)++;
+    } else if(input->key == InputKeyRight && *weeks_back > 0) {
+        (*weeks_back)--;
+    } else {
+        return;
+    }
+    pomodoro_stats_refresh(app);
+    app->update = true;
+}
+
+#ifdef APP_PROFILE
+/**
+ * Shows or hides the profiling overlay
+ *
+ * @param ctx app
+ * @param input unused
+ */
+static void pomodoro_key_overlay(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    PomodoroApp* app = ctx;
+    profile.overlay = !profile.overlay;
+    app->update = true;
+}
+#endif
+
+//ticks have no handler, they only wake the loop up to schedule the next one
+static const AppHandlers pomodoro_handlers = {
+    .tick = NULL,
+    .worker = pomodoro_loaded,
+    .keys =
+        {
+            [InputKeyUp] =
+                {
+                    [InputTypePress] = pomodoro_key_adjust,
+                    [InputTypeLong] = pomodoro_key_adjust,
+                    [InputTypeRepeat] = pomodoro_key_adjust,
+                },
+            [InputKeyDown] =
+                {
+                    [InputTypePress] = pomodoro_key_adjust,
+                    [InputTypeLong] = pomodoro_key_reset,
+                    [InputTypeRepeat] = pomodoro_key_adjust,
+                },
+            [InputKeyRight] =
+                {
+                    [InputTypeShort] = pomodoro_key_next,
+                    [InputTypeLong] = pomodoro_key_timer_add,
+                },
+            [InputKeyLeft] =
+                {
+                    [InputTypeShort] = pomodoro_key_previous,
+                    [InputTypeLong] = pomodoro_key_timer_cancel,
+                },
+            [InputKeyOk] =
+                {
+                    [InputTypeShort] = pomodoro_key_start,
+                    [InputTypeLong] = pomodoro_key_profiles,
+                },
+            [InputKeyBack] =
+                {
+                    [InputTypeShort] = pomodoro_key_stats,
+                    [InputTypeLong] = pomodoro_key_exit,
+                },
+        },
+};
+
+//the stats screen pages through the weeks, the run keeps going behind it
+static const AppHandlers pomodoro_stats_handlers = {
+    .tick = NULL,
+    .worker = pomodoro_loaded,
+    .keys =
+        {
+            [InputKeyRight] =
+                {
+                    [InputTypePress] = pomodoro_key_stats_week,
+                },
+            [InputKeyLeft] =
+                {
+                    [InputTypePress] = pomodoro_key_stats_week,
+                },
+#ifdef APP_PROFILE
+            [InputKeyOk] =
+                {
+                    [InputTypeLong] = pomodoro_key_overlay,
+                },
+#endif
+            [InputKeyBack] =
+                {
+                    [InputTypeShort] = pomodoro_key_stats,
+                    [InputTypeLong] = pomodoro_key_exit,
+                },
+        },
+};
+
+//the profiles screen switches the settings between the profiles, adds and renames them
+static const AppHandlers pomodoro_profiles_handlers = {
+    .tick = NULL,
+    .worker = pomodoro_loaded,
+    .keys =
+        {
+            [InputKeyUp] =
+                {
+                    [InputTypePress] = pomodoro_key_profile_switch,
+                    [InputTypeRepeat] = pomodoro_key_profile_switch,
+                },
+            [InputKeyDown] =
+                {
+                    [InputTypePress] = pomodoro_key_profile_switch,
+                    [InputTypeRepeat] = pomodoro_key_profile_switch,
+                },
+            [InputKeyLeft] = {[InputTypeShort] = pomodoro_key_profile_create},
+            [InputKeyRight] = {[InputTypeShort] = pomodoro_key_profile_rename},
+            [InputKeyOk] = {[InputTypeShort] = pomodoro_key_profiles_close},
+            [InputKeyBack] =
+                {
+                    [InputTypeShort] = pomodoro_key_profiles_close,
+                    [InputTypeLong] = pomodoro_key_exit,
+                },
+        },
+};
+
+//renaming edits the name one character at a time
+static const AppHandlers pomodoro_rename_handlers = {
+    .tick = NULL,
+    .worker = pomodoro_loaded,
+    .keys =
+        {
+            [InputKeyUp] =
+                {
+                    [InputTypePress] = pomodoro_key_rename_character,
+                    [InputTypeRepeat] = pomodoro_key_rename_character,
+                },
+            [InputKeyDown] =
+                {
+                    [InputTypePress] = pomodoro_key_rename_character,
+                    [InputTypeRepeat] = pomodoro_key_rename_character,
+                },
+            [InputKeyLeft] =
+                {
+                    [InputTypePress] = pomodoro_key_rename_move,
+                    [InputTypeRepeat] = pomodoro_key_rename_move,
+                },
+            [InputKeyRight] =
+                {
+                    [InputTypePress] = pomodoro_key_rename_move,
+                    [InputTypeRepeat] = pomodoro_key_rename_move,
+                },
+            [InputKeyOk] = {[InputTypeShort] = pomodoro_key_rename_save},
+            [InputKeyBack] =
+                {
+                    [InputTypeShort] = pomodoro_key_rename_cancel,
+                    [InputTypeLong] = pomodoro_key_exit,
+                },
+        },
+};
+
+static const AppHandlers* const pomodoro_screens[PomodoroScreenCount] = {
+    [PomodoroScreenRun] = &pomodoro_handlers,
+    [PomodoroScreenStats] = &pomodoro_stats_handlers,
+    [PomodoroScreenProfiles] = &pomodoro_profiles_handlers,
+    [PomodoroScreenRename] = &pomodoro_rename_handlers,
+};
+
+/**
+ * Hands an event to the handlers of the shown screen. Any key press ends the alert and takes the name of a named
+ * timer away, also one that was held back while loading, the key still does what it does.
+ *
+ * @param app app
+ * @param event event to handle
+ */
+static void pomodoro_dispatch(PomodoroApp* app, const AppEvent* event) {
+    if(event->type == AppEventTypeKey && event->input.type == InputTypePress) {
+        if(app->alerts) pomodoro_alerts_cancel(app->alerts);
+        if(app->alert[0]) {
+            app->alert[0] = '\0';
+            app->update = true;
+        }
+    }
+    app_runtime_dispatch(pomodoro_screens[app->screen], app, event);
+}
+
+#ifdef APP_TRACE
+/**
+ * Values of the run a trace starts from and ends with, the times of the run are left out as they depend on the
+ * start of the app
+ */
+typedef struct {
+    uint32_t durations[PomodoroStateCount];
+    uint32_t cycle;
+    uint32_t count;
+    uint32_t runElapsed;
+    uint32_t repetitions;
+    uint32_t totalruns;
+    uint8_t state;
+    uint8_t running;
+    uint8_t notification;
+    uint8_t selected;
+} PomodoroTraceState;
+
+/**
+ * @param pomodoro object that stores the current status
+ * @param state values to be filled
+ */
+static void pomodoro_trace_fill(const Pomodoro* const pomodoro, PomodoroTraceState* state) {
+    *state = (PomodoroTraceState){
+        .cycle = pomodoro->cycle,
+        .count = pomodoro->count,
+        .runElapsed = pomodoro->runElapsed,
+        .repetitions = pomodoro->repetitions,
+        .totalruns = pomodoro->totalruns,
+        .state = pomodoro->state,
+        .running = pomodoro->running,
+        .notification = pomodoro->notification,
+        .selected = pomodoro->selected,
+    };
+    memcpy(state->durations, pomodoro->durations, sizeof(state->durations));
+}
+
+/**
+ * Saves the run with the recording, a replay starts from the run that was recorded instead
+ *
+ * @param pomodoro object that stores the current status
+ */
+static void pomodoro_trace_state(Pomodoro* const pomodoro) {
+    PomodoroTraceState state;
+    pomodoro_trace_fill(pomodoro, &state);
+    app_trace_state(&app_trace, &state, sizeof(state));
+
+    memcpy(pomodoro->durations, state.durations, sizeof(pomodoro->durations));
+    pomodoro->count = state.count;
+    pomodoro->runElapsed = state.runElapsed;
+    pomodoro->repetitions = state.repetitions;
+    pomodoro_phase_set_cycle(pomodoro, state.cycle);
+    pomodoro->totalruns = state.totalruns;
+    pomodoro_phase_set(pomodoro, state.state);
+    pomodoro->running = state.running;
+    pomodoro->notification = state.notification;
+    pomodoro->selected = state.selected < PomodoroStateCount ? (PomodoroState)state.selected : pomodoro->state;
+}
+
+/**
+ * @param pomodoro object that stores the current status
+ *
+ * @return checksum of the run, equal for a recording and its replay
+ */
+static uint32_t pomodoro_trace_digest(const Pomodoro* const pomodoro) {
+    PomodoroTraceState state;
+    pomodoro_trace_fill(pomodoro, &state);
+    return app_crc32(0, &state, sizeof(state));
+}
+#endif
+
 /**
  * main entry point of the app, handles the allocation and deallocation of the variables
  *
@@ -149,167 +1254,145 @@ static void pomodoro_stop_notification(Pomodoro* const pomodoro){
 int32_t pomodoro_app(void* p) {
     UNUSED(p);
 
-    Pomodoro* pomodoro = malloc(sizeof(Pomodoro));
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(PomodoroEvent));
+#ifdef APP_PROFILE
+    //started first, so the time to the first frame covers loading the files
+    app_profile_init(&profile);
+#endif
+#ifdef APP_TRACE
+    app_trace_start(&app_trace, "Pomodoro");
+#endif
+    Pomodoro* pomodoro = APP_ALLOC(sizeof(Pomodoro));
 
-    pomodoro->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+#ifdef APP_PROFILE
+    pomodoro_file_profile(&profile.file);
+#endif
+    //saves are written behind the back of the loop, which only waits for the values to be copied
+    pomodoro_file_start();
+    //the first frame shows the defaults, the config is taken over once the worker has loaded it
+    pomodoro_get_default_values(pomodoro);
 
-    if(!pomodoro->mutex) {
-        FURI_LOG_E("Pomodoro", "cannot create mutex\r\n");
-        free(pomodoro);
-        return 255;
-    }
+    AppSnapshot* snapshot = app_snapshot_alloc(sizeof(PomodoroFrame));
+    PomodoroApp app = {
+        .pomodoro = pomodoro,
+        .runtime = app_runtime_alloc(draw_callback, snapshot),
+        //a replay runs as fast as it can, its alerts would only be noise
+        .alerts = app_trace_replaying() ? NULL : pomodoro_alerts_alloc(),
+    };
+    FuriTimer* timer = app_runtime_timer_alloc(app.runtime, FuriTimerTypeOnce);
+#ifdef APP_PROFILE
+    //set before the load worker starts, it samples the queue when it posts that it is done
+    app.runtime->profile = &profile;
+#endif
+
+#ifdef APP_TRACE
+    //a trace starts from the loaded run, so the loop waits for it before the first event
+    pomodoro_load_start(&app, false);
+    pomodoro_loaded(&app);
+    pomodoro_trace_state(pomodoro);
+#else
+    pomodoro_load_start(&app, true);
+#endif
+    pomodoro->pausedTime = 0;
+    pomodoro->runStart = app_clock();
+    pomodoro->pauseStart = pomodoro->runStart;
+    pomodoro_schedule(pomodoro, app.timers, pomodoro_now(), timer);
+
+    pomodoro_publish(&app, snapshot);
+
+    app_runtime_show(app.runtime);
+
+    AppEvent event;
+    while(app_runtime_wait(app.runtime, &event)) {
+        //keys pressed while loading are handled on top of the loaded config, further ones are dropped
+        if(app.load && event.type == AppEventTypeKey) {
+            if(app.deferred_count < POMODORO_DEFERRED) app.deferred[app.deferred_count++] = event;
+            continue;
+        }
+        APP_PROFILE_START(event_start);
+
+        const PomodoroState state = pomodoro->state;
+        const uint32_t repetitions = pomodoro->repetitions;
+        const uint32_t count = pomodoro->count;
+        const bool running = pomodoro->running;
+        const bool notification = pomodoro->notification;
+
+        app.update = false;
+        pomodoro_dispatch(&app, &event);
+        if(event.type == AppEventTypeWorker) {
+            for(uint8_t i = 0; i < app.deferred_count; i++) pomodoro_dispatch(&app, &app.deferred[i]);
+            app.deferred_count = 0;
+        }
+
+        //named timers that are up are taken off the heap, the last one is shown
+        const uint32_t now = pomodoro_now();
+        PomodoroTimer expired;
+        while(app.timers && pomodoro_timers_expire(app.timers, now, &expired)) {
+            strlcpy(app.alert, expired.name, sizeof(app.alert));
+            if(app.alerts) pomodoro_alerts_start(app.alerts);
+            app.update = true;
+        }
+        //a tick may be the next minute of a named timer
+        if(event.type == AppEventTypeTick && app.timers && pomodoro_timers_count(app.timers)) {
+            app.update = true;
+        }
+
+        //ticks only arm the next wake up, key presses may have started, paused or reset the run
+        if(pomodoro_schedule(pomodoro, app.timers, now, timer)) {
+            app.update = true;
+        }
+        //the alerts play on their own thread, starting them only wakes it up
+        if(app.alerts && pomodoro->notification && !notification) pomodoro_alerts_start(app.alerts);
+
+        //the frame is published before the redraw is requested, so the draw callback never sees an old one
+        if(app.update) {
+            APP_PROFILE_START(publish_start);
+            pomodoro_publish(&app, snapshot);
+            APP_PROFILE_STOP(&profile.publish, publish_start);
+            view_port_update(app.runtime->view_port);
+        }
 
-    pomodoro_get_initial_values(pomodoro);
-
-    ViewPort* view_port = view_port_alloc();
-    view_port_draw_callback_set(view_port, draw_callback, pomodoro);
-    view_port_input_callback_set(view_port, input_callback, event_queue);
-
-    //TODO start timer when is running is true?
-    FuriTimer* timer = furi_timer_alloc(pomodoro_update_timer_callback, FuriTimerTypePeriodic, event_queue);
-    furi_timer_start(timer, furi_ms_to_ticks(1000));
-    uint8_t tick = 0;
-
-    // Open GUI and register view_port
-    Gui* gui = furi_record_open(RECORD_GUI);
-    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
-
-    // Register notifications
-    //NotificationApp* notification = furi_record_open(RECORD_NOTIFICATION);
-
-    PomodoroEvent event;
-    for(bool processing = true; processing;) {
-
-        FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
-
-        furi_mutex_acquire(pomodoro->mutex, FuriWaitForever);
-
-        if(event_status == FuriStatusOk) {
-            // key events
-            if(event.type == EventTypeKey) {
-                if(event.input.type == InputTypeLong){
-                    //close app on long return press
-                    if(event.input.key == InputKeyBack) {
-                        pomodoro_save_current_run(pomodoro);
-                        processing = false;
-                    //if long press down, reset timers
-                    }else if(event.input.key == InputKeyDown) {
-                        pomodoro->endTime = &pomodoro->workTime;
-                        pomodoro->state = workTime;
-                        pomodoro->count = 0;
-                        pomodoro->repetitions = 0;
-                        tick = 0;
-                    }
-                }else if(event.input.type == InputTypePress) {
-                    switch(event.input.key) {
-                        //TODO shorten
-                        //Select previous choosen object in optipns
-                        case InputKeyUp:
-                            if(!pomodoro->running) {
-                                (*pomodoro->endTime)++;
-                            }else if(pomodoro->notification){
-                                pomodoro_stop_notification(pomodoro);
-                            }
-                            break;
-                            //Select next choosen object in options
-                        case InputKeyDown:
-                            if(!pomodoro->running && (*pomodoro->endTime -1) > 0) {
-                                (*pomodoro->endTime)--;
-                            }else if(pomodoro->notification){
-                                pomodoro_stop_notification(pomodoro);
-                            }
-                            break;
-                            //Increase timer for choosen object in options
-                        case InputKeyRight:
-                            //TODO use -- and ++?
-                            if(!pomodoro->running){
-                                if(pomodoro->endTime == &pomodoro->workTime)
-                                    pomodoro->endTime = &pomodoro->shortBreakTime;
-                                else if(pomodoro->endTime == &pomodoro->shortBreakTime)
-                                    pomodoro->endTime = &pomodoro->longBreakTime;
-                                else
-                                    pomodoro->endTime = &pomodoro->workTime;
-                                //switch to next 
-                            }else{
-                                pomodoro_stop_notification(pomodoro);
-                            }
-                            break;
-                            //Decrease timer for choosen object in options, if running stop running
-                        case InputKeyLeft:
-                            if(!pomodoro->running){
-                                if(pomodoro->endTime == &pomodoro->workTime)
-                                    pomodoro->endTime = &pomodoro->longBreakTime;
-                                else if(pomodoro->endTime == &pomodoro->shortBreakTime)
-                                    pomodoro->endTime = &pomodoro->workTime;
-                                else
-                                    pomodoro->endTime = &pomodoro->shortBreakTime;
-                            }else if(pomodoro->notification){
-                                pomodoro_stop_notification(pomodoro);
-                            }
-                            break;
-                            //Stop running
-                        case InputKeyBack:
-                            break;
-                            //Start if is in settings, saving defaults each time, if running stop notification
-                        case InputKeyOk:
-                            if(!pomodoro->running){
-                                pomodoro_save_settings(pomodoro);
-                                switch(pomodoro->state){
-                                    case shortBreakTime:
-                                        pomodoro->endTime = &pomodoro->shortBreakTime;
-                                        break;
-                                    case longBreakTime:
-                                        pomodoro->endTime = &pomodoro->longBreakTime;
-                                        break;
-                                    default:
-                                        pomodoro->endTime = &pomodoro->workTime;
-                                        break;
-                                }
-                                pomodoro->running = true;
-                            }else{
-                                pomodoro->notification = false;
-                                pomodoro->running = false;
-                            }
-                            break;
-                        case InputKeyMAX:
-                            break;
-                    }
-                    view_port_update(view_port);
-                }
-            } else if(event.type == EventTypeTick) {
-                if(pomodoro->running){
-                    if(++tick == 60){
-                        pomodoro->count++;
-                        tick = 0;
-                        view_port_update(view_port);
-                    }
-                    if(!pomodoro->notification && (pomodoro->count) >= *pomodoro->endTime){
-                        pomodoro->notification = true;
-                        view_port_update(view_port);
-                    }
-                    //TURN OF NOTIFICATIONS
-                    //if(pomodoro->notification)
-                        //notification_message(notification, &time_up);
-                }
-            }
+        //each minute and each start, pause or switch of the run is journaled, the writer appends the record
+        if(app.journal && app.runtime->running &&
+           (state != pomodoro->state || repetitions != pomodoro->repetitions || count != pomodoro->count ||
+            running != pomodoro->running)) {
+            pomodoro_save_journal(app.journal, pomodoro, pomodoro_run_elapsed(pomodoro), now);
         }
 
-        furi_mutex_release(pomodoro->mutex);
+        APP_PROFILE_STOP(&profile.event, event_start);
+        if(app.alerts && pomodoro_alerts_active(app.alerts)) {
+            APP_PROFILE_STOP(&profile.alert, event_start);
+        }
     }
 
-    // Wait for all notifications to be played and return backlight to normal state
-    //notification_message_block(notification, &sequence_display_backlight_enforce_auto);
-
-    furi_timer_free(timer);
-    view_port_enabled_set(view_port, false);
-    gui_remove_view_port(gui, view_port);
-    furi_record_close(RECORD_GUI);
-    furi_record_close(RECORD_NOTIFICATION);
-    view_port_free(view_port);
-    furi_message_queue_free(event_queue);
-    furi_mutex_free(pomodoro->mutex);
-    free(pomodoro);
+    //only left while loading if the loop ended early, the worker is joined before the writer stops as it may
+    //queue the first jobs of the helpers
+    pomodoro_loaded(&app);
+    pomodoro_file_stop(furi_ms_to_ticks(POMODORO_FILE_STOP_TIMEOUT));
+
+#ifdef APP_PROFILE
+    app_profile_log("Pomodoro", &profile);
+    app_profile_dump("pomodoro", &profile);
+    pomodoro_file_log_stats();
+    pomodoro_phase_log_stats();
+    FURI_LOG_I("Pomodoro", "input: %" PRIu32 " repeats coalesced", app.runtime->input.coalesced);
+    FURI_LOG_I("Pomodoro", "frames: %" PRIu32 " dropped, %" PRIu32 " delayed", snapshot->dropped, snapshot->delayed);
+    if(app.timers) FURI_LOG_I("Pomodoro", "timers: %u running", pomodoro_timers_count(app.timers));
+#endif
+
+#ifdef APP_TRACE
+    app_trace_stop(&app_trace, "Pomodoro", pomodoro_trace_digest(pomodoro));
+#endif
+
+    if(app.journal) pomodoro_journal_free(app.journal);
+    if(app.history) pomodoro_history_free(app.history);
+    if(app.timers) pomodoro_timers_free(app.timers);
+    if(app.stats) pomodoro_stats_free(app.stats);
+    if(app.profiles) pomodoro_profiles_free(app.profiles);
+    //silences a running alert and closes the notification record it opened
+    if(app.alerts) pomodoro_alerts_free(app.alerts);
+    app_runtime_free(app.runtime);
+    app_snapshot_free(snapshot);
+    APP_FREE(pomodoro);
 
     return 0;
 }
@@ -0,0 +1,63 @@
+#pragma once
+//------------------------------------------------------------------
+// app_arena.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Static allocation mode. With cdefines=["APP_STATIC"] in the application.fam the state of an
+//                   app is placed in one statically sized arena instead of the heap, so its whole RAM footprint is
+//                   known at link time. Without the define APP_ALLOC and APP_FREE are malloc and free.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+
+#define APP_ARENA_ALIGN 8
+
+//size of an arena for allocations of bytes in total, including the alignment padding of each allocation
+#define APP_ARENA_SIZE(bytes, allocations) ((bytes) + (allocations) * (APP_ARENA_ALIGN - 1))
+
+typedef struct {
+    uint8_t* base;
+    size_t size;
+    size_t used;
+    size_t instances; //bytes of the static instances handed out by APP_INSTANCE_ALLOC
+} AppArena;
+
+#ifdef APP_STATIC
+extern AppArena app_arena;
+//defines the arena of the app, to be used once in the file with the entry point
+#define APP_ARENA_DEFINE(arena_size)                                                 \
+    static uint8_t app_arena_storage[arena_size] __attribute__((aligned(APP_ARENA_ALIGN))); \
+    AppArena app_arena = {.base = app_arena_storage, .size = (arena_size), .used = 0}
+#define APP_ALLOC(size) app_arena_alloc(&app_arena, size)
+//the arena is only released with the app
+#define APP_FREE(ptr) UNUSED(ptr)
+//A helper whose struct is private to its file cannot be sized into the arena of the app, as the app does not know
+//its size. It keeps one static instance next to its code instead, so it can only be allocated once at a time.
+#define APP_INSTANCE_DEFINE(type) static type app_instance
+#define APP_INSTANCE_ALLOC(type) (app_arena.instances += sizeof(type), &app_instance)
+#define APP_INSTANCE_FREE(ptr) UNUSED(ptr)
+#else
+#define APP_ARENA_DEFINE(arena_size)
+#define APP_ALLOC(size) malloc(size)
+#define APP_FREE(ptr) free(ptr)
+#define APP_INSTANCE_DEFINE(type) _Static_assert(sizeof(type) > 0, #type " is complete")
+#define APP_INSTANCE_ALLOC(type) ((type*)malloc(sizeof(type)))
+#define APP_INSTANCE_FREE(ptr) free(ptr)
+#endif
+
+/**
+ * Hands out the next aligned block of the arena, crashes if the arena is too small
+ *
+ * @param arena arena to allocate from
+ * @param size size of the block
+ *
+ * @return zeroed block
+ */
+static inline void* app_arena_alloc(AppArena* arena, size_t size) {
+    const size_t start = (arena->used + APP_ARENA_ALIGN - 1) & ~(size_t)(APP_ARENA_ALIGN - 1);
+    furi_check(start + size <= arena->size);
+    arena->used = start + size;
+    memset(arena->base + start, 0, size);
+    return arena->base + start;
+}
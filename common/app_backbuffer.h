@@ -0,0 +1,170 @@
+#pragma once
+//------------------------------------------------------------------
+// app_backbuffer.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Off screen 1 bit per pixel buffer of the 128x64 screen. Spans, boxes and frames are
+//                   drawn 32 pixels at a time and the finished frame is copied to the canvas in one call.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <gui/gui.h>
+
+#define APP_BACKBUFFER_WIDTH 128
+#define APP_BACKBUFFER_HEIGHT 64
+#define APP_BACKBUFFER_WORDS (APP_BACKBUFFER_WIDTH / 32)
+
+/**
+ * Pixel x of a row is bit x % 32 of word x / 32. On the little endian cortex this is the byte order and the
+ * bit order of an xbm image, so the buffer can be passed to the canvas as it is.
+ */
+typedef struct {
+    uint32_t rows[APP_BACKBUFFER_HEIGHT][APP_BACKBUFFER_WORDS];
+} AppBackBuffer;
+
+_Static_assert(sizeof(AppBackBuffer) == 1024, "back buffer must be exactly one frame");
+
+typedef enum {
+    AppBackBufferSet,
+    AppBackBufferClear,
+    AppBackBufferXor,
+} AppBackBufferOp;
+
+/**
+ * Applies the operation to the masked bits of a word
+ *
+ * @param word word to change
+ * @param mask bits to change
+ * @param op operation to apply
+ */
+static inline void app_backbuffer_apply(uint32_t* word, uint32_t mask, AppBackBufferOp op) {
+    switch(op) {
+    case AppBackBufferSet:
+        *word |= mask;
+        break;
+    case AppBackBufferClear:
+        *word &= ~mask;
+        break;
+    case AppBackBufferXor:
+        *word ^= mask;
+        break;
+    }
+}
+
+/**
+ * Clears all pixels
+ *
+ * @param buffer buffer to clear
+ */
+static inline void app_backbuffer_clear(AppBackBuffer* buffer) {
+    memset(buffer->rows, 0, sizeof(buffer->rows));
+}
+
+/**
+ * Changes a single pixel, pixels outside of the screen are ignored
+ *
+ * @param buffer buffer to draw to
+ * @param x column of the pixel
+ * @param y row of the pixel
+ * @param op operation to apply
+ */
+static inline void app_backbuffer_dot(AppBackBuffer* buffer, int16_t x, int16_t y, AppBackBufferOp op) {
+    if(x < 0 || y < 0 || x >= APP_BACKBUFFER_WIDTH || y >= APP_BACKBUFFER_HEIGHT) return;
+    app_backbuffer_apply(&buffer->rows[y][x / 32], 1UL << (x % 32), op);
+}
+
+/**
+ * Changes all pixels of a row from start to end, both included. The span is clipped to the screen, the first
+ * and the last word are masked and all words in between are changed as a whole.
+ *
+ * @param buffer buffer to draw to
+ * @param start first column
+ * @param end last column
+ * @param y row of the span
+ * @param op operation to apply
+ */
+static inline void
+    app_backbuffer_hspan(AppBackBuffer* buffer, int16_t start, int16_t end, int16_t y, AppBackBufferOp op) {
+    if(y < 0 || y >= APP_BACKBUFFER_HEIGHT) return;
+    start = MAX(start, 0);
+    end = MIN(end, APP_BACKBUFFER_WIDTH - 1);
+    if(start > end) return;
+
+    uint32_t* row = buffer->rows[y];
+    const uint8_t first = start / 32;
+    const uint8_t last = end / 32;
+    const uint32_t first_mask = UINT32_MAX << (start % 32);
+    const uint32_t last_mask = UINT32_MAX >> (31 - end % 32);
+
+    if(first == last) {
+        app_backbuffer_apply(&row[first], first_mask & last_mask, op);
+        return;
+    }
+    app_backbuffer_apply(&row[first], first_mask, op);
+    for(uint8_t i = first + 1; i < last; i++) {
+        app_backbuffer_apply(&row[i], UINT32_MAX, op);
+    }
+    app_backbuffer_apply(&row[last], last_mask, op);
+}
+
+/**
+ * Changes all pixels of a rectangle
+ *
+ * @param buffer buffer to draw to
+ * @param x left column
+ * @param y top row
+ * @param width width of the rectangle
+ * @param height height of the rectangle
+ * @param op operation to apply
+ */
+static inline void app_backbuffer_box(
+    AppBackBuffer* buffer,
+    int16_t x,
+    int16_t y,
+    uint8_t width,
+    uint8_t height,
+    AppBackBufferOp op) {
+    if(width == 0) return;
+    for(int16_t row = MAX(y, 0); row < MIN(y + height, APP_BACKBUFFER_HEIGHT); row++) {
+        app_backbuffer_hspan(buffer, x, x + width - 1, row, op);
+    }
+}
+
+/**
+ * Changes the border pixels of a rectangle, each pixel is changed once so it also works with XOR
+ *
+ * @param buffer buffer to draw to
+ * @param x left column
+ * @param y top row
+ * @param width width of the rectangle
+ * @param height height of the rectangle
+ * @param op operation to apply
+ */
+static inline void app_backbuffer_frame(
+    AppBackBuffer* buffer,
+    int16_t x,
+    int16_t y,
+    uint8_t width,
+    uint8_t height,
+    AppBackBufferOp op) {
+    if(width == 0 || height == 0) return;
+    app_backbuffer_hspan(buffer, x, x + width - 1, y, op);
+    if(height == 1) return;
+    app_backbuffer_hspan(buffer, x, x + width - 1, y + height - 1, op);
+    for(int16_t row = y + 1; row < y + height - 1; row++) {
+        app_backbuffer_dot(buffer, x, row, op);
+        if(width > 1) app_backbuffer_dot(buffer, x + width - 1, row, op);
+    }
+}
+
+/**
+ * Draws all set pixels of the buffer in the current color of the canvas
+ *
+ * @param buffer buffer to draw
+ * @param canvas canvas to draw to
+ */
+static inline void app_backbuffer_blit(const AppBackBuffer* buffer, Canvas* canvas) {
+    canvas_draw_xbm(
+        canvas, 0, 0, APP_BACKBUFFER_WIDTH, APP_BACKBUFFER_HEIGHT, (const uint8_t*)buffer->rows);
+}
@@ -0,0 +1,32 @@
+#pragma once
+//------------------------------------------------------------------
+// app_crc32.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Table-less CRC-32 (IEEE 802.3) for the small binary records the apps store
+//-------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Calculates the CRC-32 of a buffer, can be chained by passing the result of the previous call
+ *
+ * @param crc result of the previous call or 0 for the first one
+ * @param data buffer to calculate the checksum of
+ * @param length length of the buffer in bytes
+ *
+ * @return CRC-32 of all buffers so far
+ */
+static inline uint32_t app_crc32(uint32_t crc, const void* data, size_t length) {
+    const uint8_t* bytes = data;
+    crc = ~crc;
+    for(size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
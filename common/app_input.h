@@ -0,0 +1,111 @@
+#pragma once
+//------------------------------------------------------------------
+// app_input.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Coalescing input stage between the input service and the event queue of an app. Repeats
+//                   of a held key are folded into one queued event, so the queue never fills up while a key is
+//                   held, and an acceleration curve turns the folded repeats into a step.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <input/input.h>
+
+/**
+ * Step of a held key, it starts with start for the press and doubles every doubling repeats up to limit
+ */
+typedef struct {
+    uint16_t start;
+    uint16_t limit;
+    uint8_t doubling;
+} AppInputCurve;
+
+typedef struct {
+    uint32_t repeats[InputKeyMAX]; //repeats since the last press, written by the input service
+    uint32_t latched[InputKeyMAX]; //repeats counted when the loop took the last event of the key
+    uint32_t consumed[InputKeyMAX]; //repeats already taken by the loop
+    bool queued[InputKeyMAX]; //a repeat of the key is waiting in the queue
+    uint32_t coalesced; //repeats that were folded into an already queued event
+} AppInput;
+
+/**
+ * @param curve acceleration curve
+ * @param repeat number of the repeat, 0 is the press
+ *
+ * @return step of the repeat
+ */
+static inline uint16_t app_input_step(const AppInputCurve* curve, uint32_t repeat) {
+    const uint32_t doublings = repeat / MAX(curve->doubling, 1);
+    if(doublings >= 16) return curve->limit;
+    return MIN((uint32_t)curve->start << doublings, curve->limit);
+}
+
+/**
+ * Counts the event, to be called by the input callback before it queues the event
+ *
+ * @param input input stage of the app
+ * @param event event received from the input service
+ *
+ * @return false if the event was folded into a repeat that is still queued
+ */
+static inline bool app_input_coalesce(AppInput* input, const InputEvent* event) {
+    if(event->key >= InputKeyMAX) return true;
+    switch(event->type) {
+    case InputTypePress:
+        __atomic_store_n(&input->repeats[event->key], 0, __ATOMIC_RELEASE);
+        return true;
+    case InputTypeLong:
+        __atomic_add_fetch(&input->repeats[event->key], 1, __ATOMIC_ACQ_REL);
+        return true;
+    case InputTypeRepeat:
+        __atomic_add_fetch(&input->repeats[event->key], 1, __ATOMIC_ACQ_REL);
+        if(__atomic_exchange_n(&input->queued[event->key], true, __ATOMIC_ACQ_REL)) {
+            input->coalesced++;
+            return false;
+        }
+        return true;
+    default:
+        return true;
+    }
+}
+
+/**
+ * Latches the number of repeats of the key, to be called by the loop when it takes the event from the queue
+ *
+ * @param input input stage of the app
+ * @param event event taken from the queue
+ */
+static inline void app_input_latch(AppInput* input, const InputEvent* event) {
+    if(event->key >= InputKeyMAX) return;
+    if(event->type == InputTypePress) input->consumed[event->key] = 0;
+    //the flag is cleared before counting, so a repeat counted afterwards queues a new event
+    if(event->type == InputTypeRepeat) {
+        __atomic_store_n(&input->queued[event->key], false, __ATOMIC_RELEASE);
+    }
+    input->latched[event->key] = __atomic_load_n(&input->repeats[event->key], __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Takes the repeats of a key that were latched since the last call, to be called by the handlers of press, long
+ * and repeat events
+ *
+ * @param input input stage of the app
+ * @param curve acceleration curve of the key
+ * @param event event taken from the queue
+ *
+ * @return sum of the steps of all repeats taken, 0 if they were already taken with an earlier event
+ */
+static inline uint32_t
+    app_input_take(AppInput* input, const AppInputCurve* curve, const InputEvent* event) {
+    if(event->key >= InputKeyMAX) return 0;
+    if(event->type == InputTypePress) return app_input_step(curve, 0);
+    const uint32_t repeats = input->latched[event->key];
+    uint32_t amount = 0;
+    //fewer repeats than taken means the key was pressed again, its press resets the taken repeats
+    for(uint32_t repeat = input->consumed[event->key] + 1; repeat <= repeats; repeat++) {
+        amount += app_input_step(curve, repeat);
+    }
+    if(repeats > input->consumed[event->key]) input->consumed[event->key] = repeats;
+    return amount;
+}
@@ -0,0 +1,322 @@
+#pragma once
+//------------------------------------------------------------------
+// app_profile.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Lightweight on-device profiling of the event loop and the draw callback.
+//                   Enabled by adding cdefines=["APP_PROFILE"] to the application.fam of an app,
+//                   the results are written to the log and to /ext/apps/misc/<app>_profile.csv when the app
+//                   exits and can be shown live in an overlay.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <furi_hal.h>
+#include <gui/gui.h>
+#include <storage/storage.h>
+#include <inttypes.h>
+#include "app_arena.h"
+
+#define APP_PROFILE_BUCKETS 32
+#define APP_PROFILE_DIR "/ext/apps/misc"
+
+/**
+ * Log2 histogram of cycle counts, bucket i holds the samples in [2^i, 2^(i+1))
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t max;
+    uint64_t total;
+    uint32_t buckets[APP_PROFILE_BUCKETS];
+} AppProfileHistogram;
+
+typedef struct {
+    uint32_t started;
+    uint32_t first_frame; //ticks from the start to the first drawn frame, 0 until it is drawn
+    uint32_t wakeups;
+    uint32_t formats;
+    uint32_t queue_full;
+    uint32_t queue_peak;
+    uint32_t dropped;
+    //smallest stack space left on the threads running the loop, the draw callback and the input callback
+    uint32_t stack_loop;
+    uint32_t stack_draw;
+    uint32_t stack_input;
+    bool overlay; //draw the overlay over the bottom bar
+    AppProfileHistogram event;
+    AppProfileHistogram draw;
+    AppProfileHistogram update;
+    AppProfileHistogram publish; //copying the render state into the snapshot and publishing it
+    AppProfileHistogram file; //config file access
+    AppProfileHistogram alert; //event handling while an alert is playing
+    AppProfileHistogram preset; //switching to a stored profile of the settings
+} AppProfile;
+
+/**
+ * Histograms of the profile by name, in the order they are logged and dumped
+ */
+static const struct {
+    const char* name;
+    size_t offset;
+} app_profile_sections[] = {
+    {"events", offsetof(AppProfile, event)},
+    {"draw", offsetof(AppProfile, draw)},
+    {"update", offsetof(AppProfile, update)},
+    {"publish", offsetof(AppProfile, publish)},
+    {"file", offsetof(AppProfile, file)},
+    {"alert", offsetof(AppProfile, alert)},
+    {"preset", offsetof(AppProfile, preset)},
+};
+
+#ifdef APP_PROFILE
+#define APP_PROFILE_START(name) const uint32_t name = app_profile_cycles()
+#define APP_PROFILE_STOP(histogram, name) app_profile_record(histogram, app_profile_cycles() - name)
+#define APP_PROFILE_COUNT(counter) (counter)++
+#define APP_PROFILE_QUEUE(profile, queue) app_profile_queue(profile, queue)
+#define APP_PROFILE_STACK(counter) app_profile_stack(&(counter))
+#define APP_PROFILE_FRAME(profile) app_profile_frame(profile)
+#else
+#define APP_PROFILE_START(name)
+#define APP_PROFILE_STOP(histogram, name)
+#define APP_PROFILE_COUNT(counter)
+#define APP_PROFILE_QUEUE(profile, queue)
+#define APP_PROFILE_STACK(counter)
+#define APP_PROFILE_FRAME(profile)
+#endif
+
+/**
+ * @return current value of the cortex cycle counter
+ */
+static inline uint32_t app_profile_cycles(void) {
+    return DWT->CYCCNT;
+}
+
+/**
+ * Resets all histograms and remembers the start of the measurement
+ *
+ * @param profile profile to reset
+ */
+static inline void app_profile_init(AppProfile* profile) {
+    memset(profile, 0, sizeof(AppProfile));
+    profile->started = furi_get_tick();
+    profile->stack_loop = UINT32_MAX;
+    profile->stack_draw = UINT32_MAX;
+    profile->stack_input = UINT32_MAX;
+}
+
+/**
+ * Samples the stack space that was never used on the calling thread. The high water mark covers everything the
+ * thread ran so far, for the gui and input threads this includes the other views as well.
+ *
+ * @param counter smallest stack space seen so far
+ */
+static inline void app_profile_stack(uint32_t* counter) {
+    const uint32_t space = furi_thread_get_stack_space(furi_thread_get_current_id());
+    if(space < *counter) *counter = space;
+}
+
+/**
+ * Remembers when the first frame was drawn, to be called by the draw callback
+ *
+ * @param profile profile to update
+ */
+static inline void app_profile_frame(AppProfile* profile) {
+    if(!profile->first_frame) profile->first_frame = MAX(furi_get_tick() - profile->started, 1UL);
+}
+
+/**
+ * Adds one sample to the histogram
+ *
+ * @param histogram histogram to add the sample to
+ * @param cycles duration of the sample in cpu cycles
+ */
+static inline void app_profile_record(AppProfileHistogram* histogram, uint32_t cycles) {
+    histogram->count++;
+    histogram->total += cycles;
+    if(cycles > histogram->max) histogram->max = cycles;
+    histogram->buckets[31 - __builtin_clz(cycles | 1)]++;
+}
+
+/**
+ * Samples the fill level of the event queue, to be called right before an event is put into it
+ *
+ * @param profile profile to update
+ * @param queue event queue of the app
+ */
+static inline void app_profile_queue(AppProfile* profile, FuriMessageQueue* queue) {
+    const uint32_t count = furi_message_queue_get_count(queue);
+    if(count > profile->queue_peak) profile->queue_peak = count;
+    if(furi_message_queue_get_space(queue) == 0) profile->queue_full++;
+}
+
+/**
+ * Estimates a percentile from the histogram, the result is the upper bound of the matching bucket
+ *
+ * @param histogram histogram to evaluate
+ * @param percent percentile to look for (0-100)
+ *
+ * @return percentile in cpu cycles
+ */
+static inline uint32_t app_profile_percentile(const AppProfileHistogram* histogram, uint8_t percent) {
+    uint32_t wanted = (uint32_t)(((uint64_t)histogram->count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for(uint8_t i = 0; i < APP_PROFILE_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if(seen >= wanted && seen > 0) {
+            uint32_t upper = (i == 31) ? UINT32_MAX : ((1UL << (i + 1)) - 1);
+            return MIN(upper, histogram->max);
+        }
+    }
+    return histogram->max;
+}
+
+/**
+ * Writes the summary of one histogram to the log
+ *
+ * @param tag log tag of the app
+ * @param name name of the measured section
+ * @param histogram histogram to print
+ */
+static inline void
+    app_profile_log_histogram(const char* tag, const char* name, const AppProfileHistogram* histogram) {
+    const uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    if(histogram->count == 0) {
+        FURI_LOG_I(tag, "%s: no samples", name);
+        return;
+    }
+    const uint64_t total_us = histogram->total / cycles_per_us;
+    FURI_LOG_I(
+        tag,
+        "%s: n=%" PRIu32 " %" PRIu32 "/s avg=%" PRIu32 "us p50=%" PRIu32 "us p90=%" PRIu32 "us p99=%" PRIu32 "us max=%" PRIu32 "us",
+        name,
+        histogram->count,
+        (uint32_t)(total_us ? (uint64_t)histogram->count * 1000000 / total_us : 0),
+        (uint32_t)(total_us / histogram->count),
+        app_profile_percentile(histogram, 50) / cycles_per_us,
+        app_profile_percentile(histogram, 90) / cycles_per_us,
+        app_profile_percentile(histogram, 99) / cycles_per_us,
+        histogram->max / cycles_per_us);
+}
+
+/**
+ * Writes the summary of the profile to the log
+ *
+ * @param tag log tag of the app
+ * @param profile profile to print
+ */
+static inline void app_profile_log(const char* tag, const AppProfile* profile) {
+    const uint32_t seconds = (furi_get_tick() - profile->started) / furi_kernel_get_tick_frequency();
+    FURI_LOG_I(
+        tag,
+        "profile over %" PRIu32 "s, %" PRIu32 " wakeups (%" PRIu32 "/h), %" PRIu32 " texts formatted",
+        seconds,
+        profile->wakeups,
+        seconds ? (uint32_t)((uint64_t)profile->wakeups * 3600 / seconds) : 0,
+        profile->formats);
+    FURI_LOG_I(
+        tag,
+        "first frame after %" PRIu32 "ms",
+        (uint32_t)((uint64_t)profile->first_frame * 1000 / furi_kernel_get_tick_frequency()));
+    FURI_LOG_I(
+        tag,
+        "queue: peak %" PRIu32 ", full %" PRIu32 " times, %" PRIu32 " events dropped",
+        profile->queue_peak,
+        profile->queue_full,
+        profile->dropped);
+    FURI_LOG_I(
+        tag,
+        "stack never used: loop %" PRIu32 ", draw %" PRIu32 ", input %" PRIu32 " bytes",
+        profile->stack_loop,
+        profile->stack_draw,
+        profile->stack_input);
+#ifdef APP_STATIC
+    FURI_LOG_I(
+        tag,
+        "arena: %" PRIu32 " of %" PRIu32 " bytes used, %" PRIu32 " bytes of static helper instances",
+        (uint32_t)app_arena.used,
+        (uint32_t)app_arena.size,
+        (uint32_t)app_arena.instances);
+#endif
+    for(size_t i = 0; i < COUNT_OF(app_profile_sections); i++) {
+        const AppProfileHistogram* histogram =
+            (const AppProfileHistogram*)((const uint8_t*)profile + app_profile_sections[i].offset);
+        if(histogram->count) app_profile_log_histogram(tag, app_profile_sections[i].name, histogram);
+    }
+}
+
+/**
+ * Draws the median and the 99th percentile of the event and draw times over the bottom 10 px of the screen
+ *
+ * @param canvas canvas to draw to
+ * @param profile profile to show
+ */
+static inline void app_profile_overlay(Canvas* canvas, const AppProfile* profile) {
+    const uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    char text[32];
+    snprintf(
+        text,
+        sizeof(text),
+        "ev %" PRIu32 "/%" PRIu32 " dr %" PRIu32 "/%" PRIu32 " us",
+        app_profile_percentile(&profile->event, 50) / cycles_per_us,
+        app_profile_percentile(&profile->event, 99) / cycles_per_us,
+        app_profile_percentile(&profile->draw, 50) / cycles_per_us,
+        app_profile_percentile(&profile->draw, 99) / cycles_per_us);
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_box(canvas, 0, 54, 128, 10);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 1, 63, text);
+}
+
+/**
+ * Writes all histograms with their buckets to /ext/apps/misc/<name>_profile.csv, one line per histogram, all
+ * times in cpu cycles
+ *
+ * @param name name of the app
+ * @param profile profile to dump
+ *
+ * @return true if the file was written
+ */
+static inline bool app_profile_dump(const char* name, const AppProfile* profile) {
+    //kept off the stack of the app, the dump only runs on its thread
+    static char line[512];
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    storage_simply_mkdir(storage, APP_PROFILE_DIR);
+
+    snprintf(line, sizeof(line), APP_PROFILE_DIR "/%s_profile.csv", name);
+    bool success = storage_file_open(file, line, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    int length = snprintf(line, sizeof(line), "section,count,total,max,p50,p90,p99");
+    for(uint8_t i = 0; i < APP_PROFILE_BUCKETS; i++) {
+        length += snprintf(line + length, sizeof(line) - length, ",b%u", i);
+    }
+    length += snprintf(line + length, sizeof(line) - length, "\n");
+    success = success && storage_file_write(file, line, length) == length;
+
+    for(size_t i = 0; success && i < COUNT_OF(app_profile_sections); i++) {
+        const AppProfileHistogram* histogram =
+            (const AppProfileHistogram*)((const uint8_t*)profile + app_profile_sections[i].offset);
+        length = snprintf(
+            line,
+            sizeof(line),
+            "%s,%" PRIu32 ",%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32,
+            app_profile_sections[i].name,
+            histogram->count,
+            histogram->total,
+            histogram->max,
+            app_profile_percentile(histogram, 50),
+            app_profile_percentile(histogram, 90),
+            app_profile_percentile(histogram, 99));
+        for(uint8_t bucket = 0; bucket < APP_PROFILE_BUCKETS; bucket++) {
+            length += snprintf(line + length, sizeof(line) - length, ",%" PRIu32, histogram->buckets[bucket]);
+        }
+        length += snprintf(line + length, sizeof(line) - length, "\n");
+        success = storage_file_write(file, line, length) == length;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
@@ -0,0 +1,240 @@
+#pragma once
+//------------------------------------------------------------------
+// app_runtime.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Event loop shared by the apps. Owns the event queue, the view port, the gui registration and
+//                   the timer, feeds key presses through the coalescing input stage and dispatches events to a
+//                   constant table of handlers indexed by key and input type.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <gui/gui.h>
+#include <input/input.h>
+#include "app_arena.h"
+#include "app_input.h"
+#include "app_profile.h"
+#include "app_trace.h"
+
+#define APP_RUNTIME_QUEUE_SIZE 8
+
+typedef enum {
+    AppEventTypeTick,
+    AppEventTypeKey,
+    AppEventTypeWorker, //a worker thread of the app finished, posted with app_runtime_post
+} AppEventType;
+
+typedef struct {
+    AppEventType type;
+    InputEvent input;
+} AppEvent;
+
+typedef void (*AppKeyHandler)(void* ctx, const InputEvent* input);
+typedef void (*AppTickHandler)(void* ctx);
+
+/**
+ * Handlers of an app, keys without a handler are ignored. Declared static const, so the table lives in flash and
+ * dispatching is one lookup and one call.
+ */
+typedef struct {
+    AppTickHandler tick;
+    AppTickHandler worker;
+    AppKeyHandler keys[InputKeyMAX][InputTypeMAX];
+} AppHandlers;
+
+typedef struct {
+    FuriMessageQueue* queue;
+    ViewPort* view_port;
+    Gui* gui; //set once the view port is shown
+    FuriTimer* timer;
+    AppInput input;
+    bool running;
+#ifdef APP_PROFILE
+    AppProfile* profile;
+#endif
+} AppRuntime;
+
+/**
+ * Queues the input event unless it was folded into a repeat that is still queued
+ *
+ * @param input_event input event to add
+ * @param ctx runtime of the app
+ */
+static inline void app_runtime_input_callback(InputEvent* input_event, void* ctx) {
+    AppRuntime* runtime = ctx;
+    furi_assert(runtime);
+    //a replay only handles the recorded keys
+    if(app_trace_replaying()) return;
+    if(!app_input_coalesce(&runtime->input, input_event)) return;
+
+    AppEvent event = {.type = AppEventTypeKey, .input = *input_event};
+    APP_PROFILE_QUEUE(runtime->profile, runtime->queue);
+    APP_PROFILE_STACK(runtime->profile->stack_input);
+    furi_message_queue_put(runtime->queue, &event, FuriWaitForever);
+}
+
+/**
+ * Queues a tick, a full queue drops it instead of blocking the timer service
+ *
+ * @param ctx runtime of the app
+ */
+static inline void app_runtime_timer_callback(void* ctx) {
+    AppRuntime* runtime = ctx;
+    furi_assert(runtime);
+    if(app_trace_replaying()) return;
+
+    AppEvent event = {.type = AppEventTypeTick};
+    APP_PROFILE_QUEUE(runtime->profile, runtime->queue);
+    if(furi_message_queue_put(runtime->queue, &event, 0) != FuriStatusOk) {
+        APP_PROFILE_COUNT(runtime->profile->dropped);
+    }
+}
+
+/**
+ * Queues an event from another thread of the app, blocks while the queue is full
+ *
+ * @param runtime runtime of the app
+ * @param type type of the event, without input
+ */
+static inline void app_runtime_post(AppRuntime* runtime, AppEventType type) {
+    AppEvent event = {.type = type};
+    APP_PROFILE_QUEUE(runtime->profile, runtime->queue);
+    furi_message_queue_put(runtime->queue, &event, FuriWaitForever);
+}
+
+/**
+ * Allocates the queue and the view port, the view port is not shown until app_runtime_show
+ *
+ * @param draw_callback draw callback of the view port
+ * @param draw_ctx context of the draw callback
+ *
+ * @return runtime
+ */
+static inline AppRuntime* app_runtime_alloc(ViewPortDrawCallback draw_callback, void* draw_ctx) {
+    AppRuntime* runtime = APP_ALLOC(sizeof(AppRuntime));
+    memset(runtime, 0, sizeof(AppRuntime));
+    runtime->queue = furi_message_queue_alloc(APP_RUNTIME_QUEUE_SIZE, sizeof(AppEvent));
+    runtime->view_port = view_port_alloc();
+    view_port_draw_callback_set(runtime->view_port, draw_callback, draw_ctx);
+    view_port_input_callback_set(runtime->view_port, app_runtime_input_callback, runtime);
+    runtime->running = true;
+    return runtime;
+}
+
+/**
+ * Allocates the timer of the app, its ticks are dispatched to the tick handler
+ *
+ * @param runtime runtime of the app
+ * @param type one shot or periodic
+ *
+ * @return timer, freed with the runtime
+ */
+static inline FuriTimer* app_runtime_timer_alloc(AppRuntime* runtime, FuriTimerType type) {
+    furi_assert(!runtime->timer);
+    runtime->timer = furi_timer_alloc(app_runtime_timer_callback, type, runtime);
+    return runtime->timer;
+}
+
+/**
+ * Registers the view port with the gui, from now on the app gets drawn and receives input
+ *
+ * @param runtime runtime of the app
+ */
+static inline void app_runtime_show(AppRuntime* runtime) {
+    runtime->gui = furi_record_open(RECORD_GUI);
+    gui_add_view_port(runtime->gui, runtime->view_port, GuiLayerFullscreen);
+}
+
+/**
+ * Stops the timer, removes the view port from the gui and frees everything the runtime owns
+ *
+ * @param runtime runtime to be freed
+ */
+static inline void app_runtime_free(AppRuntime* runtime) {
+    furi_assert(runtime);
+    if(runtime->timer) furi_timer_free(runtime->timer);
+    view_port_enabled_set(runtime->view_port, false);
+    if(runtime->gui) {
+        gui_remove_view_port(runtime->gui, runtime->view_port);
+        furi_record_close(RECORD_GUI);
+    }
+    view_port_free(runtime->view_port);
+    furi_message_queue_free(runtime->queue);
+    APP_FREE(runtime);
+}
+
+/**
+ * Ends the loop after the current event
+ *
+ * @param runtime runtime of the app
+ */
+static inline void app_runtime_exit(AppRuntime* runtime) {
+    runtime->running = false;
+}
+
+/**
+ * Blocks until the next event arrives, the loop only wakes up for key presses and ticks
+ *
+ * @param runtime runtime of the app
+ * @param event next event
+ *
+ * @return false once the app was asked to exit
+ */
+static inline bool app_runtime_wait(AppRuntime* runtime, AppEvent* event) {
+#ifdef APP_TRACE
+    if(app_trace.replaying) {
+        uint8_t type;
+        uint32_t repeats;
+        if(runtime->running && app_trace_next(&app_trace, &type, &event->input, &repeats)) {
+            event->type = type;
+            //the live input is ignored, so the recorded count is the one latched
+            if(type == AppEventTypeKey && event->input.key < InputKeyMAX) {
+                runtime->input.repeats[event->input.key] = repeats;
+                app_input_latch(&runtime->input, &event->input);
+            }
+            return true;
+        }
+        runtime->running = false;
+        return false;
+    }
+#endif
+    while(runtime->running) {
+        //sampled before blocking, the stack of the previous event is in the high water mark
+        APP_PROFILE_STACK(runtime->profile->stack_loop);
+        if(furi_message_queue_get(runtime->queue, event, FuriWaitForever) == FuriStatusOk) {
+            APP_PROFILE_COUNT(runtime->profile->wakeups);
+            if(event->type == AppEventTypeKey) app_input_latch(&runtime->input, &event->input);
+#ifdef APP_TRACE
+            app_trace_record(
+                &app_trace,
+                event->type,
+                &event->input,
+                event->input.key < InputKeyMAX ? runtime->input.latched[event->input.key] : 0);
+#endif
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Calls the handler of the event
+ *
+ * @param handlers handlers of the app
+ * @param ctx context passed to the handler
+ * @param event event to dispatch
+ */
+static inline void app_runtime_dispatch(const AppHandlers* handlers, void* ctx, const AppEvent* event) {
+    if(event->type == AppEventTypeTick) {
+        if(handlers->tick) handlers->tick(ctx);
+        return;
+    }
+    if(event->type == AppEventTypeWorker) {
+        if(handlers->worker) handlers->worker(ctx);
+        return;
+    }
+    if(event->input.key >= InputKeyMAX || event->input.type >= InputTypeMAX) return;
+    const AppKeyHandler handler = handlers->keys[event->input.key][event->input.type];
+    if(handler) handler(ctx, &event->input);
+}
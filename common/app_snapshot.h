@@ -0,0 +1,98 @@
+#pragma once
+//------------------------------------------------------------------
+// app_snapshot.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Lock free triple buffer to hand the render state from the event loop to the draw callback.
+//                   The loop fills the back slot and publishes it, the draw callback picks up the newest
+//                   published slot. Neither side ever waits for the other.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include "app_arena.h"
+
+//bit of the middle slot that marks it as not picked up by the reader yet
+#define APP_SNAPSHOT_FRESH 0x4
+#define APP_SNAPSHOT_INDEX 0x3
+#define APP_SNAPSHOT_SLOTS 3
+//arena bytes and allocations of a snapshot of the given state
+#define APP_SNAPSHOT_BYTES(size) (sizeof(AppSnapshot) + APP_SNAPSHOT_SLOTS * (size))
+#define APP_SNAPSHOT_ALLOCATIONS 2
+
+typedef struct {
+    size_t size;
+    uint8_t* slots;
+    uint32_t published[3]; //tick each slot was published at
+    uint8_t back; //slot owned by the writer
+    uint8_t front; //slot owned by the reader
+    uint8_t middle; //slot in between, with APP_SNAPSHOT_FRESH if it is newer than the front
+    uint32_t dropped; //published frames replaced before they were drawn
+    uint32_t delayed; //frames drawn later than the delay limit after they were published
+} AppSnapshot;
+
+/**
+ * @param size size of the state that is handed over
+ *
+ * @return snapshot with three zeroed slots
+ */
+static inline AppSnapshot* app_snapshot_alloc(size_t size) {
+    AppSnapshot* snapshot = APP_ALLOC(sizeof(AppSnapshot));
+    memset(snapshot, 0, sizeof(AppSnapshot));
+    snapshot->size = size;
+    snapshot->slots = APP_ALLOC(APP_SNAPSHOT_SLOTS * size);
+    memset(snapshot->slots, 0, APP_SNAPSHOT_SLOTS * size);
+    snapshot->back = 0;
+    snapshot->middle = 1;
+    snapshot->front = 2;
+    return snapshot;
+}
+
+/**
+ * @param snapshot snapshot to be freed
+ */
+static inline void app_snapshot_free(AppSnapshot* snapshot) {
+    APP_FREE(snapshot->slots);
+    APP_FREE(snapshot);
+}
+
+/**
+ * Slot the writer fills before publishing it, it keeps the content of three publishes ago
+ *
+ * @param snapshot snapshot to write to
+ *
+ * @return slot owned by the writer
+ */
+static inline void* app_snapshot_back(AppSnapshot* snapshot) {
+    return snapshot->slots + snapshot->back * snapshot->size;
+}
+
+/**
+ * Publishes the back slot, to be called by the writer only
+ *
+ * @param snapshot snapshot to publish
+ */
+static inline void app_snapshot_publish(AppSnapshot* snapshot) {
+    snapshot->published[snapshot->back] = furi_get_tick();
+    const uint8_t previous =
+        __atomic_exchange_n(&snapshot->middle, snapshot->back | APP_SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    if(previous & APP_SNAPSHOT_FRESH) snapshot->dropped++;
+    snapshot->back = previous & APP_SNAPSHOT_INDEX;
+}
+
+/**
+ * Picks up the newest published slot, to be called by the reader only. The slot stays valid until the next call.
+ *
+ * @param snapshot snapshot to read from
+ * @param delay_limit ticks after publishing a frame counts as delayed
+ *
+ * @return newest published state
+ */
+static inline const void* app_snapshot_acquire(AppSnapshot* snapshot, uint32_t delay_limit) {
+    if(__atomic_load_n(&snapshot->middle, __ATOMIC_ACQUIRE) & APP_SNAPSHOT_FRESH) {
+        snapshot->front = __atomic_exchange_n(&snapshot->middle, snapshot->front, __ATOMIC_ACQ_REL) &
+                          APP_SNAPSHOT_INDEX;
+        if(furi_get_tick() - snapshot->published[snapshot->front] > delay_limit) snapshot->delayed++;
+    }
+    return snapshot->slots + snapshot->front * snapshot->size;
+}
@@ -0,0 +1,242 @@
+#pragma once
+//------------------------------------------------------------------
+// app_trace.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Records every event an app handles into a binary trace and replays it. Enabled with
+//                   cdefines=["APP_TRACE"] in the application.fam. If <app>.replay exists in APP_TRACE_DIR it is
+//                   replayed as fast as possible under a virtual clock, otherwise the session is recorded to
+//                   <app>.trace. Both log a digest of the final state, so a replay can be checked against the
+//                   recording, and a replay logs the handling time of the events.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <input/input.h>
+#include <storage/storage.h>
+#include "app_profile.h"
+
+#define APP_TRACE_DIR "/ext/apps/misc"
+#define APP_TRACE_MAGIC 0x43415254
+#define APP_TRACE_VERSION 1
+//records buffered before they are written, a crash loses at most this many
+#define APP_TRACE_BUFFER 32
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t state_size; //size of the app state following the header
+    uint32_t seed; //seed of rand, so random placements repeat
+} AppTraceHeader;
+
+typedef struct {
+    uint32_t tick; //ticks since the start of the trace
+    uint8_t type; //AppEventType
+    uint8_t key;
+    uint8_t input_type;
+    uint8_t repeats; //repeats of the key latched with the event, saturated after about 40 s of holding it
+} AppTraceRecord;
+
+_Static_assert(sizeof(AppTraceHeader) == 12, "trace header must stay 12 bytes");
+_Static_assert(sizeof(AppTraceRecord) == 8, "trace records must stay 8 bytes");
+
+typedef struct {
+    Storage* storage;
+    File* file;
+    bool replaying;
+    uint16_t state_size; //size of the start state in the replay
+    uint32_t start; //tick the recording started at
+    uint32_t clock; //virtual clock of the replay
+    AppTraceRecord buffer[APP_TRACE_BUFFER];
+    uint8_t buffered; //records in the buffer, while replaying the records read
+    uint8_t position; //next record of the buffer to replay
+    uint32_t events;
+    uint32_t started; //cycles at which the replayed event was handed out, 0 if none
+    AppProfileHistogram latency;
+} AppTrace;
+
+#ifdef APP_TRACE
+extern AppTrace app_trace;
+//defines the trace of the app, to be used once in the file with the entry point
+#define APP_TRACE_DEFINE() AppTrace app_trace
+#else
+#define APP_TRACE_DEFINE()
+#endif
+
+/**
+ * Clock of the app in ticks, while replaying the tick at which the current event was recorded
+ *
+ * @return ticks
+ */
+static inline uint32_t app_clock(void) {
+#ifdef APP_TRACE
+    if(app_trace.replaying) return app_trace.clock;
+#endif
+    return furi_get_tick();
+}
+
+/**
+ * @return true while a trace is replayed, the app should not write its files then
+ */
+static inline bool app_trace_replaying(void) {
+#ifdef APP_TRACE
+    return app_trace.replaying;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Opens the replay of the app if there is one, otherwise starts recording, and seeds rand. To be called before
+ * anything random happens.
+ *
+ * @param trace trace of the app
+ * @param name name of the app, used for the file names
+ */
+static inline void app_trace_start(AppTrace* trace, const char* name) {
+    memset(trace, 0, sizeof(AppTrace));
+    trace->storage = furi_record_open(RECORD_STORAGE);
+    trace->file = storage_file_alloc(trace->storage);
+    trace->start = furi_get_tick();
+
+    char path[64];
+    snprintf(path, sizeof(path), APP_TRACE_DIR "/%s.replay", name);
+    AppTraceHeader header;
+    if(storage_file_open(trace->file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_read(trace->file, &header, sizeof(header)) == sizeof(header) &&
+       header.magic == APP_TRACE_MAGIC && header.version == APP_TRACE_VERSION) {
+        trace->replaying = true;
+        trace->state_size = header.state_size;
+        srand(header.seed);
+        FURI_LOG_I(name, "replaying %s", path);
+        return;
+    }
+    storage_file_close(trace->file);
+
+    header = (AppTraceHeader){
+        .magic = APP_TRACE_MAGIC,
+        .version = APP_TRACE_VERSION,
+        .seed = app_profile_cycles() ^ trace->start,
+    };
+    srand(header.seed);
+    snprintf(path, sizeof(path), APP_TRACE_DIR "/%s.trace", name);
+    storage_simply_mkdir(trace->storage, APP_TRACE_DIR);
+    if(!storage_file_open(trace->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+       storage_file_write(trace->file, &header, sizeof(header)) != sizeof(header)) {
+        FURI_LOG_E(name, "cannot record %s", path);
+        storage_file_close(trace->file);
+    }
+}
+
+/**
+ * Saves the start state of the app with the recording or restores it from the replay. To be called once, right
+ * after app_trace_start.
+ *
+ * @param trace trace of the app
+ * @param state state that is saved or overwritten
+ * @param size size of the state
+ */
+static inline void app_trace_state(AppTrace* trace, void* state, uint16_t size) {
+    if(!storage_file_is_open(trace->file)) return;
+    //a replay of another version of the app ends right away
+    if(trace->replaying) {
+        if(trace->state_size != size || storage_file_read(trace->file, state, size) != size) {
+            FURI_LOG_E("AppTrace", "replay does not match the state of the app");
+            storage_file_close(trace->file);
+        }
+        return;
+    }
+    //the size is part of the header, which is rewritten now that it is known
+    const uint16_t state_size = size;
+    storage_file_seek(trace->file, offsetof(AppTraceHeader, state_size), true);
+    storage_file_write(trace->file, &state_size, sizeof(state_size));
+    storage_file_seek(trace->file, sizeof(AppTraceHeader), true);
+    storage_file_write(trace->file, state, size);
+}
+
+/**
+ * Writes the buffered records to the trace
+ *
+ * @param trace trace of the app
+ */
+static inline void app_trace_flush(AppTrace* trace) {
+    if(trace->buffered && storage_file_is_open(trace->file)) {
+        storage_file_write(trace->file, trace->buffer, trace->buffered * sizeof(AppTraceRecord));
+    }
+    trace->buffered = 0;
+}
+
+/**
+ * Adds an event that was taken from the queue to the recording
+ *
+ * @param trace trace of the app
+ * @param type AppEventType of the event
+ * @param input input of a key event
+ * @param repeats repeats of the key latched with the event
+ */
+static inline void
+    app_trace_record(AppTrace* trace, uint8_t type, const InputEvent* input, uint32_t repeats) {
+    trace->buffer[trace->buffered++] = (AppTraceRecord){
+        .tick = furi_get_tick() - trace->start,
+        .type = type,
+        .key = input->key,
+        .input_type = input->type,
+        .repeats = MIN(repeats, UINT8_MAX),
+    };
+    trace->events++;
+    if(trace->buffered == APP_TRACE_BUFFER) app_trace_flush(trace);
+}
+
+/**
+ * Hands out the next recorded event and moves the virtual clock to its tick. The time since the previous event
+ * was handed out is added to the latency of the replay.
+ *
+ * @param trace trace of the app
+ * @param type AppEventType of the event
+ * @param input input of a key event
+ * @param repeats repeats of the key latched with the event
+ *
+ * @return false at the end of the trace
+ */
+static inline bool app_trace_next(AppTrace* trace, uint8_t* type, InputEvent* input, uint32_t* repeats) {
+    if(trace->started) app_profile_record(&trace->latency, app_profile_cycles() - trace->started);
+
+    if(trace->position == trace->buffered) {
+        trace->position = 0;
+        if(!storage_file_is_open(trace->file)) return false;
+        trace->buffered =
+            storage_file_read(trace->file, trace->buffer, sizeof(trace->buffer)) / sizeof(AppTraceRecord);
+        if(trace->buffered == 0) return false;
+    }
+    const AppTraceRecord* record = &trace->buffer[trace->position++];
+    trace->clock = record->tick;
+    *type = record->type;
+    input->key = record->key;
+    input->type = record->input_type;
+    *repeats = record->repeats;
+    trace->events++;
+    trace->started = app_profile_cycles();
+    return true;
+}
+
+/**
+ * Finishes the recording or the replay and logs the digest of the final state
+ *
+ * @param trace trace of the app
+ * @param name name of the app, used as log tag
+ * @param digest checksum of the final state of the app
+ */
+static inline void app_trace_stop(AppTrace* trace, const char* name, uint32_t digest) {
+    if(!trace->replaying) app_trace_flush(trace);
+    storage_file_close(trace->file);
+    storage_file_free(trace->file);
+    furi_record_close(RECORD_STORAGE);
+
+    FURI_LOG_I(
+        name,
+        "%s %" PRIu32 " events, final state %08" PRIX32,
+        trace->replaying ? "replayed" : "recorded",
+        trace->events,
+        digest);
+    if(trace->replaying) app_profile_log_histogram(name, "replay", &trace->latency);
+}
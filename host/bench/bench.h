@@ -0,0 +1,103 @@
+#pragma once
+//------------------------------------------------------------------
+// bench.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Reporting shared by the benchmarks of the host build. Results are printed one per line as
+//                   <benchmark> <metric> <value> <unit>, so runs can be compared with diff or a spreadsheet.
+//-------------------------------------------------------------------
+
+#include <host.h>
+#include <inttypes.h>
+#include <time.h>
+
+/**
+ * @param argc arguments of main
+ * @param argv arguments of main
+ * @param fallback count used without an argument
+ *
+ * @return count given as the first argument
+ */
+static inline uint32_t bench_count(int argc, char** argv, uint32_t fallback) {
+    return argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : fallback;
+}
+
+/**
+ * @return nanoseconds of the monotonic clock of the host
+ */
+static inline uint64_t bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Prints one result
+ *
+ * @param bench name of the benchmark
+ * @param metric what was measured
+ * @param value result
+ * @param unit unit of the result
+ */
+static inline void bench_print(const char* bench, const char* metric, double value, const char* unit) {
+    printf("%-24s %-32s %12.2f %s\n", bench, metric, value, unit);
+}
+
+/**
+ * Prints count, percentiles and maximum of a section of the profile the app dumped on exit, in microseconds
+ *
+ * @param bench name of the benchmark
+ * @param app name of the app
+ * @param section name of the section
+ *
+ * @return true if the section has samples
+ */
+static inline bool bench_section(const char* bench, const char* app, const char* section) {
+    HostProfileSection row;
+    if(!host_profile(app, section, &row) || !row.count) return false;
+    char metric[64];
+    snprintf(metric, sizeof(metric), "%s samples", section);
+    bench_print(bench, metric, row.count, "");
+    snprintf(metric, sizeof(metric), "%s avg", section);
+    bench_print(bench, metric, row.total / (double)row.count / 1000, "us");
+    //the percentiles are the upper bounds of the log2 buckets of the device histograms
+    snprintf(metric, sizeof(metric), "%s p50", section);
+    bench_print(bench, metric, row.p50 / 1000.0, "us");
+    snprintf(metric, sizeof(metric), "%s p90", section);
+    bench_print(bench, metric, row.p90 / 1000.0, "us");
+    snprintf(metric, sizeof(metric), "%s p99", section);
+    bench_print(bench, metric, row.p99 / 1000.0, "us");
+    snprintf(metric, sizeof(metric), "%s max", section);
+    bench_print(bench, metric, row.max / 1000.0, "us");
+    return true;
+}
+
+/**
+ * Prints the frames the gui drew and the time spent in the draw callback
+ *
+ * @param bench name of the benchmark
+ */
+static inline void bench_gui(const char* bench) {
+    const HostGuiStats gui = host_gui_stats();
+    bench_print(bench, "frames", gui.frames, "");
+    if(gui.frames) bench_print(bench, "draw callback avg", gui.draw_ns / (double)gui.frames / 1000, "us");
+    bench_print(bench, "draw callback max", gui.draw_max_ns / 1000.0, "us");
+}
+
+/**
+ * Prints the stack each thread used and the cpu time it took
+ *
+ * @param bench name of the benchmark
+ */
+static inline void bench_threads(const char* bench) {
+    HostThreadStats threads[16];
+    const size_t count = host_threads(threads, COUNT_OF(threads));
+    for(size_t i = 0; i < count; i++) {
+        char metric[64];
+        snprintf(metric, sizeof(metric), "%.24s stack used of %zu", threads[i].name, threads[i].stack_size);
+        bench_print(bench, metric, threads[i].stack_used, "bytes");
+        snprintf(metric, sizeof(metric), "%.24s cpu", threads[i].name);
+        bench_print(bench, metric, threads[i].cpu_ns / 1e6, "ms");
+    }
+}
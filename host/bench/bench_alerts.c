@@ -0,0 +1,94 @@
+//------------------------------------------------------------------
+// bench_alerts.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Latency of the event loop of the Pomodoro app while an alert plays, against the same events
+//                   without one. A named timer of one minute starts the alert, held keys that do not cancel it are
+//                   sent one at a time and the time until the app is idle again is taken on the clock of the host.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Pomodoro/helpers/pomodoro_alerts.h"
+
+#define BENCH_ALERTS_MAX 4096
+
+int32_t pomodoro_app(void* p);
+
+static uint64_t latencies[BENCH_ALERTS_MAX];
+
+static int bench_alerts_compare(const void* a, const void* b) {
+    const uint64_t left = *(const uint64_t*)a;
+    const uint64_t right = *(const uint64_t*)b;
+    return left < right ? -1 : left > right;
+}
+
+/**
+ * Sends repeats of a held key one at a time, they change the minutes but do not cancel an alert. The clock of the
+ * device moves on in between, so the alert plays its repeats meanwhile.
+ *
+ * @param rounds number of events
+ * @param step ms the clock moves on after each event
+ */
+static void bench_alerts_measure(uint32_t rounds, uint32_t step) {
+    for(uint32_t i = 0; i < rounds; i++) {
+        const uint64_t start = bench_now();
+        host_input(i % 2 ? InputKeyUp : InputKeyDown, InputTypeRepeat);
+        furi_check(host_idle());
+        latencies[i] = bench_now() - start;
+        host_run(step);
+    }
+}
+
+/**
+ * Prints median and maximum of the measured latencies
+ */
+static void bench_alerts_report(const char* metric, uint32_t rounds) {
+    qsort(latencies, rounds, sizeof(uint64_t), bench_alerts_compare);
+    char name[64];
+    snprintf(name, sizeof(name), "%s p50", metric);
+    bench_print("alerts", name, latencies[rounds / 2] / 1000.0, "us");
+    snprintf(name, sizeof(name), "%s p99", metric);
+    bench_print("alerts", name, latencies[rounds * 99 / 100] / 1000.0, "us");
+    snprintf(name, sizeof(name), "%s max", metric);
+    bench_print("alerts", name, latencies[rounds - 1] / 1000.0, "us");
+}
+
+int main(int argc, char** argv) {
+    const uint32_t rounds = MIN(bench_count(argc, argv, 1000), BENCH_ALERTS_MAX);
+    //the alert stays active until it gives up after its last repeat
+    const uint32_t step = POMODORO_ALERTS_INTERVAL * (POMODORO_ALERTS_REPEATS - 1) / rounds;
+    host_setup();
+    host_time_scale(0);
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+    furi_check(host_wait_text("OK to start"));
+    furi_check(host_idle());
+
+    bench_alerts_measure(rounds, step);
+    bench_alerts_report("without alert", rounds);
+
+    //a named timer with the minutes of the work interval, set to one minute
+    for(uint32_t i = 0; i < 40; i++) host_press(InputKeyDown);
+    host_hold(InputKeyRight, 0);
+    host_run(60 * 1000);
+    const HostNotificationStats before = host_notification_stats();
+    bench_alerts_measure(rounds, step);
+    const HostNotificationStats after = host_notification_stats();
+    bench_alerts_report("with alert", rounds);
+    bench_print("alerts", "repeats played meanwhile", after.sequences - before.sequences, "");
+
+    //a key press cancels the alert, the notification service plays the rest of it on the clock of the device
+    host_press(InputKeyDown);
+    host_run(1000);
+    host_hold(InputKeyBack, 0);
+    host_app_join();
+
+    //loop time of the events handled while the alert was active
+    HostProfileSection alert;
+    furi_check(host_profile("pomodoro", "alert", &alert));
+    furi_check(alert.count >= rounds);
+    bench_section("alerts", "pomodoro", "alert");
+    bench_section("alerts", "pomodoro", "events");
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------
+// bench_backbuffer.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Draws the same scenes into the back buffer and copies it to the canvas, and pixel by pixel
+//                   with the canvas calls the apps used before. Both have to end with the same pixels. The canvas
+//                   of the host copies the xbm bit by bit, the time of the blit is the most it can take.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Circle_C/helpers/circle_raster.h"
+
+#define BENCH_CIRCLES 100
+
+typedef struct {
+    const char* name;
+    void (*buffered)(AppBackBuffer* buffer);
+    void (*per_pixel)(Canvas* canvas);
+} BenchScene;
+
+static AppBackBuffer buffer;
+
+/**
+ * @return center and radius of the circle i of the scene with many circles
+ */
+static void bench_circle(uint16_t i, uint8_t* x, uint8_t* y, uint8_t* r) {
+    *x = (i * 37) % 128;
+    *y = (i * 23) % 54;
+    *r = 1 + i % 4;
+}
+
+static void bench_outline_buffered(AppBackBuffer* buffer) {
+    app_backbuffer_frame(buffer, 0, 54, 128, 10, AppBackBufferSet);
+    circle_raster_draw(buffer, 64, 27, 20, 128, 54);
+}
+
+static void bench_outline_per_pixel(Canvas* canvas) {
+    canvas_draw_frame(canvas, 0, 54, 128, 10);
+    canvas_draw_circle(canvas, 64, 27, 20);
+}
+
+static void bench_box_buffered(AppBackBuffer* buffer) {
+    app_backbuffer_box(buffer, 5, 5, 118, 44, AppBackBufferSet);
+}
+
+static void bench_box_per_pixel(Canvas* canvas) {
+    canvas_draw_box(canvas, 5, 5, 118, 44);
+}
+
+static void bench_circles_buffered(AppBackBuffer* buffer) {
+    for(uint16_t i = 0; i < BENCH_CIRCLES; i++) {
+        uint8_t x, y, r;
+        bench_circle(i, &x, &y, &r);
+        circle_raster_draw(buffer, x, y, r, 128, 64);
+    }
+}
+
+static void bench_circles_per_pixel(Canvas* canvas) {
+    for(uint16_t i = 0; i < BENCH_CIRCLES; i++) {
+        uint8_t x, y, r;
+        bench_circle(i, &x, &y, &r);
+        canvas_draw_circle(canvas, x, y, r);
+    }
+}
+
+static const BenchScene scenes[] = {
+    {"outline", bench_outline_buffered, bench_outline_per_pixel},
+    {"box", bench_box_buffered, bench_box_per_pixel},
+    {"100 circles", bench_circles_buffered, bench_circles_per_pixel},
+};
+
+int main(int argc, char** argv) {
+    const uint32_t rounds = bench_count(argc, argv, 1000);
+    Canvas* buffered = host_canvas_alloc();
+    Canvas* per_pixel = host_canvas_alloc();
+
+    for(size_t s = 0; s < COUNT_OF(scenes); s++) {
+        const BenchScene* scene = &scenes[s];
+        uint64_t draw = 0;
+        uint64_t blit = 0;
+        uint64_t direct = 0;
+        for(uint32_t i = 0; i < rounds; i++) {
+            uint64_t start = bench_now();
+            app_backbuffer_clear(&buffer);
+            scene->buffered(&buffer);
+            draw += bench_now() - start;
+
+            start = bench_now();
+            canvas_clear(buffered);
+            app_backbuffer_blit(&buffer, buffered);
+            blit += bench_now() - start;
+
+            start = bench_now();
+            canvas_clear(per_pixel);
+            scene->per_pixel(per_pixel);
+            direct += bench_now() - start;
+        }
+
+        for(uint8_t y = 0; y < APP_BACKBUFFER_HEIGHT; y++) {
+            for(uint8_t x = 0; x < APP_BACKBUFFER_WIDTH; x++) {
+                furi_check(host_canvas_pixel(buffered, x, y) == host_canvas_pixel(per_pixel, x, y));
+            }
+        }
+
+        char metric[64];
+        snprintf(metric, sizeof(metric), "%s back buffer draw", scene->name);
+        bench_print("backbuffer", metric, draw / (double)rounds / 1000, "us");
+        snprintf(metric, sizeof(metric), "%s back buffer blit", scene->name);
+        bench_print("backbuffer", metric, blit / (double)rounds / 1000, "us");
+        snprintf(metric, sizeof(metric), "%s per pixel", scene->name);
+        bench_print("backbuffer", metric, direct / (double)rounds / 1000, "us");
+    }
+
+    host_canvas_free(buffered);
+    host_canvas_free(per_pixel);
+    return 0;
+}
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------
+// bench_circle.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Throughput of the event loop of the circle app: moves and resizes the circle with presses and
+//                   held keys as fast as the gui hands them over, then reports events per second, the time each
+//                   event took in the loop and the time of the draw callback.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+
+int32_t circle_app(void* p);
+
+int main(int argc, char** argv) {
+    const uint32_t presses = bench_count(argc, argv, 5000);
+    host_setup();
+    host_time_scale(0);
+    host_app_start("circle", 1024, circle_app);
+    furi_check(host_wait_text("Rad: 5"));
+
+    static const InputKey keys[] = {InputKeyRight, InputKeyLeft, InputKeyDown, InputKeyUp};
+    //all keys are queued at once, the gui hands them over as fast as the loop takes them
+    const uint32_t inputs = host_gui_stats().inputs;
+    const uint64_t start = bench_now();
+    for(uint32_t i = 0; i < presses; i++) {
+        const InputKey key = keys[i % COUNT_OF(keys)];
+        if(i % 8 == 7) {
+            host_hold(key, 3);
+        } else {
+            host_press(key);
+        }
+    }
+    furi_check(host_idle());
+    const uint64_t elapsed = bench_now() - start;
+    const uint32_t flooded = host_gui_stats().inputs - inputs;
+
+    //one key at a time, each event gets its own frame
+    for(uint32_t i = 0; i < presses / 10; i++) {
+        host_press(keys[i % COUNT_OF(keys)]);
+        furi_check(host_idle());
+    }
+
+    host_press(InputKeyBack);
+    host_app_join();
+
+    HostProfileSection events;
+    furi_check(host_profile("circle", "events", &events));
+    bench_print("circle", "key events", flooded, "");
+    bench_print("circle", "events/s", flooded / (elapsed / 1e9), "");
+    bench_section("circle", "circle", "events");
+    bench_section("circle", "circle", "draw");
+    bench_gui("circle");
+    bench_threads("circle");
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------
+// bench_config.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Bytes written and storage calls per save of the Pomodoro config. The single write of the
+//                   current code is compared with a model of the flipper format code it replaced, which looked up
+//                   each key in the file and rewrote the rest of the file for it.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Pomodoro/helpers/pomodoro_file_access.h"
+#include "../../Pomodoro/helpers/pomodoro_journal.h"
+
+/**
+ * @return storage calls counted by the stand-in
+ */
+static uint32_t bench_config_calls(const HostStorageStats* stats) {
+    return stats->opens + stats->reads + stats->writes + stats->seeks + stats->syncs + stats->renames +
+           stats->removes + stats->stats;
+}
+
+/**
+ * Prints bytes written and storage calls per save since the last reset of the counters
+ */
+static void bench_config_report(const char* metric, uint32_t saves, uint64_t elapsed) {
+    const HostStorageStats stats = host_storage_stats();
+    char name[64];
+    snprintf(name, sizeof(name), "%s bytes/save", metric);
+    bench_print("config", name, stats.write_bytes / (double)saves, "bytes");
+    snprintf(name, sizeof(name), "%s calls/save", metric);
+    bench_print("config", name, bench_config_calls(&stats) / (double)saves, "");
+    snprintf(name, sizeof(name), "%s time/save", metric);
+    bench_print("config", name, elapsed / (double)saves / 1000, "us");
+}
+
+/**
+ * Updates one key the way flipper_format_insert_or_update_uint32 did: two stats and an open, a read up to the key
+ * and a rewrite of the file from the key to its end
+ */
+static void bench_config_update_key(Storage* storage, const char* key, uint32_t value) {
+    static char text[512];
+    FileInfo info;
+    storage_common_stat(storage, POMODORO_FILE_DIR_PATH, &info);
+    storage_common_stat(storage, POMODORO_FILE_PATH, &info);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, POMODORO_FILE_PATH, FSAM_READ | FSAM_WRITE, FSOM_OPEN_EXISTING)) {
+        //the stream of flipper format reads in chunks of 64 bytes
+        uint16_t length = 0;
+        uint16_t read;
+        while((read = storage_file_read(file, text + length, MIN(64, sizeof(text) - 1 - length))) > 0) {
+            length += read;
+        }
+        text[length] = '\0';
+        const char* found = strstr(text, key);
+        const uint32_t offset = found ? found - text : length;
+        char line[64];
+        const int line_length = snprintf(line, sizeof(line), "%s: %" PRIu32 "\n", key, value);
+        storage_file_seek(file, offset, true);
+        storage_file_write(file, line, line_length);
+        const char* rest = found ? strchr(found, '\n') : NULL;
+        if(rest && rest[1]) storage_file_write(file, rest + 1, strlen(rest + 1));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+}
+
+int main(int argc, char** argv) {
+    const uint32_t saves = bench_count(argc, argv, 2000);
+    host_setup();
+    Pomodoro pomodoro;
+    pomodoro_get_initial_values(&pomodoro);
+    //the first save creates the directory
+    pomodoro_save_settings(&pomodoro);
+
+    //without the writer each save is written right away, as on the load path
+    host_storage_reset();
+    uint64_t start = bench_now();
+    for(uint32_t i = 0; i < saves; i++) {
+        pomodoro.durations[workTime] = 20 + i % 10;
+        pomodoro_save_settings(&pomodoro);
+    }
+    bench_config_report("settings", saves, bench_now() - start);
+
+    host_storage_reset();
+    start = bench_now();
+    for(uint32_t i = 0; i < saves; i++) {
+        pomodoro.repetitions = i % 4;
+        pomodoro.totalruns = i;
+        pomodoro_save_current_run(&pomodoro);
+    }
+    bench_config_report("run", saves, bench_now() - start);
+
+    host_storage_reset();
+    start = bench_now();
+    for(uint32_t i = 0; i < saves; i++) pomodoro_save_current_run(&pomodoro);
+    bench_config_report("unchanged", saves, bench_now() - start);
+
+    //with the writer saves queued while one is written are folded into it
+    pomodoro_file_start();
+    host_storage_reset();
+    start = bench_now();
+    for(uint32_t i = 0; i < saves; i++) {
+        pomodoro.totalruns = saves + i;
+        pomodoro_save_current_run(&pomodoro);
+    }
+    pomodoro_file_stop(FuriWaitForever);
+    bench_config_report("writer", saves, bench_now() - start);
+
+    //the loop journals each minute of a run, time/save is what the caller waits for. The sd card of the host is a
+    //plain directory, so there the queue costs more than the write, a sync of the device takes milliseconds.
+    PomodoroJournal* journal = pomodoro_journal_alloc();
+    host_storage_reset();
+    start = bench_now();
+    for(uint32_t i = 0; i < saves; i++) pomodoro_save_journal(journal, &pomodoro, i * 60000, i * 60);
+    bench_config_report("journal", saves, bench_now() - start);
+
+    pomodoro_file_start();
+    host_storage_reset();
+    uint64_t queued = 0;
+    for(uint32_t i = 0; i < saves; i++) {
+        start = bench_now();
+        pomodoro_save_journal(journal, &pomodoro, i * 60000, i * 60);
+        queued += bench_now() - start;
+        //a minute passes between two records, the writer is done with the last one
+        host_idle();
+    }
+    pomodoro_file_stop(FuriWaitForever);
+    bench_config_report("journal writer", saves, queued);
+    pomodoro_journal_free(journal);
+
+    //the run took four keyed updates and the settings three, each of them touching the file
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    host_storage_reset();
+    start = bench_now();
+    for(uint32_t i = 0; i < saves; i++) {
+        bench_config_update_key(storage, POMODORO_CONFIG_KEY_COUNT, i % 25);
+        bench_config_update_key(storage, POMODORO_CONFIG_KEY_REPETITIONS, i % 4);
+        bench_config_update_key(storage, POMODORO_CONFIG_KEY_STATE, i % 3);
+        bench_config_update_key(storage, POMODORO_CONFIG_KEY_TOTAL_RUNS, i);
+    }
+    bench_config_report("flipper format run", saves, bench_now() - start);
+    furi_record_close(RECORD_STORAGE);
+
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------
+// bench_dispatch.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Dispatch of the handler table of the shared runtime against the nested switch on key and
+//                   input type it replaced, with the key bindings of the circle app and a mix of all events.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../common/app_runtime.h"
+
+typedef struct {
+    uint32_t resize;
+    uint32_t move;
+    uint32_t mode;
+    uint32_t exit;
+    uint32_t tick;
+} BenchCounts;
+
+static __attribute__((noinline)) void bench_key_resize(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    ((BenchCounts*)ctx)->resize++;
+}
+
+static __attribute__((noinline)) void bench_key_move(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    ((BenchCounts*)ctx)->move++;
+}
+
+static __attribute__((noinline)) void bench_key_mode(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    ((BenchCounts*)ctx)->mode++;
+}
+
+static __attribute__((noinline)) void bench_key_exit(void* ctx, const InputEvent* input) {
+    UNUSED(input);
+    ((BenchCounts*)ctx)->exit++;
+}
+
+static __attribute__((noinline)) void bench_tick(void* ctx) {
+    ((BenchCounts*)ctx)->tick++;
+}
+
+static const AppHandlers bench_handlers = {
+    .tick = bench_tick,
+    .keys =
+        {
+            [InputKeyUp] =
+                {
+                    [InputTypePress] = bench_key_resize,
+                    [InputTypeLong] = bench_key_resize,
+                    [InputTypeRepeat] = bench_key_resize,
+                },
+            [InputKeyDown] =
+                {
+                    [InputTypePress] = bench_key_resize,
+                    [InputTypeLong] = bench_key_resize,
+                    [InputTypeRepeat] = bench_key_resize,
+                },
+            [InputKeyRight] =
+                {
+                    [InputTypePress] = bench_key_move,
+                    [InputTypeLong] = bench_key_move,
+                    [InputTypeRepeat] = bench_key_move,
+                },
+            [InputKeyLeft] =
+                {
+                    [InputTypePress] = bench_key_move,
+                    [InputTypeLong] = bench_key_move,
+                    [InputTypeRepeat] = bench_key_move,
+                },
+            [InputKeyOk] = {[InputTypeShort] = bench_key_mode},
+            [InputKeyBack] = {[InputTypePress] = bench_key_exit},
+        },
+};
+
+/**
+ * Same bindings written as the nested switch the apps had before the table
+ */
+static __attribute__((noinline)) void bench_switch(void* ctx, const AppEvent* event) {
+    switch(event->type) {
+    case AppEventTypeTick:
+        bench_tick(ctx);
+        break;
+    case AppEventTypeKey:
+        switch(event->input.key) {
+        case InputKeyUp:
+        case InputKeyDown:
+            switch(event->input.type) {
+            case InputTypePress:
+            case InputTypeLong:
+            case InputTypeRepeat:
+                bench_key_resize(ctx, &event->input);
+                break;
+            default:
+                break;
+            }
+            break;
+        case InputKeyRight:
+        case InputKeyLeft:
+            switch(event->input.type) {
+            case InputTypePress:
+            case InputTypeLong:
+            case InputTypeRepeat:
+                bench_key_move(ctx, &event->input);
+                break;
+            default:
+                break;
+            }
+            break;
+        case InputKeyOk:
+            if(event->input.type == InputTypeShort) bench_key_mode(ctx, &event->input);
+            break;
+        case InputKeyBack:
+            if(event->input.type == InputTypePress) bench_key_exit(ctx, &event->input);
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static __attribute__((noinline)) void bench_table(void* ctx, const AppEvent* event) {
+    app_runtime_dispatch(&bench_handlers, ctx, event);
+}
+
+#define BENCH_EVENTS 4096
+
+static AppEvent events[BENCH_EVENTS];
+
+/**
+ * @return nanoseconds per event
+ */
+static double bench_dispatch(void (*dispatch)(void* ctx, const AppEvent* event), BenchCounts* counts, uint32_t rounds) {
+    const uint64_t start = bench_now();
+    for(uint32_t round = 0; round < rounds; round++) {
+        for(uint32_t i = 0; i < BENCH_EVENTS; i++) dispatch(counts, &events[i]);
+    }
+    return (bench_now() - start) / ((double)rounds * BENCH_EVENTS);
+}
+
+int main(int argc, char** argv) {
+    const uint32_t rounds = bench_count(argc, argv, 1000);
+    srand(1);
+    for(uint32_t i = 0; i < BENCH_EVENTS; i++) {
+        if(rand() % 8 == 0) {
+            events[i].type = AppEventTypeTick;
+        } else {
+            events[i].type = AppEventTypeKey;
+            events[i].input.key = rand() % InputKeyMAX;
+            events[i].input.type = rand() % InputTypeMAX;
+        }
+    }
+
+    BenchCounts table = {0};
+    BenchCounts nested = {0};
+    const double by_table = bench_dispatch(bench_table, &table, rounds);
+    const double by_switch = bench_dispatch(bench_switch, &nested, rounds);
+    //both have to call the same handlers
+    furi_check(memcmp(&table, &nested, sizeof(BenchCounts)) == 0);
+
+    bench_print("dispatch", "table", by_table, "ns/event");
+    bench_print("dispatch", "switch", by_switch, "ns/event");
+    return 0;
+}
@@ -0,0 +1,61 @@
+//------------------------------------------------------------------
+// bench_memory.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      RAM an app takes when built with APP_STATIC: the arena sized at compile time, the part of it
+//                   that was used, the static instances of its helpers and the stack each of its threads used.
+//                   Built once per app, BENCH_CIRCLE selects the circle app.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../common/app_arena.h"
+
+#ifdef BENCH_CIRCLE
+#define BENCH_APP "circle"
+int32_t circle_app(void* p);
+
+/**
+ * Shows each mode once, up to the largest number of bouncing circles
+ */
+static void bench_memory_session(void) {
+    host_app_start("circle", 1024, circle_app);
+    furi_check(host_wait_text("Rad: 5"));
+    for(uint8_t mode = 0; mode < 5; mode++) {
+        host_press(InputKeyOk);
+        host_run(1000);
+    }
+    host_press(InputKeyBack);
+}
+#else
+#define BENCH_APP "pomodoro"
+int32_t pomodoro_app(void* p);
+
+/**
+ * Runs a work interval for a few minutes and leaves the app
+ */
+static void bench_memory_session(void) {
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+    furi_check(host_wait_text("OK to start"));
+    furi_check(host_idle());
+    host_press(InputKeyOk);
+    host_run(3 * 60 * 1000);
+    host_hold(InputKeyBack, 0);
+}
+#endif
+
+int main(int argc, char** argv) {
+    UNUSED(argc);
+    UNUSED(argv);
+    host_setup();
+    host_time_scale(0);
+    bench_memory_session();
+    host_app_join();
+
+    bench_print(BENCH_APP, "arena size", app_arena.size, "bytes");
+    bench_print(BENCH_APP, "arena used", app_arena.used, "bytes");
+    bench_print(BENCH_APP, "static helper instances", app_arena.instances, "bytes");
+    bench_threads(BENCH_APP);
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,61 @@
+//------------------------------------------------------------------
+// bench_particles.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Bouncing circles of the circle app for each count of its modes: circles simulated per
+//                   millisecond and the part of a 30 fps frame that stepping, publishing and drawing them takes.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Circle_C/helpers/circle_particles.h"
+
+#define BENCH_FPS 30
+
+static AppBackBuffer buffer;
+static uint16_t packed[CIRCLE_PARTICLES_CAPACITY];
+
+int main(int argc, char** argv) {
+    const uint32_t frames = bench_count(argc, argv, 1000);
+    static const uint16_t counts[] = {10, 100, CIRCLE_PARTICLES_CAPACITY};
+    CircleParticles* particles = circle_particles_alloc(CIRCLE_PARTICLES_CAPACITY, 128, 54);
+    srand(1);
+
+    for(size_t c = 0; c < COUNT_OF(counts); c++) {
+        circle_particles_spawn(particles, counts[c]);
+        uint64_t step = 0;
+        uint64_t publish = 0;
+        uint64_t draw = 0;
+        for(uint32_t i = 0; i < frames; i++) {
+            uint64_t start = bench_now();
+            circle_particles_step(particles);
+            step += bench_now() - start;
+
+            start = bench_now();
+            const uint16_t count = circle_particles_snapshot(particles, packed);
+            publish += bench_now() - start;
+
+            start = bench_now();
+            app_backbuffer_clear(&buffer);
+            circle_particles_draw(packed, count, &buffer, 128, 54);
+            draw += bench_now() - start;
+        }
+
+        char metric[64];
+        snprintf(metric, sizeof(metric), "%u circles/ms", counts[c]);
+        bench_print("particles", metric, counts[c] * (double)frames / (step / 1e6), "");
+        snprintf(metric, sizeof(metric), "%u step", counts[c]);
+        bench_print("particles", metric, step / (double)frames / 1000, "us");
+        snprintf(metric, sizeof(metric), "%u publish", counts[c]);
+        bench_print("particles", metric, publish / (double)frames / 1000, "us");
+        snprintf(metric, sizeof(metric), "%u bytes/publish", counts[c]);
+        bench_print("particles", metric, counts[c] * sizeof(uint16_t), "bytes");
+        snprintf(metric, sizeof(metric), "%u draw", counts[c]);
+        bench_print("particles", metric, draw / (double)frames / 1000, "us");
+        snprintf(metric, sizeof(metric), "%u frame budget used", counts[c]);
+        bench_print("particles", metric, (step + publish + draw) / (double)frames * BENCH_FPS / 1e7, "%");
+    }
+
+    circle_particles_free(particles);
+    return 0;
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------
+// bench_phase.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Transitions of the Pomodoro phases per second through the table, and the continuation after a
+//                   closed app, which skips whole cycles, against finishing one interval after the other.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Pomodoro/helpers/pomodoro_phase.h"
+
+//a week with the app closed
+#define BENCH_PHASE_CLOSED (7 * 24 * 60 * 60)
+
+static Pomodoro bench_phase_run(void) {
+    Pomodoro pomodoro = {
+        .durations = {[workTime] = 25, [shortBreakTime] = 5, [longBreakTime] = 15},
+        .cycle = 4,
+        .running = true,
+    };
+    return pomodoro;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t rounds = bench_count(argc, argv, 1000000);
+    static const PomodoroEvent events[] = {
+        PomodoroEventFinish,
+        PomodoroEventNext,
+        PomodoroEventFinish,
+        PomodoroEventPrevious,
+        PomodoroEventFinish,
+        PomodoroEventFinish,
+        PomodoroEventNext,
+        PomodoroEventReset,
+    };
+
+    Pomodoro pomodoro = bench_phase_run();
+    uint64_t start = bench_now();
+    for(uint32_t i = 0; i < rounds; i++) pomodoro_phase_apply(&pomodoro, events[i % COUNT_OF(events)]);
+    const uint64_t transitions = bench_now() - start;
+
+    const uint32_t continues = MAX(rounds / 1000, 1u);
+    start = bench_now();
+    for(uint32_t i = 0; i < continues; i++) {
+        pomodoro = bench_phase_run();
+        pomodoro_phase_continue(&pomodoro, BENCH_PHASE_CLOSED + i);
+    }
+    const uint64_t skipped = bench_now() - start;
+    const Pomodoro continued = pomodoro;
+
+    start = bench_now();
+    for(uint32_t i = 0; i < continues; i++) {
+        pomodoro = bench_phase_run();
+        uint32_t remaining = BENCH_PHASE_CLOSED + i;
+        while(remaining >= pomodoro.durations[pomodoro.state] * 60) {
+            remaining -= pomodoro.durations[pomodoro.state] * 60;
+            pomodoro_phase_apply(&pomodoro, PomodoroEventFinish);
+        }
+    }
+    const uint64_t walked = bench_now() - start;
+    //both have to end in the same interval
+    furi_check(continued.state == pomodoro.state && continued.repetitions == pomodoro.repetitions);
+    furi_check(continued.totalruns == pomodoro.totalruns);
+
+    bench_print("phase", "transitions/s", rounds / (transitions / 1e9), "");
+    bench_print("phase", "continue after a week", skipped / (double)continues / 1000, "us");
+    bench_print("phase", "interval by interval", walked / (double)continues / 1000, "us");
+    return 0;
+}
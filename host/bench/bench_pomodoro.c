@@ -0,0 +1,71 @@
+//------------------------------------------------------------------
+// bench_pomodoro.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Throughput of the event loop of the Pomodoro app: changes the interval times and the chosen
+//                   interval in the settings as fast as the gui hands the keys over, then reports events per
+//                   second, the time each event took in the loop, the time of the draw callback and the time from
+//                   the start of the app to its first frame, on a fresh install that writes nothing.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+
+int32_t pomodoro_app(void* p);
+
+int main(int argc, char** argv) {
+    const uint32_t presses = bench_count(argc, argv, 5000);
+    host_setup();
+    host_time_scale(0);
+    const uint64_t launch = bench_now();
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+    furi_check(host_wait_text("OK to start"));
+    furi_check(host_idle());
+    //the first frame is drawn with the defaults, before the worker has loaded the files
+    const uint64_t first_frame = host_gui_stats().first_frame_ns - launch;
+    //the sd card is empty, the files are only created by their first write
+    const HostStorageStats loaded = host_storage_stats();
+
+    //up and down change the time of the chosen interval, held they change it faster
+    static const InputKey keys[] = {InputKeyUp, InputKeyDown, InputKeyUp, InputKeyDown};
+    //all keys are queued at once, the gui hands them over as fast as the loop takes them
+    const uint32_t inputs = host_gui_stats().inputs;
+    const uint64_t start = bench_now();
+    for(uint32_t i = 0; i < presses; i++) {
+        const InputKey key = keys[i % COUNT_OF(keys)];
+        if(i % 8 == 7) {
+            host_input(key, InputTypePress);
+            host_input(key, InputTypeRepeat);
+            host_input(key, InputTypeRepeat);
+            host_input(key, InputTypeRelease);
+        } else {
+            host_press(key);
+        }
+    }
+    furi_check(host_idle());
+    const uint64_t elapsed = bench_now() - start;
+    const uint32_t flooded = host_gui_stats().inputs - inputs;
+
+    //one key at a time, each event gets its own frame
+    for(uint32_t i = 0; i < presses / 10; i++) {
+        host_press(keys[i % COUNT_OF(keys)]);
+        furi_check(host_idle());
+    }
+
+    host_hold(InputKeyBack, 0);
+    host_app_join();
+
+    HostProfileSection events;
+    furi_check(host_profile("pomodoro", "events", &events));
+    furi_check(loaded.writes + loaded.stats == 0);
+    bench_print("pomodoro", "time to first frame", first_frame / 1000.0, "us");
+    bench_print("pomodoro", "writes and mkdirs on a fresh install", loaded.writes + loaded.stats, "");
+    bench_print("pomodoro", "key events", flooded, "");
+    bench_print("pomodoro", "events/s", flooded / (elapsed / 1e9), "");
+    bench_section("pomodoro", "pomodoro", "events");
+    bench_section("pomodoro", "pomodoro", "draw");
+    bench_gui("pomodoro");
+    bench_threads("pomodoro");
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------
+// bench_profiles.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Switching between the profiles of the Pomodoro app with a file of 100 profiles. Reports the
+//                   time and the bytes read and written per switch, which must not grow with the number of
+//                   profiles, then renames a profile and checks that the settings come back with its times after a
+//                   restart.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Pomodoro/helpers/pomodoro_profiles.h"
+
+#define BENCH_PROFILES_COUNT 100
+
+int32_t pomodoro_app(void* p);
+
+/**
+ * Starts the app and waits until it has loaded
+ */
+static void bench_profiles_start(void) {
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+    furi_check(host_wait_text("OK to start"));
+    furi_check(host_idle());
+}
+
+int main(int argc, char** argv) {
+    //back and forth takes an even number of switches
+    const uint32_t switches = bench_count(argc, argv, 1000) & ~1u;
+    host_setup();
+    host_time_scale(0);
+    bench_profiles_start();
+
+    //the added profiles get 20 minutes of work, which is never saved to the config
+    for(uint32_t i = 0; i < 5; i++) host_press(InputKeyDown);
+    //a long OK opens the profiles, each left adds one with the times of the settings
+    host_hold(InputKeyOk, 0);
+    furi_check(host_wait_text("Profile 1/4"));
+    for(uint32_t i = 4; i < BENCH_PROFILES_COUNT; i++) host_press(InputKeyLeft);
+    furi_check(host_wait_text("Profile 100/100"));
+
+    //back and forth, so the last profile is the current one again
+    host_storage_reset();
+    for(uint32_t i = 0; i < switches; i++) host_press(i % 2 ? InputKeyUp : InputKeyDown);
+    furi_check(host_idle());
+    const HostStorageStats storage = host_storage_stats();
+
+    //the first character of the current profile is stepped to the next one
+    host_press(InputKeyRight);
+    furi_check(host_wait_text("^v letter, <> move, OK save"));
+    host_press(InputKeyUp);
+    furi_check(host_wait_text("[Q]rofile 100"));
+    host_press(InputKeyOk);
+    host_press(InputKeyOk);
+    furi_check(host_idle());
+    const bool renamed = host_screen_has("Profile: Qrofile 100");
+    host_hold(InputKeyBack, 0);
+    host_app_join();
+    bench_print("profiles", "profiles", BENCH_PROFILES_COUNT, "");
+    bench_print("profiles", "bytes read/switch", storage.read_bytes / (double)switches, "bytes");
+    bench_print("profiles", "bytes written/switch", storage.write_bytes / (double)switches, "bytes");
+    bench_section("profiles", "pomodoro", "preset");
+
+    //the settings take the times of the current profile on the next start
+    bench_profiles_start();
+    const bool restored = host_screen_has("Profile: Qrofile 100") && host_screen_has("(20 min)");
+    host_hold(InputKeyBack, 0);
+    host_app_join();
+
+    bench_print("profiles", "renamed", renamed, "");
+    bench_print("profiles", "restored", restored, "");
+    furi_check(renamed && restored);
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------
+// bench_raster.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Outline and filled circles of every radius the circle app draws, from the raster tables and
+//                   with the midpoint algorithm they are generated with. Both have to set the same pixels.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Circle_C/helpers/circle_raster.h"
+#include "../../Circle_C/helpers/circle_raster_tables.h"
+
+typedef void (*BenchRasterDraw)(AppBackBuffer* buffer, int16_t x, int16_t y, uint8_t r, uint8_t width, uint8_t height);
+
+static AppBackBuffer table;
+static AppBackBuffer midpoint;
+
+/**
+ * @return nanoseconds per call of draw, summed up over all radii
+ */
+static double bench_raster_time(BenchRasterDraw draw, AppBackBuffer* buffer, uint32_t rounds) {
+    const uint64_t start = bench_now();
+    for(uint32_t i = 0; i < rounds; i++) {
+        for(uint8_t r = 0; r <= CIRCLE_RASTER_MAX_RADIUS; r++) draw(buffer, 64, 27, r, 128, 54);
+    }
+    return (bench_now() - start) / (double)rounds;
+}
+
+/**
+ * Checks that both ways set the same pixels for every radius, also with the circle clipped at the corner
+ */
+static void bench_raster_compare(BenchRasterDraw by_table, BenchRasterDraw by_midpoint) {
+    for(uint8_t r = 0; r <= CIRCLE_RASTER_MAX_RADIUS; r++) {
+        app_backbuffer_clear(&table);
+        app_backbuffer_clear(&midpoint);
+        by_table(&table, 64, 27, r, 128, 54);
+        by_table(&table, 3, 50, r, 128, 54);
+        by_midpoint(&midpoint, 64, 27, r, 128, 54);
+        by_midpoint(&midpoint, 3, 50, r, 128, 54);
+        furi_check(memcmp(&table, &midpoint, sizeof(AppBackBuffer)) == 0);
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t rounds = bench_count(argc, argv, 2000);
+    bench_raster_compare(circle_raster_draw, circle_raster_draw_midpoint);
+    bench_raster_compare(circle_raster_fill, circle_raster_fill_midpoint);
+
+    const double outline_table = bench_raster_time(circle_raster_draw, &table, rounds);
+    const double outline_midpoint = bench_raster_time(circle_raster_draw_midpoint, &midpoint, rounds);
+    const double fill_table = bench_raster_time(circle_raster_fill, &table, rounds);
+    const double fill_midpoint = bench_raster_time(circle_raster_fill_midpoint, &midpoint, rounds);
+    bench_print("raster", "outline table all radii", outline_table / 1000, "us");
+    bench_print("raster", "outline midpoint all radii", outline_midpoint / 1000, "us");
+    bench_print("raster", "fill table all radii", fill_table / 1000, "us");
+    bench_print("raster", "fill midpoint all radii", fill_midpoint / 1000, "us");
+    return 0;
+}
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------
+// bench_timers.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      One hour of the Pomodoro app on the virtual clock with 1,000 named timers of 5 minutes, one
+//                   added every 3 seconds. Reports the wake ups of the loop that were not key presses, the cpu
+//                   time of the app and the bytes written to the timers file per hour.
+//-------------------------------------------------------------------
+
+#include "bench.h"
+#include "../../Pomodoro/helpers/pomodoro_timers.h"
+
+#define BENCH_TIMERS_HOUR_MS (60 * 60 * 1000)
+#define BENCH_TIMERS_MINUTES 5
+
+int32_t pomodoro_app(void* p);
+
+int main(int argc, char** argv) {
+    const uint32_t timers = bench_count(argc, argv, 1000);
+    //all timers are added in the first 50 minutes, so the last one is up within the hour
+    const uint32_t interval = (BENCH_TIMERS_HOUR_MS - BENCH_TIMERS_MINUTES * 60 * 1000) / timers;
+    host_setup();
+    host_time_scale(0);
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+    furi_check(host_wait_text("OK to start"));
+    furi_check(host_idle());
+
+    //the named timers take the minutes of the shown work interval
+    for(uint32_t i = 0; i < 25 - BENCH_TIMERS_MINUTES; i++) host_press(InputKeyDown);
+    furi_check(host_idle());
+
+    HostThreadStats before;
+    furi_check(host_thread("pomodoro", &before));
+    const uint32_t inputs = host_gui_stats().inputs;
+    host_storage_reset();
+    for(uint32_t i = 0; i < timers; i++) {
+        host_hold(InputKeyRight, 0);
+        host_run(interval);
+    }
+    host_run(BENCH_TIMERS_HOUR_MS - timers * interval);
+    const HostStorageStats storage = host_storage_stats();
+    const uint32_t keys = host_gui_stats().inputs - inputs;
+    HostThreadStats after;
+    furi_check(host_thread("pomodoro", &after));
+    furi_check(!host_log_has("timers are used"));
+
+    host_hold(InputKeyBack, 0);
+    host_app_join();
+
+    //the profile counts every event of the loop, the few of the start and the exit included
+    HostProfileSection events;
+    furi_check(host_profile("pomodoro", "events", &events));
+    bench_print("timers", "timers/h", timers, "");
+    bench_print("timers", "key events/h", keys, "");
+    bench_print("timers", "other wake ups/h", events.count - host_gui_stats().inputs, "");
+    bench_print("timers", "app cpu/h", (after.cpu_ns - before.cpu_ns) / 1e6, "ms");
+    bench_print("timers", "bytes written/timer", storage.write_bytes / (double)timers, "bytes");
+    bench_print("timers", "syncs/timer", storage.syncs / (double)timers, "");
+    bench_threads("timers");
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,262 @@
+#pragma once
+//------------------------------------------------------------------
+// host.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Harness of the host build. Runs an app on its own thread against the furi stand-in, sends it
+//                   key events through the gui thread, controls the virtual clock and reports what the app did:
+//                   the text drawn last, the files written and the stack each thread used.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <furi_hal.h>
+#include <gui/gui.h>
+#include <input/input.h>
+#include <storage/storage.h>
+#include <notification/notification.h>
+
+#define HOST_TIMEOUT_MS 10000
+//stack a thread gets on top of the one it asks for, code built for the host needs more of it
+#define HOST_STACK_EXTRA (64 * 1024)
+
+typedef int32_t (*HostApp)(void* p);
+
+typedef struct {
+    char name[32];
+    size_t stack_size; //stack size the thread asked for
+    size_t stack_used; //largest part of the stack it used so far
+    uint64_t cpu_ns; //cpu time it used
+} HostThreadStats;
+
+typedef struct {
+    uint32_t opens;
+    uint32_t reads;
+    uint64_t read_bytes;
+    uint32_t writes;
+    uint64_t write_bytes;
+    uint32_t seeks;
+    uint32_t syncs;
+    uint32_t renames;
+    uint32_t removes;
+    uint32_t stats; //stat and mkdir
+} HostStorageStats;
+
+typedef struct {
+    uint32_t frames;
+    uint64_t draw_ns; //time spent in draw callbacks
+    uint64_t draw_max_ns;
+    uint32_t inputs;
+    uint64_t first_frame_ns; //monotonic time the first frame since the setup was drawn at, 0 before
+} HostGuiStats;
+
+typedef struct {
+    uint32_t sequences;
+    uint32_t messages;
+    bool vibro;
+    bool sound;
+    bool led;
+} HostNotificationStats;
+
+/**
+ * One line of the <app>_profile.csv written by the app, all times in cycles, which are nanoseconds on the host
+ */
+typedef struct {
+    uint32_t count;
+    uint64_t total;
+    uint32_t max;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+} HostProfileSection;
+
+/**
+ * Creates an empty sd card below a temporary directory and starts the services
+ */
+ void host_setup(void);
+
+/**
+ * Stops the services and removes the sd card
+ */
+ void host_teardown(void);
+
+/**
+ * @return directory the paths of the sd card are mapped to
+ */
+ const char* host_root(void);
+
+/**
+ * Starts the app on a thread of its own, like the loader does
+ *
+ * @param name name of the app thread
+ * @param stack_size stack size of the application.fam
+ * @param app entry point
+ */
+ void host_app_start(const char* name, size_t stack_size, HostApp app);
+
+/**
+ * @return return value of the app, once it exited
+ */
+ int32_t host_app_join(void);
+
+/**
+ * Sends one input event through the gui thread, blocks while the input queue of the gui is full
+ *
+ * @param key key of the event
+ * @param type type of the event
+ */
+ void host_input(InputKey key, InputType type);
+
+/**
+ * Sends press, short and release of a key
+ *
+ * @param key key to press
+ */
+ void host_press(InputKey key);
+
+/**
+ * Sends press, long, the repeats and release of a key
+ *
+ * @param key key to hold
+ * @param repeats repeats sent after the long event
+ */
+ void host_hold(InputKey key, uint32_t repeats);
+
+/**
+ * Waits until every thread waits for something that does not happen without the clock moving on
+ *
+ * @return false if the system did not settle within HOST_TIMEOUT_MS
+ */
+ bool host_idle(void);
+
+/**
+ * Waits until the text is drawn
+ *
+ * @param text text to look for, also part of a drawn string
+ *
+ * @return false if it was not drawn within HOST_TIMEOUT_MS
+ */
+ bool host_wait_text(const char* text);
+
+/**
+ * @param text text to look for, also part of a drawn string
+ *
+ * @return true if the last frame contains the text
+ */
+ bool host_screen_has(const char* text);
+
+/**
+ * @param pixel_x column
+ * @param pixel_y row
+ *
+ * @return true if the pixel of the last frame is set
+ */
+ bool host_screen_pixel(uint8_t pixel_x, uint8_t pixel_y);
+
+/**
+ * Sets how fast the virtual clock runs, 0 stops it so it only moves with host_run
+ *
+ * @param scale ticks per millisecond of the host
+ */
+ void host_time_scale(uint32_t scale);
+
+/**
+ * Moves the stopped clock on, one deadline at a time, and lets the system settle after each of them. An hour of
+ * the device passes as fast as the app can handle its timers.
+ *
+ * @param milliseconds time to pass
+ */
+ void host_run(uint32_t milliseconds);
+
+/**
+ * Sets the time of the rtc at tick 0
+ *
+ * @param timestamp seconds since 1970
+ */
+ void host_rtc_set(uint32_t timestamp);
+
+/**
+ * @param stats filled with one entry per thread that was started
+ * @param capacity entries of stats
+ *
+ * @return number of entries filled
+ */
+ size_t host_threads(HostThreadStats* stats, size_t capacity);
+
+/**
+ * @param name name of a thread
+ * @param stats filled with the stats of the last thread of that name
+ *
+ * @return true if a thread of that name was started
+ */
+ bool host_thread(const char* name, HostThreadStats* stats);
+
+ HostStorageStats host_storage_stats(void);
+ void host_storage_reset(void);
+ HostGuiStats host_gui_stats(void);
+ HostNotificationStats host_notification_stats(void);
+
+/**
+ * Writes a file to the sd card
+ *
+ * @param path path on the sd card
+ * @param data content of the file
+ * @param size size of the content
+ *
+ * @return true if the file was written
+ */
+ bool host_file_write(const char* path, const void* data, size_t size);
+
+/**
+ * Reads a file from the sd card
+ *
+ * @param path path on the sd card
+ * @param data filled with the content of the file
+ * @param capacity size of data
+ *
+ * @return bytes read, -1 if the file does not exist
+ */
+ long host_file_read(const char* path, void* data, size_t capacity);
+
+/**
+ * Reads one section of the profile an app dumped on exit
+ *
+ * @param app name of the app passed to app_profile_dump
+ * @param section name of the section
+ * @param row filled with the section
+ *
+ * @return true if the section was found
+ */
+ bool host_profile(const char* app, const char* section, HostProfileSection* row);
+
+/**
+ * Prints log lines of the apps to stderr, they are dropped otherwise
+ *
+ * @param enabled true to print them
+ */
+ void host_log_enable(bool enabled);
+
+/**
+ * @param text text to look for
+ *
+ * @return true if a log line since the last host_setup contains the text
+ */
+ bool host_log_has(const char* text);
+
+/**
+ * @param text text to look for
+ * @param rest filled with the rest of the line after the last time the text was logged
+ * @param capacity size of rest
+ *
+ * @return true if a log line since the last host_setup contains the text
+ */
+ bool host_log_after(const char* text, char* rest, size_t capacity);
+
+/**
+ * Creates a canvas without a gui, to draw to from a test
+ *
+ * @return canvas of 128x64 cleared pixels
+ */
+ Canvas* host_canvas_alloc(void);
+ void host_canvas_free(Canvas* canvas);
+ bool host_canvas_pixel(const Canvas* canvas, uint8_t pixel_x, uint8_t pixel_y);
@@ -0,0 +1,120 @@
+#pragma once
+//------------------------------------------------------------------
+// furi.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Host stand-in for the parts of the furi kernel api the apps use. Threads, queues, mutexes,
+//                   semaphores and timers are backed by pthreads, the tick runs on a clock the harness can scale
+//                   and advance. Only what the apps call is declared, with the signatures of the firmware.
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define CLAMP(x, upper, lower) (MIN(upper, MAX(x, lower)))
+
+void host_crash(const char* file, int line, const char* expression);
+#define furi_check(x) ((x) ? (void)0 : host_crash(__FILE__, __LINE__, #x))
+#define furi_assert(x) furi_check(x)
+
+/**
+ * The apps format fixed width values with the macros of inttypes.h, so the log is checked like snprintf
+ */
+void host_log(char level, const char* tag, const char* format, ...) __attribute__((format(printf, 3, 4)));
+#define FURI_LOG_E(tag, format, ...) host_log('E', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) host_log('W', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) host_log('I', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) host_log('D', tag, format, ##__VA_ARGS__)
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+    FuriStatusErrorParameter = -4,
+} FuriStatus;
+
+//kernel
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+uint32_t furi_kernel_get_tick_frequency(void);
+void furi_delay_ms(uint32_t milliseconds);
+void furi_delay_tick(uint32_t ticks);
+
+//records
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+//message queue
+typedef struct FuriMessageQueue FuriMessageQueue;
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout);
+uint32_t furi_message_queue_get_capacity(FuriMessageQueue* instance);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance);
+uint32_t furi_message_queue_get_space(FuriMessageQueue* instance);
+
+//timer, the callbacks run on one timer thread like the timer service of the firmware
+typedef enum {
+    FuriTimerTypeOnce = 0,
+    FuriTimerTypePeriodic = 1,
+} FuriTimerType;
+typedef void (*FuriTimerCallback)(void* context);
+typedef struct FuriTimer FuriTimer;
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context);
+void furi_timer_free(FuriTimer* instance);
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer* instance);
+uint32_t furi_timer_is_running(FuriTimer* instance);
+
+//mutex
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+typedef struct FuriMutex FuriMutex;
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* instance);
+FuriStatus furi_mutex_acquire(FuriMutex* instance, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* instance);
+
+//semaphore
+typedef struct FuriSemaphore FuriSemaphore;
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count);
+void furi_semaphore_free(FuriSemaphore* instance);
+FuriStatus furi_semaphore_acquire(FuriSemaphore* instance, uint32_t timeout);
+FuriStatus furi_semaphore_release(FuriSemaphore* instance);
+
+//thread
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+FuriThread* furi_thread_alloc(void);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_name(FuriThread* thread, const char* name);
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size);
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback);
+void furi_thread_set_context(FuriThread* thread, void* context);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_current_id(void);
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id);
+
+//part of the libc of the firmware
+size_t strlcpy(char* destination, const char* source, size_t size);
@@ -0,0 +1,35 @@
+#pragma once
+//------------------------------------------------------------------
+// furi_hal.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Host stand-in for the rtc and the cycle counter. The rtc follows the tick of the host kernel,
+//                   the cycle counter counts nanoseconds, so one microsecond is 1000 cycles.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+    uint8_t weekday;
+} FuriHalRtcDateTime;
+
+void furi_hal_rtc_get_datetime(FuriHalRtcDateTime* datetime);
+uint32_t furi_hal_rtc_datetime_to_timestamp(FuriHalRtcDateTime* datetime);
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+
+typedef struct {
+    uint32_t CYCCNT;
+} HostDwt;
+
+/**
+ * @return cycle counter, updated on each access
+ */
+HostDwt* host_dwt(void);
+#define DWT (host_dwt())
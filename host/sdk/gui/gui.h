@@ -0,0 +1,79 @@
+#pragma once
+//------------------------------------------------------------------
+// gui.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Host stand-in for the gui service. A gui thread calls the draw callback of the view port on a
+//                   128x64 frame buffer after each update, like the firmware does, and keeps the strings drawn so
+//                   the tests can look for them.
+//-------------------------------------------------------------------
+
+#include <furi.h>
+#include <input/input.h>
+
+#define RECORD_GUI "gui"
+
+typedef struct Canvas Canvas;
+typedef struct ViewPort ViewPort;
+typedef struct Gui Gui;
+
+typedef enum {
+    ColorWhite = 0,
+    ColorBlack = 1,
+    ColorXOR = 2,
+} Color;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+    FontKeyboard,
+    FontBigNumbers,
+} Font;
+
+typedef enum {
+    AlignLeft,
+    AlignRight,
+    AlignTop,
+    AlignBottom,
+    AlignCenter,
+} Align;
+
+typedef enum {
+    GuiLayerDesktop,
+    GuiLayerWindow,
+    GuiLayerStatusBarLeft,
+    GuiLayerStatusBarRight,
+    GuiLayerFullscreen,
+} GuiLayer;
+
+typedef void (*ViewPortDrawCallback)(Canvas* canvas, void* context);
+typedef void (*ViewPortInputCallback)(InputEvent* event, void* context);
+
+ViewPort* view_port_alloc(void);
+void view_port_free(ViewPort* view_port);
+void view_port_enabled_set(ViewPort* view_port, bool enabled);
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context);
+void view_port_input_callback_set(ViewPort* view_port, ViewPortInputCallback callback, void* context);
+void view_port_update(ViewPort* view_port);
+
+void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer);
+void gui_remove_view_port(Gui* gui, ViewPort* view_port);
+
+void canvas_clear(Canvas* canvas);
+void canvas_set_color(Canvas* canvas, Color color);
+void canvas_set_font(Canvas* canvas, Font font);
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str);
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str);
+void canvas_draw_dot(Canvas* canvas, uint8_t x, uint8_t y);
+void canvas_draw_box(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void canvas_draw_frame(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void canvas_draw_circle(Canvas* canvas, uint8_t x, uint8_t y, uint8_t radius);
+void canvas_draw_disc(Canvas* canvas, uint8_t x, uint8_t y, uint8_t radius);
+void canvas_draw_xbm(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height, const uint8_t* bitmap);
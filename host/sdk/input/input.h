@@ -0,0 +1,35 @@
+#pragma once
+//------------------------------------------------------------------
+// input.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Host stand-in for the input events, the harness sends them to the view port
+//-------------------------------------------------------------------
+
+#include <furi.h>
+
+typedef enum {
+    InputKeyUp,
+    InputKeyDown,
+    InputKeyRight,
+    InputKeyLeft,
+    InputKeyOk,
+    InputKeyBack,
+    InputKeyMAX,
+} InputKey;
+
+typedef enum {
+    InputTypePress,
+    InputTypeRelease,
+    InputTypeShort,
+    InputTypeLong,
+    InputTypeRepeat,
+    InputTypeMAX,
+} InputType;
+
+typedef struct {
+    uint32_t sequence;
+    InputKey key;
+    InputType type;
+} InputEvent;
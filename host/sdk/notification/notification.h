@@ -0,0 +1,32 @@
+#pragma once
+//------------------------------------------------------------------
+// notification.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Host stand-in for the notification service, sequences are played on a thread of their own
+//                   and take as long as their delays
+//-------------------------------------------------------------------
+
+#include <furi.h>
+
+#define RECORD_NOTIFICATION "notification"
+
+typedef enum {
+    NotificationMessageTypeLed,
+    NotificationMessageTypeVibro,
+    NotificationMessageTypeSound,
+    NotificationMessageTypeBacklight,
+    NotificationMessageTypeDelay,
+} NotificationMessageType;
+
+typedef struct {
+    NotificationMessageType type;
+    uint32_t value; //ms of a delay, 0 turns the output off
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+typedef struct NotificationApp NotificationApp;
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
+void notification_message_block(NotificationApp* app, const NotificationSequence* sequence);
@@ -0,0 +1,30 @@
+#pragma once
+//------------------------------------------------------------------
+// notification_messages.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Host stand-in for the messages and sequences of the notification service the apps use
+//-------------------------------------------------------------------
+
+#include "notification.h"
+
+extern const NotificationMessage message_vibro_on;
+extern const NotificationMessage message_vibro_off;
+extern const NotificationMessage message_red_255;
+extern const NotificationMessage message_red_0;
+extern const NotificationMessage message_blue_255;
+extern const NotificationMessage message_blue_0;
+extern const NotificationMessage message_note_c5;
+extern const NotificationMessage message_note_e5;
+extern const NotificationMessage message_note_g5;
+extern const NotificationMessage message_note_c6;
+extern const NotificationMessage message_sound_off;
+extern const NotificationMessage message_delay_50;
+extern const NotificationMessage message_delay_100;
+extern const NotificationMessage message_delay_250;
+extern const NotificationMessage message_display_backlight_on;
+
+extern const NotificationSequence sequence_reset_vibro;
+extern const NotificationSequence sequence_reset_rgb;
+extern const NotificationSequence sequence_reset_sound;
@@ -0,0 +1,801 @@
+//------------------------------------------------------------------
+// furi.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "host_internal.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <time.h>
+
+//the stand-in formats with the c library directly
+#undef snprintf
+
+#define HOST_STACK_PATTERN 0xA5A5A5A5A5A5A5A5ULL
+
+pthread_mutex_t host_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_condition;
+//the harness waits on its own condition, it is also told when a thread starts to wait
+static pthread_cond_t host_watch;
+
+static struct {
+    uint64_t base_ns; //host time the scale was last set at
+    uint64_t offset; //ticks at base_ns
+    uint32_t scale;
+} host_clock = {.scale = 1};
+
+typedef enum {
+    HostThreadCreated,
+    HostThreadRunning,
+    HostThreadFinished,
+} HostThreadState;
+
+struct FuriThread {
+    char name[32];
+    size_t stack_size;
+    FuriThreadCallback callback;
+    void* context;
+    pthread_t pthread;
+    uint64_t* stack;
+    size_t stack_words;
+    size_t stack_base; //bytes used before the callback was called
+    size_t stack_untouched; //words at the bottom of the stack never written so far
+    size_t stack_peak; //bytes used so far, kept once the stack is released
+    clockid_t cpu_clock;
+    uint64_t cpu_ns;
+    HostThreadState state;
+    int32_t result;
+    //what the thread waits for
+    bool waiting;
+    HostReady ready;
+    void* ready_ctx;
+    bool timed;
+    uint32_t deadline;
+    FuriThread* next;
+};
+
+//every thread that was started, for the idle check and the stack report
+static FuriThread* host_threads_started;
+static __thread FuriThread* host_self;
+
+__attribute__((constructor)) static void host_kernel_init(void) {
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&host_condition, &attributes);
+    pthread_cond_init(&host_watch, &attributes);
+    pthread_condattr_destroy(&attributes);
+    host_clock.base_ns = host_now_ns();
+}
+
+uint64_t host_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+void host_changed(void) {
+    pthread_cond_broadcast(&host_condition);
+    pthread_cond_broadcast(&host_watch);
+}
+
+uint32_t host_tick(void) {
+    return host_clock.offset + (host_now_ns() - host_clock.base_ns) * host_clock.scale / 1000000;
+}
+
+/**
+ * Waits on the condition until the host time, forever for 0
+ */
+static void host_sleep_until(pthread_cond_t* condition, uint64_t until_ns) {
+    if(!until_ns) {
+        pthread_cond_wait(condition, &host_lock);
+        return;
+    }
+    struct timespec until = {.tv_sec = until_ns / 1000000000ULL, .tv_nsec = until_ns % 1000000000ULL};
+    pthread_cond_timedwait(condition, &host_lock, &until);
+}
+
+bool host_wait(HostReady ready, void* ctx, uint32_t timeout) {
+    const bool timed = timeout != FuriWaitForever;
+    const uint32_t deadline = host_tick() + timeout;
+    FuriThread* self = host_self;
+    bool result = true;
+    while(!ready(ctx)) {
+        const int32_t left = (int32_t)(deadline - host_tick());
+        if(timed && left <= 0) {
+            result = false;
+            break;
+        }
+        if(self) {
+            self->waiting = true;
+            self->ready = ready;
+            self->ready_ctx = ctx;
+            self->timed = timed;
+            self->deadline = deadline;
+            pthread_cond_broadcast(&host_watch);
+        }
+        //a stopped clock only moves with host_run, which wakes everyone
+        const uint32_t scale = host_clock.scale;
+        host_sleep_until(&host_condition, timed && scale ? host_now_ns() + (uint64_t)left * 1000000 / scale + 1 : 0);
+    }
+    if(self) self->waiting = false;
+    return result;
+}
+
+bool host_wait_real(HostReady ready, void* ctx, uint32_t milliseconds) {
+    const uint64_t until = host_now_ns() + (uint64_t)milliseconds * 1000000;
+    while(!ready(ctx)) {
+        if(host_now_ns() >= until) return false;
+        host_sleep_until(&host_watch, until);
+    }
+    return true;
+}
+
+static bool host_never(void* ctx) {
+    UNUSED(ctx);
+    return false;
+}
+
+//kernel
+
+uint32_t furi_get_tick(void) {
+    pthread_mutex_lock(&host_lock);
+    const uint32_t tick = host_tick();
+    pthread_mutex_unlock(&host_lock);
+    return tick;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    pthread_mutex_lock(&host_lock);
+    host_wait(host_never, NULL, ticks);
+    pthread_mutex_unlock(&host_lock);
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    furi_delay_tick(milliseconds);
+}
+
+void host_time_scale(uint32_t scale) {
+    pthread_mutex_lock(&host_lock);
+    host_clock.offset = host_tick();
+    host_clock.base_ns = host_now_ns();
+    host_clock.scale = scale;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+}
+
+/**
+ * @return true if no thread can go on without the clock moving on, to be called with the lock held
+ */
+static bool host_settled(void* ctx) {
+    UNUSED(ctx);
+    const uint32_t tick = host_tick();
+    for(FuriThread* thread = host_threads_started; thread; thread = thread->next) {
+        if(thread->state == HostThreadFinished) continue;
+        if(thread->state == HostThreadCreated || !thread->waiting) return false;
+        if(thread->ready(thread->ready_ctx)) return false;
+        if(thread->timed && (int32_t)(thread->deadline - tick) <= 0) return false;
+    }
+    return true;
+}
+
+bool host_idle(void) {
+    pthread_mutex_lock(&host_lock);
+    const bool settled = host_wait_real(host_settled, NULL, HOST_TIMEOUT_MS);
+    pthread_mutex_unlock(&host_lock);
+    return settled;
+}
+
+void host_run(uint32_t milliseconds) {
+    furi_check(host_clock.scale == 0);
+    pthread_mutex_lock(&host_lock);
+    const uint32_t target = host_tick() + milliseconds;
+    while(true) {
+        furi_check(host_wait_real(host_settled, NULL, HOST_TIMEOUT_MS));
+        //next deadline any thread waits for, the timer service waits for the next timer
+        uint32_t next = target;
+        for(FuriThread* thread = host_threads_started; thread; thread = thread->next) {
+            if(thread->state == HostThreadRunning && thread->waiting && thread->timed &&
+               (int32_t)(thread->deadline - next) < 0) {
+                next = thread->deadline;
+            }
+        }
+        host_clock.offset = next;
+        host_changed();
+        if(next == target) break;
+    }
+    furi_check(host_wait_real(host_settled, NULL, HOST_TIMEOUT_MS));
+    pthread_mutex_unlock(&host_lock);
+}
+
+//records
+
+void* furi_record_open(const char* name) {
+    if(strcmp(name, "gui") == 0) return host_gui_record();
+    if(strcmp(name, "storage") == 0) return host_storage_record();
+    if(strcmp(name, "notification") == 0) return host_notification_record();
+    host_crash(__FILE__, __LINE__, name);
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+//message queue
+
+struct FuriMessageQueue {
+    uint32_t capacity;
+    uint32_t size;
+    uint32_t count;
+    uint32_t head;
+    uint8_t* buffer;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* queue = calloc(1, sizeof(FuriMessageQueue));
+    queue->capacity = msg_count;
+    queue->size = msg_size;
+    queue->buffer = calloc(msg_count, msg_size);
+    return queue;
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    free(instance->buffer);
+    free(instance);
+}
+
+static bool host_queue_has_space(void* ctx) {
+    const FuriMessageQueue* queue = ctx;
+    return queue->count < queue->capacity;
+}
+
+static bool host_queue_has_message(void* ctx) {
+    const FuriMessageQueue* queue = ctx;
+    return queue->count > 0;
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout) {
+    pthread_mutex_lock(&host_lock);
+    FuriStatus status = FuriStatusErrorTimeout;
+    if(host_wait(host_queue_has_space, instance, timeout)) {
+        const uint32_t tail = (instance->head + instance->count) % instance->capacity;
+        memcpy(instance->buffer + tail * instance->size, msg_ptr, instance->size);
+        instance->count++;
+        host_changed();
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return status;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout) {
+    pthread_mutex_lock(&host_lock);
+    FuriStatus status = FuriStatusErrorTimeout;
+    if(host_wait(host_queue_has_message, instance, timeout)) {
+        memcpy(msg_ptr, instance->buffer + instance->head * instance->size, instance->size);
+        instance->head = (instance->head + 1) % instance->capacity;
+        instance->count--;
+        host_changed();
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return status;
+}
+
+uint32_t furi_message_queue_get_capacity(FuriMessageQueue* instance) {
+    return instance->capacity;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance) {
+    pthread_mutex_lock(&host_lock);
+    const uint32_t count = instance->count;
+    pthread_mutex_unlock(&host_lock);
+    return count;
+}
+
+uint32_t furi_message_queue_get_space(FuriMessageQueue* instance) {
+    pthread_mutex_lock(&host_lock);
+    const uint32_t space = instance->capacity - instance->count;
+    pthread_mutex_unlock(&host_lock);
+    return space;
+}
+
+//mutex
+
+struct FuriMutex {
+    FuriMutexType type;
+    bool locked;
+    pthread_t owner;
+    uint32_t depth;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* mutex = calloc(1, sizeof(FuriMutex));
+    mutex->type = type;
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* instance) {
+    furi_check(!instance->locked);
+    free(instance);
+}
+
+static bool host_mutex_free(void* ctx) {
+    const FuriMutex* mutex = ctx;
+    return !mutex->locked;
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* instance, uint32_t timeout) {
+    pthread_mutex_lock(&host_lock);
+    FuriStatus status = FuriStatusOk;
+    if(instance->locked && pthread_equal(instance->owner, pthread_self())) {
+        furi_check(instance->type == FuriMutexTypeRecursive);
+        instance->depth++;
+    } else if(host_wait(host_mutex_free, instance, timeout)) {
+        instance->locked = true;
+        instance->owner = pthread_self();
+        instance->depth = 1;
+    } else {
+        status = FuriStatusErrorTimeout;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return status;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* instance) {
+    pthread_mutex_lock(&host_lock);
+    furi_check(instance->locked && pthread_equal(instance->owner, pthread_self()));
+    if(--instance->depth == 0) {
+        instance->locked = false;
+        host_changed();
+    }
+    pthread_mutex_unlock(&host_lock);
+    return FuriStatusOk;
+}
+
+//semaphore
+
+struct FuriSemaphore {
+    uint32_t max;
+    uint32_t count;
+};
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count) {
+    FuriSemaphore* semaphore = calloc(1, sizeof(FuriSemaphore));
+    semaphore->max = max_count;
+    semaphore->count = initial_count;
+    return semaphore;
+}
+
+void furi_semaphore_free(FuriSemaphore* instance) {
+    free(instance);
+}
+
+static bool host_semaphore_available(void* ctx) {
+    const FuriSemaphore* semaphore = ctx;
+    return semaphore->count > 0;
+}
+
+FuriStatus furi_semaphore_acquire(FuriSemaphore* instance, uint32_t timeout) {
+    pthread_mutex_lock(&host_lock);
+    FuriStatus status = FuriStatusErrorTimeout;
+    if(host_wait(host_semaphore_available, instance, timeout)) {
+        instance->count--;
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return status;
+}
+
+FuriStatus furi_semaphore_release(FuriSemaphore* instance) {
+    pthread_mutex_lock(&host_lock);
+    FuriStatus status = FuriStatusErrorResource;
+    if(instance->count < instance->max) {
+        instance->count++;
+        host_changed();
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return status;
+}
+
+//thread
+
+static size_t host_stack_used(FuriThread* thread);
+
+FuriThread* furi_thread_alloc(void) {
+    FuriThread* thread = calloc(1, sizeof(FuriThread));
+    strlcpy(thread->name, "thread", sizeof(thread->name));
+    thread->stack_size = 1024;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    furi_check(thread->state != HostThreadRunning);
+    //stays in the list of started threads for the report, only its stack is released
+    pthread_mutex_lock(&host_lock);
+    host_stack_used(thread);
+    pthread_mutex_unlock(&host_lock);
+    free(thread->stack);
+    thread->stack = NULL;
+    if(thread->state == HostThreadCreated) free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    strlcpy(thread->name, name, sizeof(thread->name));
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    thread->stack_size = stack_size;
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+/**
+ * @return bytes of the stack written so far, to be called with the lock held
+ */
+static size_t host_stack_used(FuriThread* thread) {
+    if(!thread->stack) return thread->stack_peak;
+    //the stack grows down, the words at the bottom that still hold the pattern were never used
+    size_t untouched = 0;
+    while(untouched < thread->stack_untouched && thread->stack[untouched] == HOST_STACK_PATTERN) untouched++;
+    thread->stack_untouched = untouched;
+    const size_t used = (thread->stack_words - untouched) * sizeof(uint64_t);
+    thread->stack_peak = used > thread->stack_base ? used - thread->stack_base : 0;
+    return thread->stack_peak;
+}
+
+static void* host_thread_body(void* ctx) {
+    FuriThread* thread = ctx;
+    host_self = thread;
+    pthread_getcpuclockid(pthread_self(), &thread->cpu_clock);
+    pthread_mutex_lock(&host_lock);
+    //the thread descriptor of the c library and this frame are not part of what the thread used
+    thread->stack_base = 0;
+    thread->stack_base = host_stack_used(thread);
+    thread->state = HostThreadRunning;
+    pthread_mutex_unlock(&host_lock);
+
+    const int32_t result = thread->callback(thread->context);
+
+    struct timespec cpu;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    pthread_mutex_lock(&host_lock);
+    host_stack_used(thread);
+    thread->cpu_ns = (uint64_t)cpu.tv_sec * 1000000000ULL + cpu.tv_nsec;
+    thread->result = result;
+    thread->state = HostThreadFinished;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    furi_check(thread->callback && !thread->stack);
+    const size_t bytes = (thread->stack_size + HOST_STACK_EXTRA + 4095) & ~(size_t)4095;
+    thread->stack = aligned_alloc(4096, bytes);
+    thread->stack_words = bytes / sizeof(uint64_t);
+    thread->stack_untouched = thread->stack_words;
+    for(size_t i = 0; i < thread->stack_words; i++) thread->stack[i] = HOST_STACK_PATTERN;
+
+    pthread_mutex_lock(&host_lock);
+    thread->state = HostThreadCreated;
+    thread->next = host_threads_started;
+    host_threads_started = thread;
+    pthread_mutex_unlock(&host_lock);
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstack(&attributes, thread->stack, bytes);
+    furi_check(pthread_create(&thread->pthread, &attributes, host_thread_body, thread) == 0);
+    pthread_attr_destroy(&attributes);
+}
+
+static bool host_thread_finished(void* ctx) {
+    const FuriThread* thread = ctx;
+    return thread->state == HostThreadFinished;
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    pthread_mutex_lock(&host_lock);
+    host_wait(host_thread_finished, thread, FuriWaitForever);
+    pthread_mutex_unlock(&host_lock);
+    pthread_join(thread->pthread, NULL);
+    return true;
+}
+
+int32_t host_thread_result(FuriThread* thread) {
+    return thread->result;
+}
+
+FuriThreadId furi_thread_get_current_id(void) {
+    return host_self;
+}
+
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id) {
+    if(!thread_id) return 0;
+    pthread_mutex_lock(&host_lock);
+    const size_t used = host_stack_used(thread_id);
+    pthread_mutex_unlock(&host_lock);
+    return used < thread_id->stack_size ? thread_id->stack_size - used : 0;
+}
+
+FuriThread* host_service_start(const char* name, size_t stack_size, FuriThreadCallback callback, void* context) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, name);
+    furi_thread_set_stack_size(thread, stack_size);
+    furi_thread_set_callback(thread, callback);
+    furi_thread_set_context(thread, context);
+    furi_thread_start(thread);
+    return thread;
+}
+
+static void host_thread_stats(FuriThread* thread, HostThreadStats* stats) {
+    strlcpy(stats->name, thread->name, sizeof(stats->name));
+    stats->stack_size = thread->stack_size;
+    stats->stack_used = host_stack_used(thread);
+    stats->cpu_ns = thread->cpu_ns;
+    if(thread->state == HostThreadRunning) {
+        struct timespec cpu;
+        if(clock_gettime(thread->cpu_clock, &cpu) == 0) {
+            stats->cpu_ns = (uint64_t)cpu.tv_sec * 1000000000ULL + cpu.tv_nsec;
+        }
+    }
+}
+
+size_t host_threads(HostThreadStats* stats, size_t capacity) {
+    pthread_mutex_lock(&host_lock);
+    size_t count = 0;
+    for(FuriThread* thread = host_threads_started; thread && count < capacity; thread = thread->next) {
+        host_thread_stats(thread, &stats[count++]);
+    }
+    pthread_mutex_unlock(&host_lock);
+    return count;
+}
+
+bool host_thread(const char* name, HostThreadStats* stats) {
+    pthread_mutex_lock(&host_lock);
+    FuriThread* thread = host_threads_started;
+    while(thread && strcmp(thread->name, name) != 0) thread = thread->next;
+    if(thread) host_thread_stats(thread, stats);
+    pthread_mutex_unlock(&host_lock);
+    return thread != NULL;
+}
+
+/**
+ * Forgets the threads that finished, their stats were read by the run that ended
+ */
+void host_threads_reset(void) {
+    pthread_mutex_lock(&host_lock);
+    FuriThread** link = &host_threads_started;
+    while(*link) {
+        FuriThread* thread = *link;
+        if(thread->state == HostThreadFinished) {
+            *link = thread->next;
+            free(thread->stack);
+            free(thread);
+        } else {
+            link = &thread->next;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+//timer, one service thread runs the callbacks in the order they are due
+
+struct FuriTimer {
+    FuriTimerCallback callback;
+    FuriTimerType type;
+    void* context;
+    bool running;
+    uint32_t period;
+    uint32_t deadline;
+    FuriTimer* next;
+};
+
+static struct {
+    FuriTimer* timers;
+    uint32_t changes; //bumped whenever a timer starts or stops
+    FuriThread* thread;
+    bool stop;
+} host_timers;
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    FuriTimer* timer = calloc(1, sizeof(FuriTimer));
+    timer->callback = func;
+    timer->type = type;
+    timer->context = context;
+    pthread_mutex_lock(&host_lock);
+    timer->next = host_timers.timers;
+    host_timers.timers = timer;
+    pthread_mutex_unlock(&host_lock);
+    return timer;
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    pthread_mutex_lock(&host_lock);
+    FuriTimer** link = &host_timers.timers;
+    while(*link != instance) link = &(*link)->next;
+    *link = instance->next;
+    host_timers.changes++;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
+    pthread_mutex_lock(&host_lock);
+    instance->running = true;
+    instance->period = ticks;
+    instance->deadline = host_tick() + ticks;
+    host_timers.changes++;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* instance) {
+    pthread_mutex_lock(&host_lock);
+    instance->running = false;
+    host_timers.changes++;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    return FuriStatusOk;
+}
+
+uint32_t furi_timer_is_running(FuriTimer* instance) {
+    pthread_mutex_lock(&host_lock);
+    const bool running = instance->running;
+    pthread_mutex_unlock(&host_lock);
+    return running;
+}
+
+typedef struct {
+    uint32_t changes;
+} HostTimerWait;
+
+static bool host_timers_changed(void* ctx) {
+    const HostTimerWait* wait = ctx;
+    return host_timers.stop || wait->changes != host_timers.changes;
+}
+
+static int32_t host_timer_service(void* ctx) {
+    UNUSED(ctx);
+    pthread_mutex_lock(&host_lock);
+    while(!host_timers.stop) {
+        FuriTimer* due = NULL;
+        for(FuriTimer* timer = host_timers.timers; timer; timer = timer->next) {
+            if(timer->running && (!due || (int32_t)(timer->deadline - due->deadline) < 0)) due = timer;
+        }
+        const int32_t left = due ? (int32_t)(due->deadline - host_tick()) : 0;
+        if(due && left <= 0) {
+            if(due->type == FuriTimerTypePeriodic) {
+                due->deadline += MAX(due->period, 1U);
+            } else {
+                due->running = false;
+            }
+            FuriTimerCallback callback = due->callback;
+            void* context = due->context;
+            pthread_mutex_unlock(&host_lock);
+            callback(context);
+            pthread_mutex_lock(&host_lock);
+            continue;
+        }
+        HostTimerWait wait = {.changes = host_timers.changes};
+        host_wait(host_timers_changed, &wait, due ? (uint32_t)left : FuriWaitForever);
+    }
+    pthread_mutex_unlock(&host_lock);
+    return 0;
+}
+
+void host_timer_setup(void) {
+    host_timers.stop = false;
+    host_timers.thread = host_service_start("TimerSvc", 1024, host_timer_service, NULL);
+}
+
+void host_timer_teardown(void) {
+    pthread_mutex_lock(&host_lock);
+    host_timers.stop = true;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    furi_thread_join(host_timers.thread);
+    furi_thread_free(host_timers.thread);
+}
+
+//log
+
+static struct {
+    bool enabled;
+    char* text;
+    size_t length;
+    size_t capacity;
+} host_logged;
+
+//kept off the stack, so the stack report shows what the app itself used
+static __thread char host_line[512];
+
+void host_log(char level, const char* tag, const char* format, ...) {
+    char* line = host_line;
+    const int prefix = snprintf(line, sizeof(host_line), "[%c][%s] ", level, tag);
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(line + prefix, sizeof(host_line) - prefix, format, arguments);
+    va_end(arguments);
+
+    pthread_mutex_lock(&host_lock);
+    if(host_logged.enabled) fprintf(stderr, "%s\n", line);
+    const size_t length = strlen(line);
+    if(host_logged.length + length + 2 > host_logged.capacity) {
+        host_logged.capacity = MAX(host_logged.capacity * 2, host_logged.length + length + 4096);
+        host_logged.text = realloc(host_logged.text, host_logged.capacity);
+    }
+    memcpy(host_logged.text + host_logged.length, line, length);
+    host_logged.length += length;
+    host_logged.text[host_logged.length++] = '\n';
+    host_logged.text[host_logged.length] = '\0';
+    pthread_mutex_unlock(&host_lock);
+}
+
+void host_log_enable(bool enabled) {
+    host_logged.enabled = enabled;
+}
+
+bool host_log_has(const char* text) {
+    pthread_mutex_lock(&host_lock);
+    const bool found = host_logged.text && strstr(host_logged.text, text);
+    pthread_mutex_unlock(&host_lock);
+    return found;
+}
+
+bool host_log_after(const char* text, char* rest, size_t capacity) {
+    pthread_mutex_lock(&host_lock);
+    const char* last = NULL;
+    for(const char* found = host_logged.text; found && (found = strstr(found, text)); found++) last = found;
+    if(last) {
+        last += strlen(text);
+        const size_t length = MIN(strcspn(last, "\n"), capacity - 1);
+        memcpy(rest, last, length);
+        rest[length] = '\0';
+    }
+    pthread_mutex_unlock(&host_lock);
+    return last;
+}
+
+void host_log_clear(void) {
+    pthread_mutex_lock(&host_lock);
+    host_logged.length = 0;
+    if(host_logged.text) host_logged.text[0] = '\0';
+    pthread_mutex_unlock(&host_lock);
+}
+
+void host_crash(const char* file, int line, const char* expression) {
+    fprintf(stderr, "furi_check failed at %s:%d: %s\n", file, line, expression);
+    abort();
+}
+
+size_t strlcpy(char* destination, const char* source, size_t size) {
+    const size_t length = strlen(source);
+    if(size) {
+        const size_t copied = MIN(length, size - 1);
+        memcpy(destination, source, copied);
+        destination[copied] = '\0';
+    }
+    return length;
+}
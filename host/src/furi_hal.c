@@ -0,0 +1,53 @@
+//------------------------------------------------------------------
+// furi_hal.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "host_internal.h"
+#include <time.h>
+
+//10.10.2025 00:00 UTC, a friday
+static uint32_t host_rtc_base = 1760054400;
+
+void host_rtc_set(uint32_t timestamp) {
+    host_rtc_base = timestamp;
+}
+
+void furi_hal_rtc_get_datetime(FuriHalRtcDateTime* datetime) {
+    const time_t now = host_rtc_base + furi_get_tick() / 1000;
+    struct tm calendar;
+    gmtime_r(&now, &calendar);
+    datetime->hour = calendar.tm_hour;
+    datetime->minute = calendar.tm_min;
+    datetime->second = calendar.tm_sec;
+    datetime->day = calendar.tm_mday;
+    datetime->month = calendar.tm_mon + 1;
+    datetime->year = calendar.tm_year + 1900;
+    //monday is 1 and sunday 7, as on the device
+    datetime->weekday = calendar.tm_wday ? calendar.tm_wday : 7;
+}
+
+uint32_t furi_hal_rtc_datetime_to_timestamp(FuriHalRtcDateTime* datetime) {
+    struct tm calendar = {
+        .tm_sec = datetime->second,
+        .tm_min = datetime->minute,
+        .tm_hour = datetime->hour,
+        .tm_mday = datetime->day,
+        .tm_mon = datetime->month - 1,
+        .tm_year = datetime->year - 1900,
+    };
+    return timegm(&calendar);
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return 1000;
+}
+
+HostDwt* host_dwt(void) {
+    //one cycle per nanosecond of the host, wraps like the counter of the device
+    static __thread HostDwt dwt;
+    dwt.CYCCNT = (uint32_t)host_now_ns();
+    return &dwt;
+}
@@ -0,0 +1,421 @@
+//------------------------------------------------------------------
+// gui.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "host_internal.h"
+
+#define HOST_SCREEN_WIDTH 128
+#define HOST_SCREEN_HEIGHT 64
+#define HOST_TEXT_SIZE 1024
+#define HOST_INPUTS 64
+
+struct Canvas {
+    uint8_t pixels[HOST_SCREEN_HEIGHT][HOST_SCREEN_WIDTH];
+    Color color;
+    char text[HOST_TEXT_SIZE]; //strings drawn, one per line
+    size_t text_length;
+};
+
+struct ViewPort {
+    ViewPortDrawCallback draw;
+    void* draw_context;
+    ViewPortInputCallback input;
+    void* input_context;
+    bool enabled;
+    Gui* gui;
+};
+
+struct Gui {
+    ViewPort* view_port;
+    FuriThread* thread;
+    Canvas canvas;
+    Canvas screen; //last frame drawn
+    bool pending; //a redraw was requested
+    bool busy; //the view port is being drawn or receives input
+    InputEvent inputs[HOST_INPUTS];
+    uint32_t input_head;
+    uint32_t input_count;
+    uint32_t sequence;
+    HostGuiStats stats;
+    bool stop;
+};
+
+static Gui host_gui;
+
+//canvas
+
+static void host_canvas_set(Canvas* canvas, int16_t x, int16_t y) {
+    if(x < 0 || y < 0 || x >= HOST_SCREEN_WIDTH || y >= HOST_SCREEN_HEIGHT) return;
+    switch(canvas->color) {
+    case ColorWhite:
+        canvas->pixels[y][x] = 0;
+        break;
+    case ColorBlack:
+        canvas->pixels[y][x] = 1;
+        break;
+    case ColorXOR:
+        canvas->pixels[y][x] ^= 1;
+        break;
+    }
+}
+
+Canvas* host_canvas_alloc(void) {
+    Canvas* canvas = malloc(sizeof(Canvas));
+    canvas_clear(canvas);
+    return canvas;
+}
+
+void host_canvas_free(Canvas* canvas) {
+    free(canvas);
+}
+
+bool host_canvas_pixel(const Canvas* canvas, uint8_t pixel_x, uint8_t pixel_y) {
+    return pixel_x < HOST_SCREEN_WIDTH && pixel_y < HOST_SCREEN_HEIGHT && canvas->pixels[pixel_y][pixel_x];
+}
+
+void canvas_clear(Canvas* canvas) {
+    memset(canvas->pixels, 0, sizeof(canvas->pixels));
+    canvas->color = ColorBlack;
+    canvas->text[0] = '\0';
+    canvas->text_length = 0;
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    canvas->color = color;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str) {
+    UNUSED(x);
+    UNUSED(y);
+    //the glyphs are not drawn, the tests look for the text
+    const size_t length = strlen(str);
+    if(canvas->text_length + length + 2 > HOST_TEXT_SIZE) return;
+    memcpy(canvas->text + canvas->text_length, str, length);
+    canvas->text_length += length;
+    canvas->text[canvas->text_length++] = '\n';
+    canvas->text[canvas->text_length] = '\0';
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    canvas_draw_str(canvas, x, y, str);
+}
+
+void canvas_draw_dot(Canvas* canvas, uint8_t x, uint8_t y) {
+    host_canvas_set(canvas, x, y);
+}
+
+void canvas_draw_box(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    for(int16_t row = y; row < y + height; row++) {
+        for(int16_t column = x; column < x + width; column++) host_canvas_set(canvas, column, row);
+    }
+}
+
+void canvas_draw_frame(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    if(!width || !height) return;
+    for(int16_t column = x; column < x + width; column++) {
+        host_canvas_set(canvas, column, y);
+        if(height > 1) host_canvas_set(canvas, column, y + height - 1);
+    }
+    for(int16_t row = y + 1; row < y + height - 1; row++) {
+        host_canvas_set(canvas, x, row);
+        if(width > 1) host_canvas_set(canvas, x + width - 1, row);
+    }
+}
+
+/**
+ * Midpoint circle as drawn by u8g2, calls the section for each step of the first octant
+ */
+static void host_canvas_circle(
+    Canvas* canvas,
+    int16_t x0,
+    int16_t y0,
+    int16_t radius,
+    void (*section)(Canvas* canvas, int16_t x, int16_t y, int16_t x0, int16_t y0)) {
+    int16_t f = 1 - radius;
+    int16_t ddf_x = 1;
+    int16_t ddf_y = -2 * radius;
+    int16_t x = 0;
+    int16_t y = radius;
+    section(canvas, x, y, x0, y0);
+    while(x < y) {
+        if(f >= 0) {
+            y--;
+            ddf_y += 2;
+            f += ddf_y;
+        }
+        x++;
+        ddf_x += 2;
+        f += ddf_x;
+        section(canvas, x, y, x0, y0);
+    }
+}
+
+static void host_canvas_circle_section(Canvas* canvas, int16_t x, int16_t y, int16_t x0, int16_t y0) {
+    host_canvas_set(canvas, x0 + x, y0 - y);
+    host_canvas_set(canvas, x0 + y, y0 - x);
+    host_canvas_set(canvas, x0 - x, y0 - y);
+    host_canvas_set(canvas, x0 - y, y0 - x);
+    host_canvas_set(canvas, x0 + x, y0 + y);
+    host_canvas_set(canvas, x0 + y, y0 + x);
+    host_canvas_set(canvas, x0 - x, y0 + y);
+    host_canvas_set(canvas, x0 - y, y0 + x);
+}
+
+static void host_canvas_vline(Canvas* canvas, int16_t x, int16_t y, int16_t length) {
+    for(int16_t row = y; row < y + length; row++) host_canvas_set(canvas, x, row);
+}
+
+static void host_canvas_disc_section(Canvas* canvas, int16_t x, int16_t y, int16_t x0, int16_t y0) {
+    host_canvas_vline(canvas, x0 + x, y0 - y, y + 1);
+    host_canvas_vline(canvas, x0 + y, y0 - x, x + 1);
+    host_canvas_vline(canvas, x0 - x, y0 - y, y + 1);
+    host_canvas_vline(canvas, x0 - y, y0 - x, x + 1);
+    host_canvas_vline(canvas, x0 + x, y0, y + 1);
+    host_canvas_vline(canvas, x0 + y, y0, x + 1);
+    host_canvas_vline(canvas, x0 - x, y0, y + 1);
+    host_canvas_vline(canvas, x0 - y, y0, x + 1);
+}
+
+void canvas_draw_circle(Canvas* canvas, uint8_t x, uint8_t y, uint8_t radius) {
+    host_canvas_circle(canvas, x, y, radius, host_canvas_circle_section);
+}
+
+void canvas_draw_disc(Canvas* canvas, uint8_t x, uint8_t y, uint8_t radius) {
+    host_canvas_circle(canvas, x, y, radius, host_canvas_disc_section);
+}
+
+void canvas_draw_xbm(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height, const uint8_t* bitmap) {
+    //set bits are drawn in the current color, cleared bits leave the canvas as it is
+    const size_t stride = (width + 7) / 8;
+    for(uint8_t row = 0; row < height; row++) {
+        for(uint8_t column = 0; column < width; column++) {
+            if(bitmap[row * stride + column / 8] & (1 << (column % 8))) {
+                host_canvas_set(canvas, x + column, y + row);
+            }
+        }
+    }
+}
+
+//view port
+
+ViewPort* view_port_alloc(void) {
+    ViewPort* view_port = calloc(1, sizeof(ViewPort));
+    view_port->enabled = true;
+    return view_port;
+}
+
+void view_port_free(ViewPort* view_port) {
+    furi_check(!view_port->gui);
+    free(view_port);
+}
+
+void view_port_enabled_set(ViewPort* view_port, bool enabled) {
+    pthread_mutex_lock(&host_lock);
+    view_port->enabled = enabled;
+    if(view_port->gui) {
+        view_port->gui->pending = true;
+        host_changed();
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context) {
+    view_port->draw = callback;
+    view_port->draw_context = context;
+}
+
+void view_port_input_callback_set(ViewPort* view_port, ViewPortInputCallback callback, void* context) {
+    view_port->input = callback;
+    view_port->input_context = context;
+}
+
+void view_port_update(ViewPort* view_port) {
+    pthread_mutex_lock(&host_lock);
+    if(view_port->gui && view_port->enabled) {
+        view_port->gui->pending = true;
+        host_changed();
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+//gui
+
+void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
+    UNUSED(layer);
+    pthread_mutex_lock(&host_lock);
+    furi_check(!gui->view_port);
+    gui->view_port = view_port;
+    view_port->gui = gui;
+    gui->pending = true;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+}
+
+static bool host_gui_free(void* ctx) {
+    const Gui* gui = ctx;
+    return !gui->busy;
+}
+
+void gui_remove_view_port(Gui* gui, ViewPort* view_port) {
+    pthread_mutex_lock(&host_lock);
+    //like the lock of the gui, a frame or an input being handled ends first
+    host_wait(host_gui_free, gui, FuriWaitForever);
+    furi_check(gui->view_port == view_port);
+    gui->view_port = NULL;
+    view_port->gui = NULL;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+}
+
+static bool host_gui_has_work(void* ctx) {
+    const Gui* gui = ctx;
+    return gui->stop || gui->input_count || (gui->pending && gui->view_port);
+}
+
+static int32_t host_gui_thread(void* ctx) {
+    Gui* gui = ctx;
+    pthread_mutex_lock(&host_lock);
+    while(true) {
+        host_wait(host_gui_has_work, gui, FuriWaitForever);
+        if(gui->stop) break;
+        ViewPort* view_port = gui->view_port;
+        if(gui->input_count) {
+            InputEvent event = gui->inputs[gui->input_head];
+            gui->input_head = (gui->input_head + 1) % HOST_INPUTS;
+            gui->input_count--;
+            gui->stats.inputs++;
+            host_changed();
+            if(view_port && view_port->enabled && view_port->input) {
+                gui->busy = true;
+                pthread_mutex_unlock(&host_lock);
+                view_port->input(&event, view_port->input_context);
+                pthread_mutex_lock(&host_lock);
+                gui->busy = false;
+                host_changed();
+            }
+            continue;
+        }
+        gui->pending = false;
+        if(!view_port || !view_port->enabled || !view_port->draw) continue;
+        gui->busy = true;
+        pthread_mutex_unlock(&host_lock);
+
+        canvas_clear(&gui->canvas);
+        const uint64_t start = host_now_ns();
+        view_port->draw(&gui->canvas, view_port->draw_context);
+        const uint64_t duration = host_now_ns() - start;
+
+        pthread_mutex_lock(&host_lock);
+        gui->screen = gui->canvas;
+        if(gui->stats.frames++ == 0) gui->stats.first_frame_ns = start + duration;
+        gui->stats.draw_ns += duration;
+        if(duration > gui->stats.draw_max_ns) gui->stats.draw_max_ns = duration;
+        gui->busy = false;
+        host_changed();
+    }
+    pthread_mutex_unlock(&host_lock);
+    return 0;
+}
+
+void host_gui_setup(void) {
+    memset(&host_gui, 0, sizeof(Gui));
+    canvas_clear(&host_gui.screen);
+    //the gui service of the device runs with 2 kB of stack
+    host_gui.thread = host_service_start("gui", 2 * 1024, host_gui_thread, &host_gui);
+}
+
+void host_gui_teardown(void) {
+    pthread_mutex_lock(&host_lock);
+    host_gui.stop = true;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    furi_thread_join(host_gui.thread);
+    furi_thread_free(host_gui.thread);
+}
+
+void* host_gui_record(void) {
+    return &host_gui;
+}
+
+HostGuiStats host_gui_stats(void) {
+    pthread_mutex_lock(&host_lock);
+    const HostGuiStats stats = host_gui.stats;
+    pthread_mutex_unlock(&host_lock);
+    return stats;
+}
+
+static bool host_gui_has_space(void* ctx) {
+    const Gui* gui = ctx;
+    return gui->input_count < HOST_INPUTS;
+}
+
+void host_input(InputKey key, InputType type) {
+    pthread_mutex_lock(&host_lock);
+    furi_check(host_wait_real(host_gui_has_space, &host_gui, HOST_TIMEOUT_MS));
+    if(type == InputTypePress) host_gui.sequence++;
+    host_gui.inputs[(host_gui.input_head + host_gui.input_count) % HOST_INPUTS] =
+        (InputEvent){.sequence = host_gui.sequence, .key = key, .type = type};
+    host_gui.input_count++;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+}
+
+void host_press(InputKey key) {
+    host_input(key, InputTypePress);
+    host_input(key, InputTypeShort);
+    host_input(key, InputTypeRelease);
+}
+
+void host_hold(InputKey key, uint32_t repeats) {
+    host_input(key, InputTypePress);
+    host_input(key, InputTypeLong);
+    for(uint32_t i = 0; i < repeats; i++) host_input(key, InputTypeRepeat);
+    host_input(key, InputTypeRelease);
+}
+
+typedef struct {
+    const char* text;
+} HostTextWait;
+
+static bool host_text_drawn(void* ctx) {
+    const HostTextWait* wait = ctx;
+    return strstr(host_gui.screen.text, wait->text) != NULL;
+}
+
+bool host_wait_text(const char* text) {
+    HostTextWait wait = {.text = text};
+    pthread_mutex_lock(&host_lock);
+    const bool drawn = host_wait_real(host_text_drawn, &wait, HOST_TIMEOUT_MS);
+    pthread_mutex_unlock(&host_lock);
+    return drawn;
+}
+
+bool host_screen_has(const char* text) {
+    pthread_mutex_lock(&host_lock);
+    const bool drawn = strstr(host_gui.screen.text, text) != NULL;
+    pthread_mutex_unlock(&host_lock);
+    return drawn;
+}
+
+bool host_screen_pixel(uint8_t pixel_x, uint8_t pixel_y) {
+    pthread_mutex_lock(&host_lock);
+    const bool set = host_canvas_pixel(&host_gui.screen, pixel_x, pixel_y);
+    pthread_mutex_unlock(&host_lock);
+    return set;
+}
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------
+// host.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#define _XOPEN_SOURCE 700
+#include "host_internal.h"
+#include <ftw.h>
+#include <sys/stat.h>
+
+static struct {
+    char root[128];
+    FuriThread* app;
+} host;
+
+void host_setup(void) {
+    strlcpy(host.root, "/tmp/flipper-host-XXXXXX", sizeof(host.root));
+    furi_check(mkdtemp(host.root));
+    //the firmware creates these on the sd card
+    char path[256];
+    snprintf(path, sizeof(path), "%s/ext", host.root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/ext/apps", host.root);
+    mkdir(path, 0755);
+
+    host_log_clear();
+    host_storage_setup(host.root);
+    host_timer_setup();
+    host_gui_setup();
+    host_notification_setup();
+    furi_check(host_idle());
+}
+
+static int host_remove(const char* path, const struct stat* status, int flag, struct FTW* walk) {
+    UNUSED(status);
+    UNUSED(flag);
+    UNUSED(walk);
+    return remove(path);
+}
+
+void host_teardown(void) {
+    host_notification_teardown();
+    host_gui_teardown();
+    host_timer_teardown();
+    host_threads_reset();
+    host_time_scale(1);
+    nftw(host.root, host_remove, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+const char* host_root(void) {
+    return host.root;
+}
+
+void host_app_start(const char* name, size_t stack_size, HostApp app) {
+    furi_check(!host.app);
+    host.app = host_service_start(name, stack_size, app, NULL);
+}
+
+int32_t host_app_join(void) {
+    furi_check(host.app);
+    furi_thread_join(host.app);
+    const int32_t result = host_thread_result(host.app);
+    furi_thread_free(host.app);
+    host.app = NULL;
+    return result;
+}
+
+bool host_profile(const char* app, const char* section, HostProfileSection* row) {
+    char path[128];
+    static char text[8192];
+    snprintf(path, sizeof(path), "/ext/apps/misc/%s_profile.csv", app);
+    const long length = host_file_read(path, text, sizeof(text) - 1);
+    if(length < 0) return false;
+    text[length] = '\0';
+
+    const size_t name_length = strlen(section);
+    for(char* line = text; line && *line; line = strchr(line, '\n') ? strchr(line, '\n') + 1 : NULL) {
+        if(strncmp(line, section, name_length) != 0 || line[name_length] != ',') continue;
+        unsigned long long total;
+        unsigned count, max, p50, p90, p99;
+        if(sscanf(line + name_length, ",%u,%llu,%u,%u,%u,%u", &count, &total, &max, &p50, &p90, &p99) != 6) {
+            return false;
+        }
+        *row = (HostProfileSection){count, total, max, p50, p90, p99};
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+#pragma once
+//------------------------------------------------------------------
+// host_internal.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      State shared by the parts of the host stand-in. All kernel objects are guarded by one lock
+//                   and every change is announced on one condition, like a single core that only switches threads
+//                   at kernel calls. A thread that waits notes what it waits for, so the harness can tell when
+//                   the whole system has nothing left to do.
+//-------------------------------------------------------------------
+
+#include <pthread.h>
+#include "../host.h"
+
+typedef bool (*HostReady)(void* ctx);
+
+extern pthread_mutex_t host_lock;
+
+/**
+ * Wakes every waiting thread to check its condition again, to be called with the lock held
+ */
+ void host_changed(void);
+
+/**
+ * @return tick of the virtual clock, to be called with the lock held
+ */
+ uint32_t host_tick(void);
+
+/**
+ * Waits with the lock held until the condition holds or the ticks passed. The lock is released while waiting.
+ *
+ * @param ready condition to wait for
+ * @param ctx context of the condition
+ * @param timeout ticks to wait at most, FuriWaitForever to wait without limit
+ *
+ * @return true if the condition holds
+ */
+ bool host_wait(HostReady ready, void* ctx, uint32_t timeout);
+
+/**
+ * Waits with the lock held like host_wait, but for a time on the clock of the host, used by the harness
+ *
+ * @param ready condition to wait for
+ * @param ctx context of the condition
+ * @param milliseconds real time to wait at most
+ *
+ * @return true if the condition holds
+ */
+ bool host_wait_real(HostReady ready, void* ctx, uint32_t milliseconds);
+
+/**
+ * Starts a thread of the stand-in, such as the gui or the timer service
+ *
+ * @param name name of the thread
+ * @param stack_size stack size of the service on the device
+ * @param callback function of the thread
+ * @param context context of the function
+ *
+ * @return thread
+ */
+ FuriThread* host_service_start(const char* name, size_t stack_size, FuriThreadCallback callback, void* context);
+
+/**
+ * @return nanoseconds of the monotonic clock of the host
+ */
+ uint64_t host_now_ns(void);
+
+ void host_gui_setup(void);
+ void host_gui_teardown(void);
+ void* host_gui_record(void);
+ void host_storage_setup(const char* root);
+ void* host_storage_record(void);
+ void host_notification_setup(void);
+ void host_notification_teardown(void);
+ void* host_notification_record(void);
+ void host_timer_setup(void);
+ void host_timer_teardown(void);
+ void host_threads_reset(void);
+ void host_log_clear(void);
+ int32_t host_thread_result(FuriThread* thread);
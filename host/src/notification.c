@@ -0,0 +1,155 @@
+//------------------------------------------------------------------
+// notification.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "host_internal.h"
+#include <notification/notification_messages.h>
+
+#define HOST_SEQUENCES 16
+
+struct NotificationApp {
+    const NotificationSequence* sequences[HOST_SEQUENCES];
+    uint32_t head;
+    uint32_t count;
+    uint32_t played; //sequences played so far
+    uint32_t queued; //sequences queued so far
+    FuriThread* thread;
+    HostNotificationStats stats;
+    bool stop;
+};
+
+static NotificationApp host_notification;
+
+const NotificationMessage message_vibro_on = {NotificationMessageTypeVibro, 1};
+const NotificationMessage message_vibro_off = {NotificationMessageTypeVibro, 0};
+const NotificationMessage message_red_255 = {NotificationMessageTypeLed, 255};
+const NotificationMessage message_red_0 = {NotificationMessageTypeLed, 0};
+const NotificationMessage message_blue_255 = {NotificationMessageTypeLed, 255};
+const NotificationMessage message_blue_0 = {NotificationMessageTypeLed, 0};
+const NotificationMessage message_note_c5 = {NotificationMessageTypeSound, 523};
+const NotificationMessage message_note_e5 = {NotificationMessageTypeSound, 659};
+const NotificationMessage message_note_g5 = {NotificationMessageTypeSound, 784};
+const NotificationMessage message_note_c6 = {NotificationMessageTypeSound, 1047};
+const NotificationMessage message_sound_off = {NotificationMessageTypeSound, 0};
+const NotificationMessage message_delay_50 = {NotificationMessageTypeDelay, 50};
+const NotificationMessage message_delay_100 = {NotificationMessageTypeDelay, 100};
+const NotificationMessage message_delay_250 = {NotificationMessageTypeDelay, 250};
+const NotificationMessage message_display_backlight_on = {NotificationMessageTypeBacklight, 1};
+
+const NotificationSequence sequence_reset_vibro = {&message_vibro_off, NULL};
+const NotificationSequence sequence_reset_rgb = {&message_red_0, &message_blue_0, NULL};
+const NotificationSequence sequence_reset_sound = {&message_sound_off, NULL};
+
+static bool host_notification_has_space(void* ctx) {
+    const NotificationApp* app = ctx;
+    return app->count < HOST_SEQUENCES;
+}
+
+static bool host_notification_has_work(void* ctx) {
+    const NotificationApp* app = ctx;
+    return app->stop || app->count;
+}
+
+typedef struct {
+    uint32_t sequence;
+} HostNotificationWait;
+
+static bool host_notification_played(void* ctx) {
+    const HostNotificationWait* wait = ctx;
+    return host_notification.played >= wait->sequence;
+}
+
+/**
+ * Queues the sequence, blocks while the queue of the service is full
+ *
+ * @return number of the sequence
+ */
+static uint32_t host_notification_queue(NotificationApp* app, const NotificationSequence* sequence) {
+    host_wait(host_notification_has_space, app, FuriWaitForever);
+    app->sequences[(app->head + app->count) % HOST_SEQUENCES] = sequence;
+    app->count++;
+    host_changed();
+    return ++app->queued;
+}
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    pthread_mutex_lock(&host_lock);
+    host_notification_queue(app, sequence);
+    pthread_mutex_unlock(&host_lock);
+}
+
+void notification_message_block(NotificationApp* app, const NotificationSequence* sequence) {
+    pthread_mutex_lock(&host_lock);
+    HostNotificationWait wait = {.sequence = host_notification_queue(app, sequence)};
+    host_wait(host_notification_played, &wait, FuriWaitForever);
+    pthread_mutex_unlock(&host_lock);
+}
+
+static int32_t host_notification_thread(void* ctx) {
+    NotificationApp* app = ctx;
+    pthread_mutex_lock(&host_lock);
+    while(true) {
+        host_wait(host_notification_has_work, app, FuriWaitForever);
+        if(app->stop) break;
+        const NotificationSequence* sequence = app->sequences[app->head];
+        app->head = (app->head + 1) % HOST_SEQUENCES;
+        app->count--;
+        host_changed();
+        //the messages take as long as their delays, on the clock of the device
+        for(const NotificationMessage* const* message = *sequence; *message; message++) {
+            app->stats.messages++;
+            switch((*message)->type) {
+            case NotificationMessageTypeVibro:
+                app->stats.vibro = (*message)->value;
+                break;
+            case NotificationMessageTypeSound:
+                app->stats.sound = (*message)->value;
+                break;
+            case NotificationMessageTypeLed:
+                app->stats.led = (*message)->value;
+                break;
+            case NotificationMessageTypeDelay:
+                pthread_mutex_unlock(&host_lock);
+                furi_delay_ms((*message)->value);
+                pthread_mutex_lock(&host_lock);
+                break;
+            default:
+                break;
+            }
+        }
+        app->stats.sequences++;
+        app->played++;
+        host_changed();
+    }
+    pthread_mutex_unlock(&host_lock);
+    return 0;
+}
+
+void host_notification_setup(void) {
+    memset(&host_notification, 0, sizeof(NotificationApp));
+    host_notification.thread =
+        host_service_start("notification", 1024, host_notification_thread, &host_notification);
+}
+
+void host_notification_teardown(void) {
+    pthread_mutex_lock(&host_lock);
+    host_notification.stop = true;
+    host_changed();
+    pthread_mutex_unlock(&host_lock);
+    furi_thread_join(host_notification.thread);
+    furi_thread_free(host_notification.thread);
+}
+
+void* host_notification_record(void) {
+    return &host_notification;
+}
+
+HostNotificationStats host_notification_stats(void) {
+    pthread_mutex_lock(&host_lock);
+    const HostNotificationStats stats = host_notification.stats;
+    pthread_mutex_unlock(&host_lock);
+    return stats;
+}
@@ -0,0 +1,193 @@
+//------------------------------------------------------------------
+// storage.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+//-------------------------------------------------------------------
+
+#include "host_internal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Storage {
+    char root[256];
+    HostStorageStats stats;
+};
+
+struct File {
+    Storage* storage;
+    int descriptor;
+};
+
+static Storage host_storage;
+
+#define HOST_STORAGE_COUNT(field, amount) __atomic_add_fetch(&host_storage.stats.field, amount, __ATOMIC_RELAXED)
+
+void host_storage_setup(const char* root) {
+    strlcpy(host_storage.root, root, sizeof(host_storage.root));
+    memset(&host_storage.stats, 0, sizeof(HostStorageStats));
+}
+
+void* host_storage_record(void) {
+    return &host_storage;
+}
+
+HostStorageStats host_storage_stats(void) {
+    //read once the system settled, nothing counts at the same time
+    return host_storage.stats;
+}
+
+void host_storage_reset(void) {
+    memset(&host_storage.stats, 0, sizeof(HostStorageStats));
+}
+
+/**
+ * @return path of the host for the path on the sd card
+ */
+static void host_storage_path(const Storage* storage, const char* path, char* mapped, size_t size) {
+    snprintf(mapped, size, "%s%s", storage->root, path);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    File* file = calloc(1, sizeof(File));
+    file->storage = storage;
+    file->descriptor = -1;
+    return file;
+}
+
+void storage_file_free(File* file) {
+    if(file->descriptor >= 0) close(file->descriptor);
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    furi_check(file->descriptor < 0);
+    char mapped[512];
+    host_storage_path(file->storage, path, mapped, sizeof(mapped));
+    int flags = (access_mode & FSAM_WRITE) ? ((access_mode & FSAM_READ) ? O_RDWR : O_WRONLY) : O_RDONLY;
+    switch(open_mode) {
+    case FSOM_OPEN_ALWAYS:
+        flags |= O_CREAT;
+        break;
+    case FSOM_OPEN_APPEND:
+        flags |= O_CREAT | O_APPEND;
+        break;
+    case FSOM_CREATE_NEW:
+        flags |= O_CREAT | O_EXCL;
+        break;
+    case FSOM_CREATE_ALWAYS:
+        flags |= O_CREAT | O_TRUNC;
+        break;
+    default:
+        break;
+    }
+    HOST_STORAGE_COUNT(opens, 1);
+    file->descriptor = open(mapped, flags, 0644);
+    return file->descriptor >= 0;
+}
+
+bool storage_file_close(File* file) {
+    if(file->descriptor < 0) return false;
+    close(file->descriptor);
+    file->descriptor = -1;
+    return true;
+}
+
+bool storage_file_is_open(File* file) {
+    return file->descriptor >= 0;
+}
+
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read) {
+    if(file->descriptor < 0) return 0;
+    const ssize_t bytes = read(file->descriptor, buff, bytes_to_read);
+    HOST_STORAGE_COUNT(reads, 1);
+    if(bytes <= 0) return 0;
+    HOST_STORAGE_COUNT(read_bytes, bytes);
+    return bytes;
+}
+
+uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write) {
+    if(file->descriptor < 0) return 0;
+    const ssize_t bytes = write(file->descriptor, buff, bytes_to_write);
+    HOST_STORAGE_COUNT(writes, 1);
+    if(bytes <= 0) return 0;
+    HOST_STORAGE_COUNT(write_bytes, bytes);
+    return bytes;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    if(file->descriptor < 0) return false;
+    HOST_STORAGE_COUNT(seeks, 1);
+    return lseek(file->descriptor, offset, from_start ? SEEK_SET : SEEK_CUR) >= 0;
+}
+
+uint64_t storage_file_size(File* file) {
+    struct stat status;
+    if(file->descriptor < 0 || fstat(file->descriptor, &status) != 0) return 0;
+    return status.st_size;
+}
+
+bool storage_file_sync(File* file) {
+    //counted only, the sd card of the host is a temporary directory
+    HOST_STORAGE_COUNT(syncs, 1);
+    return file->descriptor >= 0;
+}
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
+    char mapped[512];
+    host_storage_path(storage, path, mapped, sizeof(mapped));
+    HOST_STORAGE_COUNT(stats, 1);
+    struct stat status;
+    if(stat(mapped, &status) != 0) return FSE_NOT_EXIST;
+    if(fileinfo) {
+        fileinfo->flags = S_ISDIR(status.st_mode) ? 1 : 0;
+        fileinfo->size = status.st_size;
+    }
+    return FSE_OK;
+}
+
+FS_Error storage_common_remove(Storage* storage, const char* path) {
+    char mapped[512];
+    host_storage_path(storage, path, mapped, sizeof(mapped));
+    HOST_STORAGE_COUNT(removes, 1);
+    return remove(mapped) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
+
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path) {
+    char mapped_old[512];
+    char mapped_new[512];
+    host_storage_path(storage, old_path, mapped_old, sizeof(mapped_old));
+    host_storage_path(storage, new_path, mapped_new, sizeof(mapped_new));
+    HOST_STORAGE_COUNT(renames, 1);
+    //FAT does not replace an existing file
+    if(access(mapped_new, F_OK) == 0) return FSE_EXIST;
+    return rename(mapped_old, mapped_new) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    char mapped[512];
+    host_storage_path(storage, path, mapped, sizeof(mapped));
+    HOST_STORAGE_COUNT(stats, 1);
+    return mkdir(mapped, 0755) == 0 || errno == EEXIST;
+}
+
+bool host_file_write(const char* path, const void* data, size_t size) {
+    char mapped[512];
+    host_storage_path(&host_storage, path, mapped, sizeof(mapped));
+    FILE* file = fopen(mapped, "wb");
+    if(!file) return false;
+    const bool written = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+long host_file_read(const char* path, void* data, size_t capacity) {
+    char mapped[512];
+    host_storage_path(&host_storage, path, mapped, sizeof(mapped));
+    FILE* file = fopen(mapped, "rb");
+    if(!file) return -1;
+    const size_t bytes = fread(data, 1, capacity, file);
+    fclose(file);
+    return bytes;
+}
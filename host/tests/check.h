@@ -0,0 +1,38 @@
+#pragma once
+//------------------------------------------------------------------
+// check.h
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Assertions of the host tests. A failed check prints where it failed and ends the test with
+//                   an exit code ctest reports as a failure.
+//-------------------------------------------------------------------
+
+#include <host.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(condition)                                                                       \
+    do {                                                                                       \
+        if(!(condition)) {                                                                     \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);      \
+            exit(1);                                                                           \
+        }                                                                                      \
+    } while(0)
+
+#define CHECK_EQUAL(actual, expected)                                                          \
+    do {                                                                                       \
+        const long long check_actual = (long long)(actual);                                    \
+        const long long check_expected = (long long)(expected);                                \
+        if(check_actual != check_expected) {                                                   \
+            fprintf(                                                                           \
+                stderr,                                                                        \
+                "%s:%d: check failed: %s is %lld, expected %lld\n",                            \
+                __FILE__,                                                                      \
+                __LINE__,                                                                      \
+                #actual,                                                                       \
+                check_actual,                                                                  \
+                check_expected);                                                               \
+            exit(1);                                                                           \
+        }                                                                                      \
+    } while(0)
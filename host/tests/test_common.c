@@ -0,0 +1,237 @@
+//------------------------------------------------------------------
+// test_common.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Shared headers of both apps: the acceleration curve and the folding of held keys of the
+//                   input stage, the triple buffer of the render state on one and on two threads, and the
+//                   back buffer against a plain pixel array under random spans, boxes and frames.
+//-------------------------------------------------------------------
+
+#include "check.h"
+#include "../../common/app_input.h"
+#include "../../common/app_snapshot.h"
+#include "../../common/app_backbuffer.h"
+
+#define TEST_COMMON_FRAMES 200000
+
+static void test_input_curve(void) {
+    const AppInputCurve curve = {.start = 1, .limit = 16, .doubling = 1};
+    CHECK_EQUAL(app_input_step(&curve, 0), 1);
+    CHECK_EQUAL(app_input_step(&curve, 1), 2);
+    CHECK_EQUAL(app_input_step(&curve, 3), 8);
+    CHECK_EQUAL(app_input_step(&curve, 4), 16);
+    CHECK_EQUAL(app_input_step(&curve, 1000), 16);
+
+    //a doubling of 0 is taken as 1
+    const AppInputCurve slow = {.start = 3, .limit = 20, .doubling = 0};
+    CHECK_EQUAL(app_input_step(&slow, 1), 6);
+    CHECK_EQUAL(app_input_step(&slow, 2), 12);
+    CHECK_EQUAL(app_input_step(&slow, 3), 20);
+}
+
+static void test_input_coalesce(void) {
+    const AppInputCurve curve = {.start = 1, .limit = 16, .doubling = 1};
+    AppInput input = {0};
+    const InputEvent press = {.key = InputKeyUp, .type = InputTypePress};
+    const InputEvent held = {.key = InputKeyUp, .type = InputTypeLong};
+    const InputEvent repeat = {.key = InputKeyUp, .type = InputTypeRepeat};
+
+    CHECK(app_input_coalesce(&input, &press));
+    app_input_latch(&input, &press);
+    CHECK_EQUAL(app_input_take(&input, &curve, &press), 1);
+    CHECK(app_input_coalesce(&input, &held));
+    app_input_latch(&input, &held);
+    CHECK_EQUAL(app_input_take(&input, &curve, &held), 2);
+
+    //repeats while one is queued are folded into it and taken with it
+    CHECK(app_input_coalesce(&input, &repeat));
+    CHECK(!app_input_coalesce(&input, &repeat));
+    CHECK(!app_input_coalesce(&input, &repeat));
+    CHECK_EQUAL(input.coalesced, 2);
+    app_input_latch(&input, &repeat);
+    CHECK_EQUAL(app_input_take(&input, &curve, &repeat), 4 + 8 + 16);
+    //taken once, the same event again adds nothing
+    CHECK_EQUAL(app_input_take(&input, &curve, &repeat), 0);
+
+    //the latch clears the queued flag, so the next repeat is queued again
+    CHECK(app_input_coalesce(&input, &repeat));
+    app_input_latch(&input, &repeat);
+    CHECK_EQUAL(app_input_take(&input, &curve, &repeat), 16);
+
+    //a new press starts the curve over, other keys are not affected
+    const InputEvent other = {.key = InputKeyDown, .type = InputTypeRepeat};
+    CHECK(app_input_coalesce(&input, &other));
+    CHECK(app_input_coalesce(&input, &press));
+    app_input_latch(&input, &press);
+    CHECK_EQUAL(app_input_take(&input, &curve, &press), 1);
+    CHECK(app_input_coalesce(&input, &held));
+    app_input_latch(&input, &held);
+    CHECK_EQUAL(app_input_take(&input, &curve, &held), 2);
+    CHECK(!app_input_coalesce(&input, &other));
+}
+
+static void test_snapshot_order(void) {
+    AppSnapshot* snapshot = app_snapshot_alloc(sizeof(uint32_t));
+    CHECK_EQUAL(*(const uint32_t*)app_snapshot_acquire(snapshot, UINT32_MAX), 0);
+
+    //the reader gets the newest frame, the ones published before it are dropped
+    for(uint32_t frame = 1; frame <= 3; frame++) {
+        *(uint32_t*)app_snapshot_back(snapshot) = frame;
+        app_snapshot_publish(snapshot);
+    }
+    CHECK_EQUAL(snapshot->dropped, 2);
+    CHECK_EQUAL(*(const uint32_t*)app_snapshot_acquire(snapshot, UINT32_MAX), 3);
+    //without a new frame the reader keeps the one it has
+    CHECK_EQUAL(*(const uint32_t*)app_snapshot_acquire(snapshot, UINT32_MAX), 3);
+
+    //the three slots are never shared between the writer and the reader
+    for(uint32_t frame = 4; frame < 100; frame++) {
+        uint32_t* back = app_snapshot_back(snapshot);
+        CHECK(back != app_snapshot_acquire(snapshot, UINT32_MAX));
+        *back = frame;
+        app_snapshot_publish(snapshot);
+        if(frame % 3) CHECK_EQUAL(*(const uint32_t*)app_snapshot_acquire(snapshot, UINT32_MAX), frame);
+    }
+    CHECK_EQUAL(snapshot->delayed, 0);
+    app_snapshot_free(snapshot);
+}
+
+/**
+ * Frame of the threaded test, a torn frame has fields of two publishes
+ */
+typedef struct {
+    uint32_t number;
+    uint32_t copies[15];
+} TestCommonFrame;
+
+static int32_t test_snapshot_writer(void* ctx) {
+    AppSnapshot* snapshot = ctx;
+    for(uint32_t number = 1; number <= TEST_COMMON_FRAMES; number++) {
+        TestCommonFrame* frame = app_snapshot_back(snapshot);
+        frame->number = number;
+        for(size_t i = 0; i < COUNT_OF(frame->copies); i++) frame->copies[i] = number;
+        app_snapshot_publish(snapshot);
+    }
+    return 0;
+}
+
+static void test_snapshot_threads(void) {
+    AppSnapshot* snapshot = app_snapshot_alloc(sizeof(TestCommonFrame));
+    FuriThread* writer = furi_thread_alloc();
+    furi_thread_set_name(writer, "TestWriter");
+    furi_thread_set_stack_size(writer, 1024);
+    furi_thread_set_context(writer, snapshot);
+    furi_thread_set_callback(writer, test_snapshot_writer);
+    furi_thread_start(writer);
+
+    //frames are read whole and never older than the one read before
+    uint32_t last = 0;
+    uint32_t reads = 0;
+    while(last < TEST_COMMON_FRAMES) {
+        const TestCommonFrame* frame = app_snapshot_acquire(snapshot, UINT32_MAX);
+        for(size_t i = 0; i < COUNT_OF(frame->copies); i++) CHECK_EQUAL(frame->copies[i], frame->number);
+        CHECK(frame->number >= last);
+        last = frame->number;
+        reads++;
+    }
+    furi_thread_join(writer);
+    furi_thread_free(writer);
+    CHECK(reads > 0);
+    app_snapshot_free(snapshot);
+}
+
+static bool pixels[APP_BACKBUFFER_HEIGHT][APP_BACKBUFFER_WIDTH];
+
+/**
+ * Applies the operation to one pixel of the reference, pixels outside of the screen are ignored
+ */
+static void test_backbuffer_pixel(int16_t x, int16_t y, AppBackBufferOp op) {
+    if(x < 0 || y < 0 || x >= APP_BACKBUFFER_WIDTH || y >= APP_BACKBUFFER_HEIGHT) return;
+    switch(op) {
+    case AppBackBufferSet:
+        pixels[y][x] = true;
+        break;
+    case AppBackBufferClear:
+        pixels[y][x] = false;
+        break;
+    case AppBackBufferXor:
+        pixels[y][x] = !pixels[y][x];
+        break;
+    }
+}
+
+/**
+ * @return true if the buffer has the pixels of the reference
+ */
+static bool test_backbuffer_equal(const AppBackBuffer* buffer) {
+    for(int16_t y = 0; y < APP_BACKBUFFER_HEIGHT; y++) {
+        for(int16_t x = 0; x < APP_BACKBUFFER_WIDTH; x++) {
+            if(((buffer->rows[y][x / 32] >> (x % 32)) & 1) != pixels[y][x]) return false;
+        }
+    }
+    return true;
+}
+
+static void test_backbuffer(void) {
+    static AppBackBuffer buffer;
+    app_backbuffer_clear(&buffer);
+    memset(pixels, 0, sizeof(pixels));
+    srand(1);
+    for(uint32_t step = 0; step < 20000; step++) {
+        //shapes reach past every edge of the screen
+        const int16_t x = rand() % 160 - 16;
+        const int16_t y = rand() % 96 - 16;
+        const uint8_t width = rand() % 140;
+        const uint8_t height = rand() % 70;
+        const AppBackBufferOp op = rand() % 3;
+        switch(rand() % 4) {
+        case 0:
+            app_backbuffer_dot(&buffer, x, y, op);
+            test_backbuffer_pixel(x, y, op);
+            break;
+        case 1:
+            app_backbuffer_hspan(&buffer, x, x + width, y, op);
+            for(int16_t column = x; column <= x + width; column++) test_backbuffer_pixel(column, y, op);
+            break;
+        case 2:
+            app_backbuffer_box(&buffer, x, y, width, height, op);
+            for(int16_t row = y; row < y + height; row++) {
+                for(int16_t column = x; column < x + width; column++) test_backbuffer_pixel(column, row, op);
+            }
+            break;
+        default:
+            app_backbuffer_frame(&buffer, x, y, width, height, op);
+            for(int16_t row = y; row < y + height; row++) {
+                for(int16_t column = x; column < x + width; column++) {
+                    if(row == y || row == y + height - 1 || column == x || column == x + width - 1) {
+                        test_backbuffer_pixel(column, row, op);
+                    }
+                }
+            }
+            break;
+        }
+        CHECK(test_backbuffer_equal(&buffer));
+    }
+
+    //the copy to the canvas draws the same pixels
+    Canvas* canvas = host_canvas_alloc();
+    app_backbuffer_blit(&buffer, canvas);
+    for(uint8_t y = 0; y < APP_BACKBUFFER_HEIGHT; y++) {
+        for(uint8_t x = 0; x < APP_BACKBUFFER_WIDTH; x++) {
+            CHECK_EQUAL(host_canvas_pixel(canvas, x, y), pixels[y][x]);
+        }
+    }
+    host_canvas_free(canvas);
+}
+
+int main(void) {
+    host_setup();
+    test_input_curve();
+    test_input_coalesce();
+    test_snapshot_order();
+    test_snapshot_threads();
+    test_backbuffer();
+    host_teardown();
+    return 0;
+}
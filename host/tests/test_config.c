@@ -0,0 +1,157 @@
+//------------------------------------------------------------------
+// test_config.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Parser of the Pomodoro config: values of a valid file are taken over, a file without the
+//                   header of this version falls back to the defaults, also if a header line is longer than the
+//                   read buffer, and lines of any length are skipped after the header. A missing journal is only
+//                   created by its first record.
+//-------------------------------------------------------------------
+
+#include "check.h"
+#include "../../Pomodoro/helpers/pomodoro_file_access.h"
+#include "../../Pomodoro/helpers/pomodoro_journal.h"
+
+#define TEST_CONFIG_HEADER "Filetype: " POMODORO_FILE_HEADER "\nVersion: 1\n"
+
+static char text[4096];
+
+/**
+ * Writes the config file and loads it
+ *
+ * @param content content of the file
+ * @param pomodoro filled with the loaded values
+ */
+static void test_config_load(const char* content, Pomodoro* pomodoro) {
+    CHECK(host_file_write(POMODORO_FILE_PATH, content, strlen(content)));
+    pomodoro_get_initial_values(pomodoro);
+}
+
+/**
+ * @param length number of characters
+ *
+ * @return line of that many characters without a line break, valid until the next call
+ */
+static const char* test_config_long(size_t length) {
+    static char line[2048];
+    CHECK(length < sizeof(line));
+    memset(line, 'x', length);
+    line[length] = '\0';
+    return line;
+}
+
+static void test_valid(void) {
+    Pomodoro pomodoro;
+    test_config_load(
+        TEST_CONFIG_HEADER "workTime: 40\nshortBreakTime: 7\nlongBreakTime: 30\ncycle: 3\nrepetitions: 2\n", &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], 40);
+    CHECK_EQUAL(pomodoro.durations[shortBreakTime], 7);
+    CHECK_EQUAL(pomodoro.durations[longBreakTime], 30);
+    CHECK_EQUAL(pomodoro.cycle, 3);
+    CHECK_EQUAL(pomodoro.repetitions, 2);
+
+    //line breaks of windows, unknown keys, comments and a last line without a line break
+    test_config_load(
+        "Filetype: " POMODORO_FILE_HEADER "\r\nVersion: 1\r\n# comment\r\nfuture: 9\r\nworkTime: 41\r\ncycle: 5",
+        &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], 41);
+    CHECK_EQUAL(pomodoro.cycle, 5);
+
+    //a line longer than the buffer after the header is skipped, so is a key at its end
+    snprintf(
+        text,
+        sizeof(text),
+        TEST_CONFIG_HEADER "%s workTime: 1\nworkTime: 42\n",
+        test_config_long(1000));
+    test_config_load(text, &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], 42);
+}
+
+static void test_foreign(void) {
+    Pomodoro defaults;
+    pomodoro_get_default_values(&defaults);
+    Pomodoro pomodoro;
+
+    test_config_load("Filetype: Other\nVersion: 1\nworkTime: 40\n", &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+
+    test_config_load("Filetype: " POMODORO_FILE_HEADER "\nVersion: 2\nworkTime: 40\n", &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+
+    //the header is the first two lines, not anywhere in the file
+    test_config_load("workTime: 40\n" TEST_CONFIG_HEADER, &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+
+    //header lines longer than the buffer, with and without the header at their end
+    for(size_t length = 250; length < 1200; length += 97) {
+        snprintf(
+            text,
+            sizeof(text),
+            "%s: " POMODORO_FILE_HEADER "\nVersion: 1\nworkTime: 40\n",
+            test_config_long(length));
+        test_config_load(text, &pomodoro);
+        CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+
+        snprintf(
+            text,
+            sizeof(text),
+            "Filetype: " POMODORO_FILE_HEADER "\n%sVersion: 1\nworkTime: 40\n",
+            test_config_long(length));
+        test_config_load(text, &pomodoro);
+        CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+    }
+
+    //files that end inside the header
+    test_config_load("", &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+    test_config_load("Filetype: " POMODORO_FILE_HEADER, &pomodoro);
+    CHECK_EQUAL(pomodoro.durations[workTime], defaults.durations[workTime]);
+}
+
+static void test_saved(void) {
+    //what a save writes is read back
+    Pomodoro pomodoro;
+    pomodoro_get_default_values(&pomodoro);
+    pomodoro.durations[workTime] = 33;
+    pomodoro.cycle = 6;
+    CHECK(pomodoro_save_settings(&pomodoro));
+
+    Pomodoro loaded;
+    pomodoro_get_initial_values(&loaded);
+    CHECK_EQUAL(loaded.durations[workTime], 33);
+    CHECK_EQUAL(loaded.cycle, 6);
+}
+
+static void test_journal_fresh(void) {
+    //a missing journal is left alone until the first record, which creates it
+    host_storage_reset();
+    PomodoroJournal* journal = pomodoro_journal_alloc();
+    PomodoroJournalRecord record;
+    CHECK(!pomodoro_journal_recover(journal, &record));
+    CHECK_EQUAL(host_storage_stats().writes, 0);
+    CHECK_EQUAL(host_storage_stats().stats, 0);
+    CHECK_EQUAL(host_file_read(POMODORO_JOURNAL_PATH, text, sizeof(text)), -1);
+
+    Pomodoro pomodoro;
+    pomodoro_get_default_values(&pomodoro);
+    pomodoro.repetitions = 2;
+    CHECK(pomodoro_journal_append(journal, &pomodoro, 100, 1000));
+    pomodoro_journal_free(journal);
+
+    journal = pomodoro_journal_alloc();
+    CHECK(pomodoro_journal_recover(journal, &record));
+    CHECK_EQUAL(record.repetitions, 2);
+    pomodoro_journal_free(journal);
+}
+
+int main(void) {
+    host_setup();
+    //the first save creates the directory
+    test_saved();
+    test_journal_fresh();
+    test_valid();
+    test_foreign();
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------
+// test_phase.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Transition table of the Pomodoro phases: every event on every interval, chosen interval and
+//                   repetition of cycles of several lengths against the rules written out, the work intervals
+//                   between two long breaks, a shortened cycle, and the continuation after a closed app against
+//                   finishing one interval after the other.
+//-------------------------------------------------------------------
+
+#include "check.h"
+#include "../../Pomodoro/helpers/pomodoro_phase.h"
+
+#define TEST_PHASE_CYCLES 6
+
+/**
+ * @return run in the settings with the given interval, chosen interval and repetitions
+ */
+static Pomodoro test_phase_run(PomodoroState state, PomodoroState selected, uint32_t repetitions, uint32_t cycle) {
+    Pomodoro pomodoro = {
+        .durations = {[workTime] = 25, [shortBreakTime] = 5, [longBreakTime] = 15},
+        .cycle = cycle,
+        .repetitions = repetitions,
+        .totalruns = 7,
+        .state = state,
+        .selected = selected,
+    };
+    return pomodoro;
+}
+
+static void test_transitions(void) {
+    for(uint32_t cycle = 1; cycle <= TEST_PHASE_CYCLES; cycle++) {
+        for(uint32_t repetitions = 0; repetitions < cycle; repetitions++) {
+            for(uint8_t state = 0; state < PomodoroStateCount; state++) {
+                for(uint8_t selected = 0; selected < PomodoroStateCount; selected++) {
+                    for(uint8_t event = 0; event < PomodoroEventCount; event++) {
+                        Pomodoro pomodoro = test_phase_run(state, selected, repetitions, cycle);
+                        Pomodoro expected = pomodoro;
+                        switch(event) {
+                        case PomodoroEventNext:
+                            expected.selected = (selected + 1) % PomodoroStateCount;
+                            break;
+                        case PomodoroEventPrevious:
+                            expected.selected = (selected + PomodoroStateCount - 1) % PomodoroStateCount;
+                            break;
+                        case PomodoroEventReset:
+                            expected.state = workTime;
+                            expected.selected = workTime;
+                            expected.repetitions = 0;
+                            break;
+                        case PomodoroEventFinish:
+                            if(state == workTime) {
+                                expected.totalruns++;
+                                expected.repetitions = (repetitions + 1) % cycle;
+                                expected.state = repetitions + 1 == cycle ? longBreakTime : shortBreakTime;
+                            } else {
+                                expected.state = workTime;
+                            }
+                            expected.selected = expected.state;
+                            break;
+                        }
+
+                        pomodoro_phase_apply(&pomodoro, event);
+                        CHECK_EQUAL(pomodoro.state, expected.state);
+                        CHECK_EQUAL(pomodoro.selected, expected.selected);
+                        CHECK_EQUAL(pomodoro.repetitions, expected.repetitions);
+                        CHECK_EQUAL(pomodoro.totalruns, expected.totalruns);
+                        CHECK_EQUAL(pomodoro.cycle, cycle);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void test_cycles(void) {
+    for(uint32_t cycle = 1; cycle <= TEST_PHASE_CYCLES; cycle++) {
+        Pomodoro pomodoro = test_phase_run(workTime, workTime, 0, cycle);
+        //three cycles of work intervals with short breaks between them and a long break at their end
+        for(uint32_t round = 0; round < 3; round++) {
+            for(uint32_t work = 0; work < cycle; work++) {
+                CHECK_EQUAL(pomodoro.state, workTime);
+                pomodoro_phase_apply(&pomodoro, PomodoroEventFinish);
+                CHECK_EQUAL(pomodoro.state, work + 1 == cycle ? longBreakTime : shortBreakTime);
+                pomodoro_phase_apply(&pomodoro, PomodoroEventFinish);
+            }
+        }
+        CHECK_EQUAL(pomodoro.totalruns, 7 + 3 * cycle);
+    }
+
+    //a cycle shortened below the repetitions of the run ends with the next work interval
+    Pomodoro pomodoro = test_phase_run(workTime, workTime, 3, 4);
+    pomodoro_phase_set_cycle(&pomodoro, 2);
+    CHECK_EQUAL(pomodoro.repetitions, 1);
+    pomodoro_phase_apply(&pomodoro, PomodoroEventFinish);
+    CHECK_EQUAL(pomodoro.state, longBreakTime);
+    CHECK_EQUAL(pomodoro.repetitions, 0);
+
+    pomodoro_phase_set_cycle(&pomodoro, 0);
+    CHECK_EQUAL(pomodoro.cycle, 1);
+}
+
+static void test_continue(void) {
+    const uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    srand(1);
+    for(uint32_t i = 0; i < 20000; i++) {
+        const uint32_t cycle = 1 + rand() % TEST_PHASE_CYCLES;
+        Pomodoro pomodoro = test_phase_run(rand() % PomodoroStateCount, workTime, rand() % cycle, cycle);
+        for(uint8_t state = 0; state < PomodoroStateCount; state++) {
+            pomodoro.durations[state] = 1 + rand() % 30;
+        }
+        pomodoro.selected = pomodoro.state;
+        pomodoro.running = true;
+        pomodoro.runElapsed = (rand() % (pomodoro.durations[pomodoro.state] * 60)) * tick_frequency;
+        //up to about ten cycles of the longest intervals
+        const uint32_t seconds = rand() % (10 * (cycle + 1) * 30 * 60);
+
+        //the reference finishes one interval after the other
+        Pomodoro expected = pomodoro;
+        uint32_t remaining = expected.runElapsed / tick_frequency + seconds;
+        while(remaining >= expected.durations[expected.state] * 60) {
+            remaining -= expected.durations[expected.state] * 60;
+            pomodoro_phase_apply(&expected, PomodoroEventFinish);
+        }
+
+        pomodoro_phase_continue(&pomodoro, seconds);
+        CHECK_EQUAL(pomodoro.state, expected.state);
+        CHECK_EQUAL(pomodoro.selected, expected.state);
+        CHECK_EQUAL(pomodoro.repetitions, expected.repetitions);
+        CHECK_EQUAL(pomodoro.totalruns, expected.totalruns);
+        CHECK_EQUAL(pomodoro.runElapsed, remaining * tick_frequency);
+        CHECK_EQUAL(pomodoro.count, remaining / 60);
+        CHECK(pomodoro.running);
+        CHECK(!pomodoro.notification);
+    }
+}
+
+int main(void) {
+    test_transitions();
+    test_cycles();
+    test_continue();
+    return 0;
+}
@@ -0,0 +1,285 @@
+//------------------------------------------------------------------
+// test_records.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      History, stats and profiles on top of the shared records file: files are only created by
+//                   their first write, at their full size, survive a reopen and are created again if their header
+//                   is broken. A new profiles file starts on the times of the config, profiles are added and renamed.
+//-------------------------------------------------------------------
+
+#include "check.h"
+#include "../../Pomodoro/helpers/pomodoro_history.h"
+#include "../../Pomodoro/helpers/pomodoro_stats.h"
+#include "../../Pomodoro/helpers/pomodoro_profiles.h"
+
+static uint8_t data[8192];
+
+static void test_fresh(void) {
+    //a fresh install only looks for the files, nothing is created until the first write
+    host_storage_reset();
+    PomodoroHistory* history = pomodoro_history_alloc();
+    PomodoroStats* stats = pomodoro_stats_alloc();
+    const Pomodoro settings = {.durations = {[workTime] = 25, [shortBreakTime] = 5, [longBreakTime] = 30}, .cycle = 4};
+    PomodoroProfiles* profiles = pomodoro_profiles_alloc(&settings);
+    CHECK_EQUAL(pomodoro_history_count(history), 0);
+    CHECK_EQUAL(pomodoro_stats_totals(stats)->sessions, 0);
+    PomodoroStatsBucket bucket;
+    CHECK(pomodoro_stats_read_day(stats, 20000, &bucket));
+    CHECK_EQUAL(bucket.sessions, 0);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 4);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Classic") == 0);
+    CHECK(pomodoro_profiles_select(profiles, 0));
+    const HostStorageStats storage = host_storage_stats();
+    CHECK_EQUAL(storage.writes, 0);
+    CHECK_EQUAL(storage.stats, 0);
+    CHECK_EQUAL(host_file_read(POMODORO_HISTORY_PATH, data, sizeof(data)), -1);
+    CHECK_EQUAL(host_file_read(POMODORO_STATS_PATH, data, sizeof(data)), -1);
+    CHECK_EQUAL(host_file_read(POMODORO_PROFILES_PATH, data, sizeof(data)), -1);
+
+    //the first write creates the file at its full size
+    const PomodoroHistoryEntry entry = {.start = 1, .actual = 60, .planned = 1, .type = workTime};
+    CHECK(pomodoro_history_append(history, &entry));
+    CHECK_EQUAL(
+        host_file_read(POMODORO_HISTORY_PATH, data, sizeof(data)),
+        sizeof(PomodoroHistoryHeader) + POMODORO_HISTORY_CAPACITY * sizeof(PomodoroHistoryEntry));
+    CHECK(pomodoro_profiles_select(profiles, 1));
+    CHECK_EQUAL(
+        host_file_read(POMODORO_PROFILES_PATH, data, sizeof(data)),
+        sizeof(PomodoroProfilesHeader) + POMODORO_PROFILES_CAPACITY * sizeof(PomodoroProfile));
+    pomodoro_history_free(history);
+    pomodoro_stats_free(stats);
+    pomodoro_profiles_free(profiles);
+
+    history = pomodoro_history_alloc();
+    CHECK_EQUAL(pomodoro_history_count(history), 1);
+    pomodoro_history_free(history);
+    profiles = pomodoro_profiles_alloc(NULL);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Deep work") == 0);
+    CHECK(pomodoro_profiles_select(profiles, 0));
+    pomodoro_profiles_free(profiles);
+}
+
+static void test_history(void) {
+    PomodoroHistory* history = pomodoro_history_alloc();
+    CHECK(history);
+
+    //wraps around the end of the file
+    for(uint32_t i = 0; i < POMODORO_HISTORY_CAPACITY + 10; i++) {
+        const PomodoroHistoryEntry entry = {.start = i, .actual = 60, .planned = 1, .type = workTime};
+        CHECK(pomodoro_history_append(history, &entry));
+    }
+    pomodoro_history_free(history);
+
+    history = pomodoro_history_alloc();
+    CHECK_EQUAL(pomodoro_history_count(history), POMODORO_HISTORY_CAPACITY);
+    PomodoroHistoryEntry entries[20];
+    CHECK_EQUAL(pomodoro_history_read(history, 0, entries, COUNT_OF(entries)), COUNT_OF(entries));
+    for(uint32_t i = 0; i < COUNT_OF(entries); i++) {
+        CHECK_EQUAL(entries[i].start, POMODORO_HISTORY_CAPACITY + 9 - i);
+    }
+    //the oldest page lies before the head
+    CHECK_EQUAL(pomodoro_history_read(history, POMODORO_HISTORY_CAPACITY - 5, entries, COUNT_OF(entries)), 5);
+    CHECK_EQUAL(entries[4].start, 10);
+    pomodoro_history_free(history);
+
+    const uint32_t broken = 0;
+    CHECK(host_file_write(POMODORO_HISTORY_PATH, &broken, sizeof(broken)));
+    history = pomodoro_history_alloc();
+    CHECK(history);
+    CHECK_EQUAL(pomodoro_history_count(history), 0);
+    pomodoro_history_free(history);
+
+    //a file of another capacity is created again
+    const PomodoroHistoryHeader other = {
+        .magic = POMODORO_HISTORY_MAGIC,
+        .version = POMODORO_HISTORY_VERSION,
+        .capacity = POMODORO_HISTORY_CAPACITY / 2,
+        .head = 3,
+        .count = 3,
+    };
+    CHECK(host_file_write(POMODORO_HISTORY_PATH, &other, sizeof(other)));
+    history = pomodoro_history_alloc();
+    CHECK_EQUAL(pomodoro_history_count(history), 0);
+    CHECK(pomodoro_history_append(history, &entries[0]));
+    CHECK_EQUAL(
+        host_file_read(POMODORO_HISTORY_PATH, data, sizeof(data)),
+        sizeof(PomodoroHistoryHeader) + POMODORO_HISTORY_CAPACITY * sizeof(PomodoroHistoryEntry));
+    pomodoro_history_free(history);
+    history = pomodoro_history_alloc();
+    CHECK_EQUAL(pomodoro_history_count(history), 1);
+    pomodoro_history_free(history);
+}
+
+static void test_stats(void) {
+    PomodoroStats* stats = pomodoro_stats_alloc();
+    CHECK(stats);
+    const uint32_t day = 20000;
+    CHECK(pomodoro_stats_add(stats, day * 86400 + 100, 1500));
+    CHECK(pomodoro_stats_add(stats, day * 86400 + 200, 1500));
+    CHECK(pomodoro_stats_add(stats, (day + 1) * 86400, 600));
+    pomodoro_stats_free(stats);
+
+    stats = pomodoro_stats_alloc();
+    const PomodoroStatsHeader* totals = pomodoro_stats_totals(stats);
+    CHECK_EQUAL(totals->sessions, 3);
+    CHECK_EQUAL(totals->seconds, 3600);
+    CHECK_EQUAL(pomodoro_stats_streak(stats, day + 1), 2);
+    PomodoroStatsBucket bucket;
+    CHECK(pomodoro_stats_read_day(stats, day, &bucket));
+    CHECK_EQUAL(bucket.sessions, 2);
+    CHECK_EQUAL(bucket.seconds, 3000);
+    //the slot of the day was never written for this day
+    CHECK(pomodoro_stats_read_day(stats, day + POMODORO_STATS_DAYS, &bucket));
+    CHECK_EQUAL(bucket.sessions, 0);
+    CHECK(pomodoro_stats_read_week(stats, pomodoro_stats_week(day), &bucket));
+    CHECK(bucket.sessions >= 2);
+
+    //with the writer the totals change right away and the buckets once it has written them
+    pomodoro_file_start();
+    for(uint8_t i = 0; i < 20; i++) CHECK(pomodoro_stats_add(stats, (day + 2) * 86400 + i, 60));
+    CHECK_EQUAL(totals->sessions, 23);
+    CHECK_EQUAL(pomodoro_stats_streak(stats, day + 2), 3);
+    CHECK(pomodoro_file_stop(UINT32_MAX));
+    CHECK(pomodoro_stats_read_day(stats, day + 2, &bucket));
+    CHECK_EQUAL(bucket.sessions, 20);
+    CHECK_EQUAL(bucket.seconds, 1200);
+    pomodoro_stats_free(stats);
+    stats = pomodoro_stats_alloc();
+    CHECK_EQUAL(pomodoro_stats_totals(stats)->seconds, 4800);
+    pomodoro_stats_free(stats);
+
+    //a file with other days or weeks is created again
+    for(uint8_t i = 0; i < 2; i++) {
+        PomodoroStatsHeader other = {
+            .magic = POMODORO_STATS_MAGIC,
+            .version = POMODORO_STATS_VERSION,
+            .days = POMODORO_STATS_DAYS,
+            .weeks = POMODORO_STATS_WEEKS,
+            .sessions = 9,
+        };
+        if(i) {
+            other.weeks /= 2;
+        } else {
+            other.days /= 2;
+        }
+        CHECK(host_file_write(POMODORO_STATS_PATH, &other, sizeof(other)));
+        stats = pomodoro_stats_alloc();
+        CHECK_EQUAL(pomodoro_stats_totals(stats)->sessions, 0);
+        CHECK_EQUAL(pomodoro_stats_totals(stats)->days, POMODORO_STATS_DAYS);
+        pomodoro_stats_free(stats);
+    }
+}
+
+static void test_profiles(void) {
+    PomodoroProfiles* profiles = pomodoro_profiles_alloc(NULL);
+    CHECK(profiles);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 4);
+    CHECK_EQUAL(pomodoro_profiles_index(profiles), 0);
+    CHECK(pomodoro_profiles_select(profiles, 2));
+    CHECK(!pomodoro_profiles_select(profiles, 4));
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Study") == 0);
+
+    Pomodoro pomodoro = {.durations = {[workTime] = 45, [shortBreakTime] = 5, [longBreakTime] = 20}, .cycle = 3};
+    CHECK(pomodoro_profiles_store(profiles, &pomodoro));
+    pomodoro_profiles_free(profiles);
+
+    profiles = pomodoro_profiles_alloc(NULL);
+    CHECK_EQUAL(pomodoro_profiles_index(profiles), 2);
+    CHECK_EQUAL(pomodoro_profiles_current(profiles)->durations[workTime], 45);
+    CHECK_EQUAL(pomodoro_profiles_current(profiles)->durations[longBreakTime], 20);
+
+    //added profiles take the next record and are the current one
+    pomodoro.durations[workTime] = 35;
+    CHECK_EQUAL(pomodoro_profiles_create(profiles, "Reading", &pomodoro), 4);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 5);
+    CHECK(pomodoro_profiles_rename(profiles, "Books"));
+    pomodoro_profiles_free(profiles);
+
+    profiles = pomodoro_profiles_alloc(NULL);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 5);
+    CHECK_EQUAL(pomodoro_profiles_index(profiles), 4);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Books") == 0);
+    CHECK_EQUAL(pomodoro_profiles_current(profiles)->durations[workTime], 35);
+    //switching back and forth does not depend on the number of profiles
+    CHECK(pomodoro_profiles_select(profiles, 1));
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Deep work") == 0);
+    CHECK(pomodoro_profiles_select(profiles, 4));
+    while(pomodoro_profiles_count(profiles) < POMODORO_PROFILES_CAPACITY) {
+        CHECK(pomodoro_profiles_create(profiles, "More", &pomodoro) != POMODORO_PROFILES_NONE);
+    }
+    CHECK_EQUAL(pomodoro_profiles_create(profiles, "Full", &pomodoro), POMODORO_PROFILES_NONE);
+    CHECK_EQUAL(pomodoro_profiles_index(profiles), POMODORO_PROFILES_CAPACITY - 1);
+
+    //with the writer a switch is taken from memory right away, nothing is read and only the header is written
+    pomodoro_file_start();
+    host_storage_reset();
+    CHECK(pomodoro_profiles_select(profiles, 3));
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Sprint") == 0);
+    CHECK(pomodoro_profiles_rename(profiles, "Run"));
+    CHECK(pomodoro_file_stop(UINT32_MAX));
+    CHECK_EQUAL(host_storage_stats().read_bytes, 0);
+    CHECK_EQUAL(host_storage_stats().write_bytes, sizeof(PomodoroProfilesHeader) + sizeof(PomodoroProfile));
+    pomodoro_profiles_free(profiles);
+
+    profiles = pomodoro_profiles_alloc(NULL);
+    CHECK_EQUAL(pomodoro_profiles_index(profiles), 3);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Run") == 0);
+    pomodoro_profiles_free(profiles);
+}
+
+static void test_profiles_adopt(void) {
+    const PomodoroProfilesHeader broken = {0};
+
+    //a new file starts on the built-in profile with the times of the config
+    Pomodoro settings = {.durations = {[workTime] = 50, [shortBreakTime] = 10, [longBreakTime] = 30}, .cycle = 3};
+    CHECK(host_file_write(POMODORO_PROFILES_PATH, &broken, sizeof(broken)));
+    PomodoroProfiles* profiles = pomodoro_profiles_alloc(&settings);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 4);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Study") == 0);
+    pomodoro_profiles_free(profiles);
+
+    //times of a config from before the profiles are kept, also over a reopen
+    settings.durations[workTime] = 40;
+    settings.durations[shortBreakTime] = 10;
+    settings.durations[longBreakTime] = 20;
+    CHECK(host_file_write(POMODORO_PROFILES_PATH, &broken, sizeof(broken)));
+    profiles = pomodoro_profiles_alloc(&settings);
+    pomodoro_profiles_free(profiles);
+    profiles = pomodoro_profiles_alloc(NULL);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 5);
+    const PomodoroProfile* current = pomodoro_profiles_current(profiles);
+    CHECK(strcmp(current->name, POMODORO_PROFILES_SAVED) == 0);
+    CHECK_EQUAL(current->durations[workTime], 40);
+    CHECK_EQUAL(current->durations[longBreakTime], 20);
+    CHECK_EQUAL(current->cycle, 3);
+    pomodoro_profiles_free(profiles);
+
+    //a file of the first version holds the built-in profiles only, the next ones are added behind them
+    static uint8_t file[sizeof(PomodoroProfilesHeader) + 4 * sizeof(PomodoroProfile)];
+    CHECK_EQUAL(host_file_read(POMODORO_PROFILES_PATH, file, sizeof(file)), sizeof(file));
+    PomodoroProfilesHeader* header = (PomodoroProfilesHeader*)file;
+    header->count = 4;
+    header->current = 3;
+    CHECK(host_file_write(POMODORO_PROFILES_PATH, file, sizeof(file)));
+    profiles = pomodoro_profiles_alloc(&settings);
+    CHECK_EQUAL(pomodoro_profiles_count(profiles), 4);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Sprint") == 0);
+    CHECK_EQUAL(pomodoro_profiles_create(profiles, "Reading", &settings), 4);
+    pomodoro_profiles_free(profiles);
+    profiles = pomodoro_profiles_alloc(NULL);
+    CHECK(strcmp(pomodoro_profiles_current(profiles)->name, "Reading") == 0);
+    CHECK(pomodoro_profiles_select(profiles, 0));
+    pomodoro_profiles_free(profiles);
+}
+
+int main(void) {
+    host_setup();
+    test_fresh();
+    test_history();
+    test_stats();
+    test_profiles();
+    test_profiles_adopt();
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------
+// test_timers.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Heap of the named timers against a plain list under random adds, cancels and expiries, and
+//                   the timers file: each change writes one record and the timers keep their ids on a reopen, also
+//                   when a burst of changes is written by the writer.
+//-------------------------------------------------------------------
+
+#include "check.h"
+#include "../../Pomodoro/helpers/pomodoro_timers.h"
+
+//deadline of each id in the reference, 0 if the id is unused
+static uint32_t reference[POMODORO_TIMERS_CAPACITY];
+
+/**
+ * @return id of the earliest timer of the reference, POMODORO_TIMERS_NONE if there is none
+ */
+static uint16_t test_timers_earliest(void) {
+    uint16_t earliest = POMODORO_TIMERS_NONE;
+    for(uint16_t id = 0; id < POMODORO_TIMERS_CAPACITY; id++) {
+        if(reference[id] && (earliest == POMODORO_TIMERS_NONE || reference[id] < reference[earliest])) {
+            earliest = id;
+        }
+    }
+    return earliest;
+}
+
+static void test_heap(void) {
+    PomodoroTimers* timers = pomodoro_timers_alloc(false);
+    uint16_t count = 0;
+    uint32_t now = 1000;
+    srand(1);
+    for(uint32_t step = 0; step < 20000; step++) {
+        const int action = rand() % 8;
+        if(action < 4) {
+            //deadlines repeat, so timers with the same deadline are covered
+            const uint32_t deadline = now + 1 + rand() % 500;
+            const uint16_t id = pomodoro_timers_add(timers, "t", deadline);
+            if(count == POMODORO_TIMERS_CAPACITY) {
+                CHECK_EQUAL(id, POMODORO_TIMERS_NONE);
+                continue;
+            }
+            CHECK(id < POMODORO_TIMERS_CAPACITY);
+            CHECK_EQUAL(reference[id], 0);
+            reference[id] = deadline;
+            count++;
+        } else if(action < 6) {
+            const uint16_t id = rand() % POMODORO_TIMERS_CAPACITY;
+            CHECK_EQUAL(pomodoro_timers_cancel(timers, id), reference[id] != 0);
+            if(reference[id]) count--;
+            reference[id] = 0;
+        } else {
+            now += rand() % 50;
+            PomodoroTimer expired;
+            uint32_t last = 0;
+            //of timers with the same deadline any may be up first
+            uint16_t id = pomodoro_timers_next(timers);
+            while(pomodoro_timers_expire(timers, now, &expired)) {
+                //expired in the order of their deadlines
+                CHECK(expired.deadline <= now);
+                CHECK(expired.deadline >= last);
+                last = expired.deadline;
+                CHECK_EQUAL(reference[test_timers_earliest()], expired.deadline);
+                CHECK_EQUAL(reference[id], expired.deadline);
+                reference[id] = 0;
+                count--;
+                id = pomodoro_timers_next(timers);
+            }
+        }
+        CHECK_EQUAL(pomodoro_timers_count(timers), count);
+        const uint16_t next = pomodoro_timers_next(timers);
+        const uint16_t earliest = test_timers_earliest();
+        if(earliest == POMODORO_TIMERS_NONE) {
+            CHECK_EQUAL(next, POMODORO_TIMERS_NONE);
+        } else {
+            CHECK_EQUAL(pomodoro_timers_get(timers, next)->deadline, reference[earliest]);
+        }
+    }
+    pomodoro_timers_free(timers);
+}
+
+static void test_file(void) {
+    static uint8_t data[sizeof(PomodoroTimersHeader) + POMODORO_TIMERS_CAPACITY * sizeof(PomodoroTimer) + 1];
+    PomodoroTimers* timers = pomodoro_timers_alloc(true);
+    CHECK_EQUAL(host_file_read(POMODORO_TIMERS_PATH, data, sizeof(data)), -1);
+    //the first change creates the file at its full size
+    const uint16_t tea = pomodoro_timers_add(timers, "Tea", 2000);
+    CHECK_EQUAL(host_file_read(POMODORO_TIMERS_PATH, data, sizeof(data)), sizeof(data) - 1);
+
+    //each change writes the record of its id and nothing else
+    host_storage_reset();
+    const uint16_t call = pomodoro_timers_add(timers, "Call", 1000);
+    const uint16_t walk = pomodoro_timers_add(timers, "Walk", 3000);
+    CHECK(pomodoro_timers_cancel(timers, call));
+    CHECK_EQUAL(host_storage_stats().write_bytes, 3 * sizeof(PomodoroTimer));
+    pomodoro_timers_free(timers);
+
+    timers = pomodoro_timers_alloc(true);
+    CHECK_EQUAL(pomodoro_timers_count(timers), 2);
+    CHECK_EQUAL(pomodoro_timers_next(timers), tea);
+    CHECK(strcmp(pomodoro_timers_get(timers, walk)->name, "Walk") == 0);
+    //the freed id is handed out again
+    CHECK_EQUAL(pomodoro_timers_add(timers, "Call", 1500), call);
+    CHECK_EQUAL(pomodoro_timers_next(timers), call);
+    pomodoro_timers_free(timers);
+
+    //with the writer the changes are written behind the back of the caller, all of them are in the file once it
+    //has stopped
+    pomodoro_file_start();
+    timers = pomodoro_timers_alloc(true);
+    host_storage_reset();
+    for(uint16_t i = 0; i < 100; i++) {
+        CHECK(pomodoro_timers_cancel(timers, pomodoro_timers_add(timers, "Burst", 5000 + i)));
+    }
+    const uint16_t late = pomodoro_timers_add(timers, "Late", 4000);
+    CHECK(pomodoro_file_stop(UINT32_MAX));
+    //a record changed again before the writer took it is written once
+    CHECK(host_storage_stats().write_bytes <= 201 * sizeof(PomodoroTimer));
+    pomodoro_timers_free(timers);
+
+    timers = pomodoro_timers_alloc(true);
+    CHECK_EQUAL(pomodoro_timers_count(timers), 4);
+    CHECK(strcmp(pomodoro_timers_get(timers, late)->name, "Late") == 0);
+    pomodoro_timers_free(timers);
+
+    const uint32_t broken = 0;
+    CHECK(host_file_write(POMODORO_TIMERS_PATH, &broken, sizeof(broken)));
+    timers = pomodoro_timers_alloc(true);
+    CHECK_EQUAL(pomodoro_timers_count(timers), 0);
+    pomodoro_timers_free(timers);
+}
+
+int main(void) {
+    host_setup();
+    test_heap();
+    test_file();
+    host_teardown();
+    return 0;
+}
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------
+// test_trace.c
+//
+// Author:           JuanJakobo
+// Date:             17.10.26
+// Description:      Records a session of an app built with APP_TRACE, replays the recording and checks that
+//                   the replay handles as many events and ends in the same state. Built once per app,
+//                   TEST_CIRCLE selects the circle app.
+//-------------------------------------------------------------------
+
+#include "check.h"
+
+#ifdef TEST_CIRCLE
+#define TEST_APP "Circle"
+#define TEST_TRACE "/ext/apps/misc/Circle.trace"
+#define TEST_REPLAY "/ext/apps/misc/Circle.replay"
+int32_t circle_app(void* p);
+
+/**
+ * Moves and resizes the circle, then lets 10 and 100 bouncing circles run for a while
+ */
+static void test_trace_session(void) {
+    host_app_start("circle", 1024, circle_app);
+    CHECK(host_wait_text("Rad: 5"));
+    host_press(InputKeyRight);
+    host_hold(InputKeyDown, 4);
+    host_press(InputKeyLeft);
+    CHECK(host_idle());
+    host_press(InputKeyOk);
+    host_press(InputKeyOk);
+    host_press(InputKeyOk);
+    host_run(700);
+    host_press(InputKeyOk);
+    host_run(300);
+    host_press(InputKeyBack);
+}
+
+/**
+ * Starts the app that replays the session right away
+ */
+static void test_trace_replay(void) {
+    host_app_start("circle", 1024, circle_app);
+}
+#else
+#define TEST_APP "Pomodoro"
+#define TEST_TRACE "/ext/apps/misc/Pomodoro.trace"
+#define TEST_REPLAY "/ext/apps/misc/Pomodoro.replay"
+int32_t pomodoro_app(void* p);
+
+/**
+ * Changes the work time, starts the run and lets it go through the first interval into the break
+ */
+static void test_trace_session(void) {
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+    CHECK(host_wait_text("OK to start"));
+    CHECK(host_idle());
+    host_press(InputKeyDown);
+    host_press(InputKeyDown);
+    host_hold(InputKeyUp, 3);
+    CHECK(host_idle());
+    host_press(InputKeyOk);
+    host_run(30 * 60 * 1000);
+    host_hold(InputKeyBack, 0);
+}
+
+/**
+ * Starts the app that replays the session right away
+ */
+static void test_trace_replay(void) {
+    host_app_start("pomodoro", 2 * 1024, pomodoro_app);
+}
+#endif
+
+static uint8_t trace[64 * 1024];
+
+int main(void) {
+    host_setup();
+    //TEST_LOG=1 prints the log of the app
+    host_log_enable(getenv("TEST_LOG") != NULL);
+    host_time_scale(0);
+    test_trace_session();
+    CHECK_EQUAL(host_app_join(), 0);
+    char recorded[64];
+    CHECK(host_log_after(TEST_APP "] recorded ", recorded, sizeof(recorded)));
+
+    const long size = host_file_read(TEST_TRACE, trace, sizeof(trace));
+    CHECK(size > 0 && size < (long)sizeof(trace));
+    CHECK(host_file_write(TEST_REPLAY, trace, size));
+
+    test_trace_replay();
+    CHECK_EQUAL(host_app_join(), 0);
+    char replayed[64];
+    CHECK(host_log_after(TEST_APP "] replayed ", replayed, sizeof(replayed)));
+    if(strcmp(recorded, replayed) != 0) {
+        fprintf(stderr, "recorded %s\nreplayed %s\n", recorded, replayed);
+        CHECK(false);
+    }
+    host_teardown();
+    return 0;
+}